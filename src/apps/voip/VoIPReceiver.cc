@@ -13,17 +13,6 @@ Define_Module(VoIPReceiver);
 
 VoIPReceiver::~VoIPReceiver()
 {
-    while (!mPlayoutQueue_.empty())
-    {
-        delete mPlayoutQueue_.front();
-        mPlayoutQueue_.pop_front();
-    }
-
-    while (!mPacketsList_.empty())
-    {
-        delete mPacketsList_.front();
-        mPacketsList_.pop_front();
-    }
 }
 
 void VoIPReceiver::initialize(int stage)
@@ -41,6 +30,7 @@ void VoIPReceiver::initialize(int stage)
     mPlayoutDelay_ = par("playout_delay");
 
     mInit_ = true;
+    mReceivedFrames_ = 0;
 
     int port = par("localPort");
     EV << "VoIPReceiver::initialize - binding to port: local:" << port << endl;
@@ -75,12 +65,14 @@ void VoIPReceiver::handleMessage(cMessage *msg)
     {
         mCurrentTalkspurt_ = pPacket->getIDtalk();
         mInit_ = false;
+        startTalkspurt(pPacket);
     }
 
     if (mCurrentTalkspurt_ != pPacket->getIDtalk())
     {
         playout(false);
         mCurrentTalkspurt_ = pPacket->getIDtalk();
+        startTalkspurt(pPacket);
     }
 
     //emit(mFrameLossSignal,1.0);
@@ -90,113 +82,103 @@ void VoIPReceiver::handleMessage(cMessage *msg)
     emit(voipReceivedThroughtput_, (int)pPacket->getByteLength() );
 
     pPacket->setArrivalTime(simTime());
-    mPacketsList_.push_back(pPacket);
+    playoutFrame(pPacket);
 }
 
-void VoIPReceiver::playout(bool finish)
+void VoIPReceiver::startTalkspurt(VoipPacket* pPacket)
 {
-    if (mPacketsList_.empty())
-        return;
+    mFirstPlayoutTime_ = simTime() + mPlayoutDelay_;
+    mTalkspurtFrames_ = pPacket->getNframes();
+    mReceivedFrames_ = 0;
+    mMaxFrameId_ = 0;
+    mPlayoutLoss_ = 0;
+    mTailDropLoss_ = 0;
+    mMaxJitter_ = -1000.0;
 
-    double sample;
+    //Vector for managing duplicates
+    mArrived_.assign(mTalkspurtFrames_, false);
+}
 
-    VoipPacket* pPacket = mPacketsList_.front();
+void VoIPReceiver::playoutFrame(VoipPacket* pPacket)
+{
+    ++mReceivedFrames_;
+    mMaxFrameId_ = std::max(mMaxFrameId_, pPacket->getIDframe());
 
-    simtime_t firstPlayoutTime = pPacket->getArrivalTime() + mPlayoutDelay_;
-    unsigned int firstFrameId = pPacket->getIDframe();
-    unsigned int n_frames = pPacket->getNframes();
-    unsigned int playoutLoss = 0;
-    unsigned int tailDropLoss = 0;
-    unsigned int channelLoss;
+    double sample = SIMTIME_DBL(pPacket->getArrivalTime() - pPacket->getTimestamp());
+    emit(voIPFrameDelaySignal_, sample);
 
-    if (finish)
-    {
-        PacketsList::iterator it;
-        unsigned int maxId = 0;
-        for (it = mPacketsList_.begin(); it != mPacketsList_.end(); it++)
-            maxId = std::max(maxId, (*it)->getIDframe());
-        channelLoss = maxId + 1 - mPacketsList_.size();
-    }
+    unsigned int IDframe = pPacket->getIDframe();
 
-    else
-        channelLoss = pPacket->getNframes() - mPacketsList_.size();
+    pPacket->setPlayoutTime(mFirstPlayoutTime_ + IDframe * mSamplingDelta_);
 
-    sample = ((double) channelLoss / (double) n_frames);
-    emit(voIPFrameLossSignal_, sample);
+    simtime_t last_jitter = pPacket->getArrivalTime() - pPacket->getPlayoutTime();
+    mMaxJitter_ = std::max(mMaxJitter_, last_jitter);
 
-    //Vector for managing duplicates
-    bool* isArrived = new bool[pPacket->getNframes()];
-    for (unsigned int y = 0; y < pPacket->getNframes(); y++)
+    EV << "VoIPReceiver::playoutFrame - Jitter measured: " << last_jitter << " TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
+
+    //Duplicates management
+    if (mArrived_[pPacket->getIDframe()])
     {
-        isArrived[y] = false;
+        EV << "VoIPReceiver::playoutFrame - Duplicated Packet: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
     }
-
-    simtime_t last_jitter = 0.0;
-    simtime_t max_jitter = -1000.0;
-
-    while (!mPacketsList_.empty() /*&& pPacket->getIDtalk() == mCurrentTalkspurt*/)
+    else if( last_jitter > 0.0 )
     {
-        pPacket = mPacketsList_.front();
-
-        sample = SIMTIME_DBL(pPacket->getArrivalTime() - pPacket->getTimestamp());
-        emit(voIPFrameDelaySignal_, sample);
-
-        unsigned int IDframe = pPacket->getIDframe();
-
-        pPacket->setPlayoutTime(firstPlayoutTime + IDframe * mSamplingDelta_);
-        //pPacket->setPlayoutTime(firstPlayoutTime + (pPacket->getIDframe() - firstFrameId) * mSamplingDelta_);
+        ++mPlayoutLoss_;
 
-        last_jitter = pPacket->getArrivalTime() - pPacket->getPlayoutTime();
-        max_jitter = std::max(max_jitter, last_jitter);
-
-        EV << "VoIPReceiver::playout - Jitter measured: " << last_jitter << " TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
-
-        //Duplicates management
-        if (isArrived[pPacket->getIDframe()])
+        EV << "VoIPReceiver::playoutFrame - out of time packet deleted: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
+        emit(voIPJitterSignal_, last_jitter);
+    }
+    else
+    {
+        // frames already played out leave the buffer
+        while( !mPlayoutQueue_.empty() && pPacket->getArrivalTime() > mPlayoutQueue_.front() )
         {
-            EV << "VoIPReceiver::playout - Duplicated Packet: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
-            delete pPacket;
+            ++mBufferSpace_;
+            mPlayoutQueue_.pop_front();
         }
-        else if( last_jitter > 0.0 )
+
+        if(mBufferSpace_ > 0)
         {
-            ++playoutLoss;
+            EV << "VoIPReceiver::playoutFrame - Sampleable packet inserted into buffer: TALK["<< pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe()
+               << "] - arrival time[" << pPacket->getArrivalTime() << "] -  sampling time[" << pPacket->getPlayoutTime() << "]\n";
+            --mBufferSpace_;
 
-            EV << "VoIPReceiver::playout - out of time packet deleted: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
-            emit(voIPJitterSignal_, last_jitter);
-            delete pPacket;
+            //duplicates management
+            mArrived_[pPacket->getIDframe()] = true;
+
+            mPlayoutQueue_.push_back(pPacket->getPlayoutTime());
         }
         else
         {
-            while( !mPlayoutQueue_.empty() && pPacket->getArrivalTime() > mPlayoutQueue_.front()->getPlayoutTime() )
-            {
-                ++mBufferSpace_;
-                delete mPlayoutQueue_.front();
-                mPlayoutQueue_.pop_front();
-            }
-
-            if(mBufferSpace_ > 0)
-            {
-                EV << "VoIPReceiver::playout - Sampleable packet inserted into buffer: TALK["<< pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe()
-                   << "] - arrival time[" << pPacket->getArrivalTime() << "] -  sampling time[" << pPacket->getPlayoutTime() << "]\n";
-                --mBufferSpace_;
-
-                //duplicates management
-                isArrived[pPacket->getIDframe()] = true;
-
-                mPlayoutQueue_.push_back(pPacket);
-            }
-            else
-            {
-                ++tailDropLoss;
-                EV << "VoIPReceiver::playout - Buffer is full, discarding packet: TALK[" << pPacket->getIDtalk() << "] - FRAME["
-                   << pPacket->getIDframe() << "] - arrival time[" << pPacket->getArrivalTime() << "]\n";
-                delete pPacket;
-            }
+            ++mTailDropLoss_;
+            EV << "VoIPReceiver::playoutFrame - Buffer is full, discarding packet: TALK[" << pPacket->getIDtalk() << "] - FRAME["
+               << pPacket->getIDframe() << "] - arrival time[" << pPacket->getArrivalTime() << "]\n";
         }
-
-        mPacketsList_.pop_front();
     }
 
+    delete pPacket;
+}
+
+void VoIPReceiver::playout(bool finish)
+{
+    if (mReceivedFrames_ == 0)
+        return;
+
+    double sample;
+
+    unsigned int n_frames = mTalkspurtFrames_;
+    unsigned int playoutLoss = mPlayoutLoss_;
+    unsigned int tailDropLoss = mTailDropLoss_;
+    unsigned int channelLoss;
+
+    if (finish)
+        channelLoss = mMaxFrameId_ + 1 - mReceivedFrames_;
+    else
+        channelLoss = n_frames - mReceivedFrames_;
+
+    sample = ((double) channelLoss / (double) n_frames);
+    emit(voIPFrameLossSignal_, sample);
+
     double proportionalLoss = ((double) tailDropLoss + (double) playoutLoss + (double) channelLoss) / (double) n_frames;
     EV << "VoIPReceiver::playout - proportionalLoss " << proportionalLoss << "(tailDropLoss=" << tailDropLoss << " - playoutLoss="
        <<  playoutLoss << " - channelLoss=" << channelLoss << ")\n\n";
@@ -219,14 +201,14 @@ void VoIPReceiver::playout(bool finish)
        << channelLoss << " ) = " << mos << "\n";
 
     EV << "VoIPReceiver::playout - Playout Delay Adaptation \n" << "\t Old Playout Delay: " << mPlayoutDelay_ << "\n\t Max Jitter Measured: "
-       << max_jitter << "\n\n";
+       << mMaxJitter_ << "\n\n";
 
-    mPlayoutDelay_ += max_jitter;
+    mPlayoutDelay_ += mMaxJitter_;
     if (mPlayoutDelay_ < 0.0)
         mPlayoutDelay_ = 0.0;
     EV << "\t New Playout Delay: " << mPlayoutDelay_ << "\n\n";
 
-    delete[] isArrived;
+    mReceivedFrames_ = 0;
 }
 
 double VoIPReceiver::eModel(simtime_t delay, double loss)
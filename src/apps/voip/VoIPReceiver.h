@@ -16,7 +16,8 @@
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include "inet/transportlayer/contract/udp/UDPSocket.h"
 #include "apps/voip/VoipPacket_m.h"
-#include <list>
+#include <deque>
+#include <vector>
 
 class VoIPReceiver : public cSimpleModule
 {
@@ -29,9 +30,8 @@ class VoIPReceiver : public cSimpleModule
     int emodel_A_;
     double emodel_Ro_;
 
-    typedef std::list<VoipPacket*> PacketsList;
-    PacketsList mPacketsList_;
-    PacketsList mPlayoutQueue_;
+    // playout times of the frames in the playout buffer
+    std::deque<simtime_t> mPlayoutQueue_;
     unsigned int mCurrentTalkspurt_;
     unsigned int mBufferSpace_;
     simtime_t mSamplingDelta_;
@@ -39,6 +39,17 @@ class VoIPReceiver : public cSimpleModule
 
     bool mInit_;
 
+    // state of the current talkspurt, updated as its frames arrive
+    simtime_t mFirstPlayoutTime_;
+    unsigned int mTalkspurtFrames_;
+    unsigned int mReceivedFrames_;
+    unsigned int mMaxFrameId_;
+    unsigned int mPlayoutLoss_;
+    unsigned int mTailDropLoss_;
+    simtime_t mMaxJitter_;
+    // frames of the talkspurt already in the playout buffer, for managing duplicates
+    std::vector<bool> mArrived_;
+
     simsignal_t voIPFrameLossSignal_;
     simsignal_t voIPFrameDelaySignal_;
     simsignal_t voIPPlayoutDelaySignal_;
@@ -56,6 +67,12 @@ class VoIPReceiver : public cSimpleModule
     void initialize(int stage);
     void handleMessage(cMessage *msg);
     double eModel(simtime_t delay, double loss);
+
+    // reset the talkspurt state at the arrival of its first frame
+    void startTalkspurt(VoipPacket* pPacket);
+    // evaluate the playout of a frame as soon as it arrives, and delete it
+    void playoutFrame(VoipPacket* pPacket);
+    // compute the statistics of the talkspurt and adapt the playout delay
     void playout(bool finish);
 };
 
@@ -7,6 +7,7 @@
 // and cannot be removed from it.
 //
 
+#include <cstring>
 #include "common/LteCommon.h"
 #include "corenetwork/binder/LteBinder.h"
 #include "corenetwork/deployer/LteDeployer.h"
@@ -665,6 +666,93 @@ double dBToLinear(double db)
     return pow(10, (db) / 10);
 }
 
+// log2(10) / 10
+static const double LOG2_10_OVER_10 = 0.33219280948873623479;
+// 10 * log10(2)
+static const double TEN_LOG10_2 = 3.01029995663981195214;
+
+// 2^y, with 2^(y-n) for the nearest integer n computed by its Taylor series
+static inline double fastExp2(double y)
+{
+    if (y < -1020.0)
+        y = -1020.0;
+    if (y > 1020.0)
+        y = 1020.0;
+
+    int64_t n = (int64_t) (y + 1024.5) - 1024;
+    double x = (y - n) * M_LN2; // |x| <= ln(2)/2
+    double p = 1.0 + x * (1.0 + x * (1.0 / 2 + x * (1.0 / 6 + x * (1.0 / 24 + x * (1.0 / 120
+        + x * (1.0 / 720 + x * (1.0 / 5040 + x * (1.0 / 40320))))))));
+
+    // 2^n, built from the exponent bits
+    int64_t bits = (n + 1023) << 52;
+    double scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// log2(v) for v > 0, as exponent + log2(mantissa) with the atanh series of the logarithm
+static inline double fastLog2(double v)
+{
+    int64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    int64_t e = ((bits >> 52) & 0x7FF) - 1023;
+    bits = (bits & 0x000FFFFFFFFFFFFFLL) | 0x3FF0000000000000LL;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+
+    // mantissa in [sqrt(1/2), sqrt(2))
+    if (m > M_SQRT2)
+    {
+        m *= 0.5;
+        e++;
+    }
+    double s = (m - 1) / (m + 1);
+    double s2 = s * s;
+    double ln = 2 * s * (1 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9 + s2 * (1.0 / 11))))));
+    return e + ln / M_LN2;
+}
+
+void dBmToLinear(const double* in, double* out, unsigned int n, LteConversionMode mode)
+{
+    if (mode == CONVERSION_FAST)
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = fastExp2((in[i] - 30) * LOG2_10_OVER_10);
+    else
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = pow(10, (in[i] - 30) / 10);
+}
+
+void dBToLinear(const double* in, double* out, unsigned int n, LteConversionMode mode)
+{
+    if (mode == CONVERSION_FAST)
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = fastExp2(in[i] * LOG2_10_OVER_10);
+    else
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = pow(10, (in[i]) / 10);
+}
+
+void linearToDBm(const double* in, double* out, unsigned int n, LteConversionMode mode)
+{
+    if (mode == CONVERSION_FAST)
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = TEN_LOG10_2 * fastLog2(in[i]) + 30;
+    else
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = 10 * log10(1000 * in[i]);
+}
+
+void linearToDb(const double* in, double* out, unsigned int n, LteConversionMode mode)
+{
+    if (mode == CONVERSION_FAST)
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = TEN_LOG10_2 * fastLog2(in[i]);
+    else
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = 10 * log10(in[i]);
+}
+
 void initializeAllChannels(cModule *mod)
 {
     for (cModule::GateIterator i(mod); !i.end(); i++)
@@ -396,6 +396,27 @@ double dBToLinear(double db);
 double linearToDBm(double lin);
 double linearToDb(double lin);
 
+/// Accuracy of the array conversions between dB and linear values
+enum LteConversionMode
+{
+    /// same results as the scalar conversions
+    CONVERSION_ACCURATE,
+    /// polynomial exp2/log2 approximations, with relative error below 1e-9 on
+    /// linear values and absolute error below 1e-9 dB (positive linear values only)
+    CONVERSION_FAST
+};
+
+/*
+ * Array conversions: out[i] = conversion(in[i]) for 0 <= i < n.
+ * in and out may be the same array. The loops carry no dependency, so that
+ * the compiler can vectorise them (in the fast mode, the accurate one calls
+ * pow() and log10() for each element).
+ */
+void dBmToLinear(const double* in, double* out, unsigned int n, LteConversionMode mode = CONVERSION_ACCURATE);
+void dBToLinear(const double* in, double* out, unsigned int n, LteConversionMode mode = CONVERSION_ACCURATE);
+void linearToDBm(const double* in, double* out, unsigned int n, LteConversionMode mode = CONVERSION_ACCURATE);
+void linearToDb(const double* in, double* out, unsigned int n, LteConversionMode mode = CONVERSION_ACCURATE);
+
 /*************************
  *      DAS Support      *
  *************************/
@@ -756,6 +777,49 @@ typedef std::list<Codeword> CwList;
 /// Pair of acid, list of unit ids
 typedef std::pair<unsigned char, CwList> UnitList;
 
+/*****************
+ * Self messages
+ *****************/
+
+/**
+ * Kinds of the recurring self messages of the stack modules.
+ * Modules dispatch their self messages on these kinds instead of comparing names.
+ */
+enum LteSelfMessageKind
+{
+    /// any self message which is not dispatched by kind
+    UNKNOWN_SELF_MSG = 0,
+    /// MAC main loop
+    TTI_TICK,
+    /// MAC flush of the Tx H-ARQ buffers, after the main loop
+    FLUSH_HARQ,
+    /// Mode 4 sensing window update, at the beginning of the TTI
+    UPDATE_SUBFRAME,
+    /// decoding of the airframes received in the TTI, at its end
+    D2D_DECODING_TIMER,
+    /// TTI driver: event running the timers triggered for the current TTI
+    TTI_TRIGGER,
+    /// parallel reception: channel measurement of the airframes received in the TTI
+    CHANNEL_MEASUREMENT
+};
+
+/**
+ * Phases of a TTI, in execution order.
+ * The value of each phase is the scheduling priority of its events, so that the
+ * phases interleave with the other events of the TTI as the per-node self messages do.
+ */
+enum LteTtiPhase
+{
+    /// PHY state update at the beginning of the TTI (Mode 4 sensing window, CBR)
+    TTI_PHASE_SUBFRAME = 0,
+    /// MAC main loop (scheduling and transmission), then flush of the H-ARQ buffers
+    TTI_PHASE_MAC = 1,
+    /// channel measurement of the airframes received in the TTI, for all the receivers (parallel reception)
+    TTI_PHASE_MEASUREMENT = 9,
+    /// decoding of the airframes received in the TTI
+    TTI_PHASE_DECODING = 10
+};
+
 /*********************
  * Incell Interference Support
  *********************/
@@ -793,6 +857,8 @@ struct UeInfo
 };
 
 typedef std::vector<ExtCell*> ExtCellList;
+// D2D peers of each transmitting UE
+typedef std::map<MacNodeId, std::set<MacNodeId> > D2DPairMap;
 
 /*****************
  *  PHY Support  *
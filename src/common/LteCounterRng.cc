@@ -0,0 +1,73 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "common/LteCounterRng.h"
+
+// Philox4x32 constants (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11)
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+static const int PHILOX_ROUNDS = 10;
+
+void LteCounterRng::block(const LteRandomKey& key, uint32_t out[4]) const
+{
+    // counter: link, band/purpose/index and TTI
+    uint32_t c0 = ((uint32_t) key.src << 16) | key.dst;
+    uint32_t c1 = ((uint32_t) key.purpose << 24) | ((key.band & 0xFFF) << 12) | (key.index & 0xFFF);
+    uint32_t c2 = (uint32_t) key.tti;
+    uint32_t c3 = (uint32_t) (key.tti >> 32);
+
+    uint32_t k0 = seed_;
+    uint32_t k1 = 0;
+
+    for (int r = 0; r < PHILOX_ROUNDS; r++)
+    {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+        uint32_t hi0 = (uint32_t) (p0 >> 32), lo0 = (uint32_t) p0;
+        uint32_t hi1 = (uint32_t) (p1 >> 32), lo1 = (uint32_t) p1;
+
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+double LteCounterRng::uniform(const LteRandomKey& key) const
+{
+    uint32_t out[4];
+    block(key, out);
+    return toDouble(out[0], out[1]);
+}
+
+double LteCounterRng::normal(const LteRandomKey& key, double mean, double stddev) const
+{
+    uint32_t out[4];
+    block(key, out);
+
+    // u1 in (0,1] to keep the logarithm finite
+    double u1 = 1.0 - toDouble(out[0], out[1]);
+    double u2 = toDouble(out[2], out[3]);
+    return mean + stddev * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+double LteCounterRng::exponential(const LteRandomKey& key, double mean) const
+{
+    return -mean * log(1.0 - uniform(key));
+}
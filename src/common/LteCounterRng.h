@@ -0,0 +1,109 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTECOUNTERRNG_H_
+#define _LTE_LTECOUNTERRNG_H_
+
+#include "common/LteCommon.h"
+#include <stdint.h>
+
+/// What a random number drawn from a LteCounterRng is used for
+enum LteRandomPurpose
+{
+    RANDOM_SHADOWING,
+    RANDOM_LOS,
+    RANDOM_FADING,
+    RANDOM_FADING_ANGLE,
+    RANDOM_FADING_DELAY,
+    RANDOM_WINNER,
+    RANDOM_ERROR,
+    RANDOM_SCHEDULING_JITTER,
+    RANDOM_EXTCELL_ALLOCATION
+};
+
+/**
+ * Key of a random number: the same key always gives the same number.
+ */
+struct LteRandomKey
+{
+    /// link endpoints (0 if the quantity does not depend on one of them)
+    MacNodeId src;
+    MacNodeId dst;
+    /// logical band
+    unsigned int band;
+    /// TTI the number refers to
+    uint64_t tti;
+    LteRandomPurpose purpose;
+    /// distinguishes several numbers with the same key (e.g. fading paths), < 4096
+    unsigned int index;
+
+    LteRandomKey(MacNodeId src, MacNodeId dst, unsigned int band, uint64_t tti, LteRandomPurpose purpose,
+        unsigned int index = 0)
+    {
+        this->src = src;
+        this->dst = dst;
+        this->band = band;
+        this->tti = tti;
+        this->purpose = purpose;
+        this->index = index;
+    }
+};
+
+/**
+ * Counter-based random number generator (Philox4x32-10).
+ *
+ * Unlike the stream RNGs of the simulation, a number is a pure function of its
+ * key (link, band, TTI, purpose) and of the seed: it does not depend on how many
+ * numbers have been drawn before, nor on the order of the events. Any channel or
+ * scheduling quantity can thus be recomputed, cached, or computed out of order
+ * (e.g. in parallel) with the same value.
+ */
+class LteCounterRng
+{
+    uint32_t seed_;
+
+  public:
+    LteCounterRng(uint32_t seed)
+    {
+        seed_ = seed;
+    }
+
+    //! Index of the current TTI
+    static uint64_t currentTti()
+    {
+        return (uint64_t) floor(NOW.dbl() / TTI + 0.5);
+    }
+
+    //! Uniform number in [0,1)
+    double uniform(const LteRandomKey& key) const;
+
+    //! Uniform number in [a,b)
+    double uniform(const LteRandomKey& key, double a, double b) const
+    {
+        return a + (b - a) * uniform(key);
+    }
+
+    //! Normal number (Box-Muller)
+    double normal(const LteRandomKey& key, double mean, double stddev) const;
+
+    //! Exponential number
+    double exponential(const LteRandomKey& key, double mean) const;
+
+  protected:
+    //! Philox4x32-10 block: four random words for the counter of the key
+    void block(const LteRandomKey& key, uint32_t out[4]) const;
+
+    //! Number in [0,1) with 53 random bits out of two words
+    static double toDouble(uint32_t hi, uint32_t lo)
+    {
+        return ((hi >> 5) * 67108864.0 + (lo >> 6)) * (1.0 / 9007199254740992.0);
+    }
+};
+
+#endif
@@ -0,0 +1,43 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTENODELISTENER_H_
+#define _LTE_LTENODELISTENER_H_
+
+#include "common/LteCommon.h"
+
+/*!
+ * Interface of the modules keeping per-node state (buffers, H-ARQ processes,
+ * channel history, ...) about the other nodes of the network.
+ *
+ * Listeners are added to the binder (LteBinder::addNodeListener()), which
+ * notifies them when a node leaves the simulation, e.g. when a vehicle is
+ * removed by the mobility manager, so that they can drop its state at once
+ * instead of checking the binder for departed nodes while running.
+ */
+class LteNodeListener
+{
+  public:
+    virtual ~LteNodeListener()
+    {
+    }
+
+    /*!
+     * Called when a node is unregistered from the binder, before its id can be
+     * assigned to another node. For a UE, only the listeners of the nodes that
+     * may know it are notified (see LteBinder::unregisterNode()), node by node
+     * and, within a node, in the order they have been added. Listeners are
+     * notified also for the node they belong to.
+     *
+     * @param nodeId MacNodeId of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId) = 0;
+};
+
+#endif
@@ -0,0 +1,200 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTESTATISTIC_H_
+#define _LTE_LTESTATISTIC_H_
+
+#include <math.h>
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+/// How values emitted through a LteStatistic are combined before reaching the listeners
+enum LteStatisticAggregation
+{
+    /// every value is emitted as it is produced
+    AGGREGATE_NONE,
+    /// one value per period: the sum of the values produced in the period (counters)
+    AGGREGATE_SUM,
+    /// one value per period: the mean of the values produced in the period (samples)
+    AGGREGATE_MEAN
+};
+
+/**
+ * Gated, optionally aggregated, signal emitter.
+ *
+ * The signal is registered by init(), which also checks once whether anybody
+ * is listening to it (i.e. whether its @statistic is recorded). Emitting on a
+ * disabled statistic is a single branch, and callers can test enabled() to
+ * skip computing the value altogether.
+ *
+ * When an aggregation period is given, values are accumulated in the module
+ * and only one value per period is handed to the listeners. This is meant for
+ * high-rate counters, whose vectors are otherwise dominated by per-event
+ * records. Owners call tick() once per TTI, which emits the value of a period
+ * as soon as it ends, timestamped with the end of the period, and flush() from
+ * finish(), which emits the values of the last (partial) period.
+ */
+class LteStatistic
+{
+    //! Module emitting the signal
+    cComponent* owner_;
+
+    //! Registered signal
+    simsignal_t signal_;
+
+    //! True if the signal had at least one listener at initialization
+    bool enabled_;
+
+    //! Aggregation mode (AGGREGATE_NONE if period_ is zero)
+    LteStatisticAggregation aggregation_;
+
+    //! Aggregation period
+    simtime_t period_;
+
+    //! End of the current aggregation period
+    simtime_t periodEnd_;
+
+    //! Sum of the values produced in the current period
+    double sum_;
+
+    //! Number of values produced in the current period
+    unsigned long count_;
+
+  public:
+    LteStatistic()
+    {
+        owner_ = NULL;
+        signal_ = SIMSIGNAL_NULL;
+        enabled_ = false;
+        aggregation_ = AGGREGATE_NONE;
+        period_ = 0;
+        periodEnd_ = 0;
+        sum_ = 0;
+        count_ = 0;
+    }
+
+    /*!
+     * Register the signal and cache whether it is listened to.
+     * Must be called after the result recorders have been attached, i.e. in
+     * (or after) initialization stage 0.
+     *
+     * @param owner emitting module
+     * @param name signal name, as declared by @signal in the NED file
+     * @param aggregation how values are combined within a period
+     * @param period aggregation period; zero disables aggregation
+     */
+    void init(cComponent* owner, const char* name, LteStatisticAggregation aggregation = AGGREGATE_NONE,
+        simtime_t period = 0)
+    {
+        owner_ = owner;
+        signal_ = cComponent::registerSignal(name);
+        enabled_ = owner->mayHaveListeners(signal_);
+        period_ = (aggregation == AGGREGATE_NONE) ? 0 : period;
+        aggregation_ = (period_ == 0) ? AGGREGATE_NONE : aggregation;
+        periodEnd_ = simTime() + period_;
+        sum_ = 0;
+        count_ = 0;
+    }
+
+    //! Return true if emitted values reach at least one listener
+    bool enabled() const
+    {
+        return enabled_;
+    }
+
+    //! Return the registered signal
+    simsignal_t getSignal() const
+    {
+        return signal_;
+    }
+
+    //! Return true if values are aggregated, i.e. if tick() and flush() must be called
+    bool aggregated() const
+    {
+        return aggregation_ != AGGREGATE_NONE;
+    }
+
+    //! Emit (or accumulate) a value
+    void emit(double value)
+    {
+        if (!enabled_)
+            return;
+
+        if (aggregation_ == AGGREGATE_NONE)
+        {
+            owner_->emit(signal_, value);
+            return;
+        }
+
+        // in case the owner has not ticked since the end of the period
+        if (simTime() >= periodEnd_)
+            tick();
+
+        sum_ += value;
+        ++count_;
+    }
+
+    //! Emit (or accumulate) a time value
+    void emit(simtime_t value)
+    {
+        if (!enabled_)
+            return;
+
+        if (aggregation_ == AGGREGATE_NONE)
+        {
+            owner_->emit(signal_, value);
+            return;
+        }
+
+        emit(value.dbl());
+    }
+
+    //! Emit the value of the current period if it has ended, and start a new one
+    void tick()
+    {
+        simtime_t now = simTime();
+        if (aggregation_ == AGGREGATE_NONE || now < periodEnd_)
+            return;
+
+        emitPeriod(periodEnd_);
+
+        // skip the periods in which nothing was produced
+        periodEnd_ += period_ * (floor((now - periodEnd_) / period_) + 1);
+    }
+
+    //! Emit the values accumulated so far, e.g. at the end of the simulation
+    void flush()
+    {
+        if (aggregation_ == AGGREGATE_NONE)
+            return;
+
+        simtime_t now = simTime();
+        if (now >= periodEnd_)
+            tick();
+        else
+            emitPeriod(now);
+    }
+
+  protected:
+    //! Hand the value of the period to the listeners, with the given timestamp, and reset it
+    void emitPeriod(simtime_t timestamp)
+    {
+        if (count_ > 0)
+        {
+            cTimestampedValue value(timestamp, (aggregation_ == AGGREGATE_SUM) ? sum_ : sum_ / count_);
+            owner_->emit(signal_, &value);
+        }
+
+        sum_ = 0;
+        count_ = 0;
+    }
+};
+
+#endif
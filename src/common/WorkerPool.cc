@@ -0,0 +1,137 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "common/WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned int numThreads)
+{
+    if (numThreads == 0)
+        throw cRuntimeError("WorkerPool::WorkerPool - at least one thread is needed");
+
+    numThreads_ = numThreads;
+    batch_ = 0;
+    busyHelpers_ = 0;
+    stopping_ = false;
+
+    for (unsigned int i = 0; i < numThreads_; i++)
+        queues_.push_back(new TaskQueue());
+    for (unsigned int i = 1; i < numThreads_; i++)
+        threads_.push_back(std::thread(&WorkerPool::helperLoop, this, i));
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    batchStarted_.notify_all();
+
+    for (unsigned int i = 0; i < threads_.size(); i++)
+        threads_[i].join();
+    for (unsigned int i = 0; i < queues_.size(); i++)
+        delete queues_[i];
+}
+
+void WorkerPool::run(const std::vector<WorkerTask*>& tasks)
+{
+    if (tasks.empty())
+        return;
+
+    // the helpers are idle: no need to lock the queues
+    for (unsigned int i = 0; i < tasks.size(); i++)
+        queues_[i % numThreads_]->tasks.push_back(tasks[i]);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        error_.clear();
+        busyHelpers_ = numThreads_ - 1;
+        batch_++;
+    }
+    batchStarted_.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (busyHelpers_ > 0)
+        batchDone_.wait(lock);
+
+    if (!error_.empty())
+        throw cRuntimeError("WorkerPool::run - task failed: %s", error_.c_str());
+}
+
+void WorkerPool::helperLoop(unsigned int id)
+{
+    unsigned long lastBatch = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stopping_ && batch_ == lastBatch)
+                batchStarted_.wait(lock);
+            if (stopping_)
+                return;
+            lastBatch = batch_;
+        }
+
+        work(id);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busyHelpers_ == 0)
+            batchDone_.notify_one();
+    }
+}
+
+void WorkerPool::work(unsigned int id)
+{
+    WorkerTask* task;
+    while ((task = nextTask(id)) != NULL)
+    {
+        try
+        {
+            task->execute();
+        }
+        catch (std::exception& e)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_.empty())
+                error_ = e.what();
+        }
+    }
+}
+
+WorkerTask* WorkerPool::nextTask(unsigned int id)
+{
+    // own queue first, from the back
+    {
+        TaskQueue* own = queues_[id];
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (!own->tasks.empty())
+        {
+            WorkerTask* task = own->tasks.back();
+            own->tasks.pop_back();
+            return task;
+        }
+    }
+
+    // then steal from the front of the others. No task is added during a batch,
+    // so once all the queues are found empty the thread is done
+    for (unsigned int i = 1; i < numThreads_; i++)
+    {
+        TaskQueue* victim = queues_[(id + i) % numThreads_];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->tasks.empty())
+        {
+            WorkerTask* task = victim->tasks.front();
+            victim->tasks.pop_front();
+            return task;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,112 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_WORKERPOOL_H_
+#define _LTE_WORKERPOOL_H_
+
+#include <omnetpp.h>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace omnetpp;
+
+//! Unit of work run by a WorkerPool
+class WorkerTask
+{
+  public:
+    virtual ~WorkerTask()
+    {
+    }
+
+    /*!
+     * Run the task. May be called from any thread of the pool: it must only
+     * touch state owned by the task, and must not schedule or send messages.
+     */
+    virtual void execute() = 0;
+};
+
+/*!
+ * Work-stealing pool of threads running batches of independent tasks.
+ *
+ * run() deals the tasks of a batch round robin to one queue per thread and
+ * returns once all of them have been executed. Each thread consumes its own
+ * queue from the back and, once empty, steals from the front of the others.
+ * The calling thread takes part in the batch as thread 0, so a pool with a
+ * single thread runs the tasks sequentially, without any helper.
+ *
+ * Errors thrown by a task are reported by run() once the batch is over.
+ */
+class WorkerPool
+{
+  public:
+    //! Start numThreads - 1 helper threads
+    WorkerPool(unsigned int numThreads);
+
+    //! Stop and join the helper threads
+    ~WorkerPool();
+
+    unsigned int getNumThreads() const
+    {
+        return numThreads_;
+    }
+
+    /*!
+     * Execute all the tasks and wait for their completion.
+     * Throws cRuntimeError if any of the tasks failed.
+     */
+    void run(const std::vector<WorkerTask*>& tasks);
+
+  protected:
+    //! Tasks dealt to a thread
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<WorkerTask*> tasks;
+    };
+
+    unsigned int numThreads_;
+
+    //! Helper threads (thread 0 is the caller of run())
+    std::vector<std::thread> threads_;
+
+    //! One queue per thread
+    std::vector<TaskQueue*> queues_;
+
+    //! Protects the fields below
+    std::mutex mutex_;
+    std::condition_variable batchStarted_;
+    std::condition_variable batchDone_;
+
+    //! Incremented at each batch, wakes up the helpers
+    unsigned long batch_;
+
+    //! Helpers still working on the current batch
+    unsigned int busyHelpers_;
+
+    //! Set by the destructor
+    bool stopping_;
+
+    //! Message of the first error of the current batch
+    std::string error_;
+
+    //! Body of the helper threads
+    void helperLoop(unsigned int id);
+
+    //! Execute tasks until no queue has any left
+    void work(unsigned int id);
+
+    //! Next task for the given thread, either its own or a stolen one (NULL if none)
+    WorkerTask* nextTask(unsigned int id);
+};
+
+#endif
@@ -0,0 +1,101 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "common/timer/TtiTimer.h"
+#include "corenetwork/binder/LteBinder.h"
+
+TtiTimer::TtiTimer(cSimpleModule* module, TtiListener* listener, const char* name, short kind, short priority)
+{
+    module_ = module;
+    listener_ = listener;
+    kind_ = kind;
+    priority_ = priority;
+    busy_ = false;
+    triggered_ = false;
+    shared_ = getBinder()->isTtiDriverEnabled();
+    startTime_ = 0;
+
+    msg_ = new cMessage(name, kind);
+    msg_->setSchedulingPriority(priority);
+}
+
+TtiTimer::~TtiTimer()
+{
+    stop();
+    if (shared_ && triggered_ && getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        getBinder()->unregisterTtiTimer(this);
+    module_->cancelAndDelete(msg_);
+}
+
+void TtiTimer::start()
+{
+    if (busy_)
+        return;
+
+    busy_ = true;
+    startTime_ = NOW;
+
+    if (shared_)
+        getBinder()->registerTtiTimer(this);
+    else
+        module_->scheduleAt(NOW + TTI, msg_);
+}
+
+void TtiTimer::stop()
+{
+    if (!busy_)
+        return;
+
+    busy_ = false;
+    if (shared_)
+    {
+        // at network cleanup the binder may be gone already
+        if (getSimulation()->getSimulationStage() != CTX_CLEANUP)
+            getBinder()->unregisterTtiTimer(this);
+    }
+    else
+        module_->cancelEvent(msg_);
+}
+
+void TtiTimer::trigger()
+{
+    if (busy_)
+        throw cRuntimeError("TtiTimer::trigger - timer %s is running", msg_->getName());
+
+    if (triggered_)
+        return;
+
+    triggered_ = true;
+    if (shared_)
+        getBinder()->triggerTtiTimer(this);
+    else
+        module_->scheduleAt(NOW, msg_);
+}
+
+void TtiTimer::handle()
+{
+    triggered_ = false;
+    listener_->handleTtiTick(kind_);
+
+    // the listener may have stopped the timer
+    if (busy_)
+        module_->scheduleAt(NOW + TTI, msg_);
+}
+
+void TtiTimer::tick()
+{
+    // a timer started during this TTI starts ticking from the next one
+    if (busy_ && startTime_ == NOW)
+        return;
+
+    triggered_ = false;
+    cMethodCallContextSwitcher ctx(module_);
+    ctx.methodCallSilent();
+    listener_->handleTtiTick(kind_);
+}
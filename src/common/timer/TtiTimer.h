@@ -0,0 +1,162 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_TTITIMER_H_
+#define _LTE_TTITIMER_H_
+
+#include "common/LteCommon.h"
+
+//! Interface of the modules driven by a TtiTimer
+class TtiListener
+{
+  public:
+    virtual ~TtiListener()
+    {
+    }
+
+    /*!
+     * Called once per TTI, in the context of the module owning the timer.
+     *
+     * @param kind the kind the timer has been created with
+     */
+    virtual void handleTtiTick(short kind) = 0;
+};
+
+/*!
+ * TTI timer.
+ *
+ * Each module creates one timer per TTI activity, instead of allocating a new
+ * self message every TTI. A timer is either recurring (start()/stop(), one tick
+ * per TTI) or triggered on demand (trigger(), one tick at the current time, e.g.
+ * to defer some processing to the end of the TTI).
+ *
+ * The timer can work in two ways, depending on the LteBinder parameter "ttiClock":
+ * - "local": the timer owns a single self message with the given kind. The owner
+ *   dispatches it in handleMessage() on its kind and calls handle();
+ * - "driver": the binder drives the TTI. For each phase (see LteTtiPhase) and
+ *   start offset within the TTI it schedules a single event per TTI, which ticks
+ *   the timers of all the nodes registered for that phase. No per-node events
+ *   are scheduled, and the ticks come at the same times as in local mode.
+ *
+ * In both cases the listener receives handleTtiTick(kind).
+ */
+class TtiTimer
+{
+  public:
+    /*!
+     * Build an idle timer.
+     *
+     * @param module the owner module
+     * @param listener the object receiving the ticks (usually the owner module)
+     * @param name name of the self message
+     * @param kind kind of the self message (see LteSelfMessageKind)
+     * @param priority scheduling priority of the ticks, i.e. the TTI phase (see LteTtiPhase)
+     */
+    TtiTimer(cSimpleModule* module, TtiListener* listener, const char* name, short kind, short priority);
+
+    //! Stop the timer and release its message
+    ~TtiTimer();
+
+    /*!
+     * Start the recurring ticks. The first tick comes after one TTI.
+     */
+    void start();
+
+    //! Stop the recurring ticks, if running
+    void stop();
+
+    /*!
+     * Request a single tick at the current time, after the events with higher
+     * priority. Requests issued before the tick are merged.
+     * Must not be used on a running timer.
+     */
+    void trigger();
+
+    //! Return true if the timer is running
+    bool busy() const
+    {
+        return busy_;
+    }
+
+    //! Return true if a triggered tick is pending
+    bool triggered() const
+    {
+        return triggered_;
+    }
+
+    //! Return true if the ticks come from the TTI driver
+    bool isShared() const
+    {
+        return shared_;
+    }
+
+    short getKind() const
+    {
+        return kind_;
+    }
+
+    short getPriority() const
+    {
+        return priority_;
+    }
+
+    cSimpleModule* getModule() const
+    {
+        return module_;
+    }
+
+    //! Time the timer has been started at
+    simtime_t getStartTime() const
+    {
+        return startTime_;
+    }
+
+    /*!
+     * Handle the expiration of the local self message: notify the listener,
+     * then reschedule the message for the next TTI if the timer is running.
+     * Called by the owner module.
+     */
+    void handle();
+
+    /*!
+     * Tick from the TTI driver: switch to the owner context and notify the listener.
+     * Called by the binder.
+     */
+    void tick();
+
+  protected:
+    //! Owner module
+    cSimpleModule* module_;
+
+    //! Receiver of the ticks
+    TtiListener* listener_;
+
+    //! Self message, used in local mode
+    cMessage* msg_;
+
+    //! Kind of the ticks
+    short kind_;
+
+    //! Scheduling priority of the ticks
+    short priority_;
+
+    //! True if the timer is running
+    bool busy_;
+
+    //! True if a triggered tick is pending
+    bool triggered_;
+
+    //! True if the ticks come from the TTI driver
+    bool shared_;
+
+    //! Time the timer has been started at (ticks at the same time are skipped)
+    simtime_t startTime_;
+};
+
+#endif
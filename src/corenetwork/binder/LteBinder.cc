@@ -22,6 +22,28 @@ void LteBinder::registerDeployer(LteDeployer* pDeployer, MacCellId macCellId)
     deployersMap_[macCellId] = pDeployer;
 }
 
+ParameterMap& LteBinder::getXmlParameters(cXMLElement* xmlData)
+{
+    std::map<cXMLElement*, ParameterMap>::iterator it = xmlParameters_.find(xmlData);
+    if (it != xmlParameters_.end())
+        return it->second;
+    ParameterMap& params = xmlParameters_[xmlData];
+    getParametersFromXML(xmlData, params);
+    return params;
+}
+
+const SidelinkConfiguration* LteBinder::getSidelinkConfiguration(cXMLElement* xmlConfig, const SidelinkTxParams& defaults)
+{
+    for (unsigned int i = 0; i < sidelinkConfigs_.size(); i++)
+    {
+        if (sidelinkConfigs_[i]->matches(xmlConfig, defaults))
+            return sidelinkConfigs_[i];
+    }
+    SidelinkConfiguration* config = new SidelinkConfiguration(xmlConfig, defaults);
+    sidelinkConfigs_.push_back(config);
+    return config;
+}
+
 //void LteBinder::nodesConfiguration() {
 //
 //    if (nodesConfigured_ == true)
@@ -629,35 +651,241 @@ void LteBinder::attachAppModule(cModule *parentModule, std::string IPAddr,
 
 void LteBinder::unregisterNode(MacNodeId id)
 {
+    Enter_Method_Silent("unregisterNode");
     EV << NOW << " LteBinder::unregisterNode - unregistering node " << id << endl;
 
-    if(nodeIds_.erase(id) != 1){
+    if (id >= nodes_.size() || nodes_[id].omnetId == 0)
+    {
         EV_ERROR << "Cannot unregister node - node id \"" << id << "\" - not found";
+        return;
     }
-    std::map<IPv4Address, MacNodeId>::iterator it;
-    for(it = macNodeIdToIPAddress_.begin(); it != macNodeIdToIPAddress_.end(); )
+
+    // the modules are not notified at the end of the simulation, when they are being deleted
+    if (getSimulation()->getSimulationStage() != CTX_CLEANUP)
     {
-        if(it->second == id)
+        notifyingNodeLeft_ = true;
+        if (id < UE_MIN_ID)
         {
-            macNodeIdToIPAddress_.erase(it++);
+            // eNBs and relays may be known by any node
+            std::map<OmnetId, std::vector<LteNodeListener*> >::iterator it;
+            for (it = nodeListeners_.begin(); it != nodeListeners_.end(); ++it)
+                notifyNodeLeft(it->first, id);
         }
         else
         {
-            it++;
+            // the nodes that may keep state about the UE
+            std::set<MacNodeId> related(nodes_[id].receivers);
+            related.insert(id);
+            if (id < nextHop_.size() && nextHop_[id] != 0)
+                related.insert(nextHop_[id]);
+            std::map<MacNodeId, std::map<MacNodeId, bool> >::iterator cit = d2dPeeringCapability_.find(id);
+            if (cit != d2dPeeringCapability_.end())
+            {
+                std::map<MacNodeId, bool>::iterator jt;
+                for (jt = cit->second.begin(); jt != cit->second.end(); ++jt)
+                    related.insert(jt->first);
+            }
+            std::map<MacNodeId, std::set<MacNodeId> >::iterator sit = d2dPeeringSources_.find(id);
+            if (sit != d2dPeeringSources_.end())
+                related.insert(sit->second.begin(), sit->second.end());
+
+            notifyNodeLeft(0, id);
+            std::set<MacNodeId>::iterator rt;
+            for (rt = related.begin(); rt != related.end(); ++rt)
+            {
+                OmnetId owner = getOmnetId(*rt);
+                if (owner != 0)
+                    notifyNodeLeft(owner, id);
+            }
         }
+        notifyingNodeLeft_ = false;
+        compactNodeListeners();
+    }
+
+    releaseNode(id);
+}
+
+void LteBinder::releaseNode(MacNodeId id)
+{
+    NodeSlot& node = nodes_[id];
+    omnetIdToMacNodeId_.erase(node.omnetId);
+    node.omnetId = 0;
+    node.mac = NULL;
+    node.generation++;
+    nodeCount_--;
+
+    for (unsigned int i = 0; i < node.ipAddresses.size(); i++)
+        macNodeIdToIPAddress_.erase(node.ipAddresses[i]);
+    node.ipAddresses.clear();
+    for (unsigned int i = 0; i < node.nonIpAddresses.size(); i++)
+        macNodeIdToNonIPAddress_.erase(node.nonIpAddresses[i]);
+    node.nonIpAddresses.clear();
+
+    std::map<MacNodeId, char*>::iterator nit = macNodeIdToModuleName_.find(id);
+    if (nit != macNodeIdToModuleName_.end())
+    {
+        delete [] nit->second;
+        macNodeIdToModuleName_.erase(nit);
     }
-    std::map<long, MacNodeId>::iterator jt;
-    for(jt = macNodeIdToNonIPAddress_.begin(); jt != macNodeIdToNonIPAddress_.end(); )
+
+    // master and D2D pairs
+    if (id < nextHop_.size() && nextHop_[id] != 0)
     {
-        if(jt->second == id)
+        MacNodeId oldMasterId = nextHop_[id];
+        nextHop_[id] = 0;
+        updateCellD2DPairs(id, oldMasterId);
+    }
+    DeployedUesMap::iterator dit;
+    for (dit = dMap_.begin(); dit != dMap_.end(); ++dit)
+        dit->second.erase(id);
+
+    std::map<MacNodeId, std::set<MacNodeId> >::iterator sit = d2dPeeringSources_.find(id);
+    if (sit != d2dPeeringSources_.end())
+    {
+        std::set<MacNodeId>::iterator jt;
+        for (jt = sit->second.begin(); jt != sit->second.end(); ++jt)
         {
-            macNodeIdToNonIPAddress_.erase(jt++);
+            d2dPeeringCapability_[*jt].erase(id);
+            d2dPeeringMode_[*jt].erase(id);
         }
-        else
+        d2dPeeringSources_.erase(sit);
+    }
+    std::map<MacNodeId, std::map<MacNodeId, bool> >::iterator cit = d2dPeeringCapability_.find(id);
+    if (cit != d2dPeeringCapability_.end())
+    {
+        std::map<MacNodeId, bool>::iterator jt;
+        for (jt = cit->second.begin(); jt != cit->second.end(); ++jt)
+            d2dPeeringSources_[jt->first].erase(id);
+        d2dPeeringCapability_.erase(cit);
+    }
+    d2dPeeringMode_.erase(id);
+
+    multicastGroupMap_.erase(id);
+    ueHandoverTriggered_.erase(id);
+
+    std::set<MacNodeId>::iterator pit;
+    for (pit = node.receivers.begin(); pit != node.receivers.end(); ++pit)
+        nodes_[*pit].senders.erase(id);
+    node.receivers.clear();
+    for (pit = node.senders.begin(); pit != node.senders.end(); ++pit)
+        nodes_[*pit].receivers.erase(id);
+    node.senders.clear();
+
+    if (recycleNodeIds_ && id >= UE_MIN_ID)
+        freeUeIds_.push_back(std::make_pair(NOW, id));
+}
+
+void LteBinder::addNodeReceiver(MacNodeId senderId, MacNodeId receiverId)
+{
+    // all the nodes are notified when an eNB or relay leaves
+    if (senderId < UE_MIN_ID || receiverId == 0 || senderId >= nodes_.size() || receiverId >= nodes_.size())
+        return;
+    if (nodes_[senderId].receivers.insert(receiverId).second)
+        nodes_[receiverId].senders.insert(senderId);
+}
+
+void LteBinder::addNodeListener(LteNodeListener* listener)
+{
+    if (nodeListenerOwners_.find(listener) != nodeListenerOwners_.end())
+        return;
+
+    // the listener belongs to the closest node (i.e. module with a MacNodeId) containing it
+    OmnetId owner = 0;
+    for (cModule* module = dynamic_cast<cModule*>(listener); module != NULL; module = module->getParentModule())
+    {
+        if (module->hasPar("macNodeId"))
         {
-            jt++;
+            owner = module->getId();
+            break;
         }
     }
+    nodeListenerOwners_[listener] = owner;
+    nodeListeners_[owner].push_back(listener);
+}
+
+void LteBinder::removeNodeListener(LteNodeListener* listener)
+{
+    std::map<LteNodeListener*, OmnetId>::iterator it = nodeListenerOwners_.find(listener);
+    if (it == nodeListenerOwners_.end())
+        return;
+
+    std::vector<LteNodeListener*>& listeners = nodeListeners_[it->second];
+    std::vector<LteNodeListener*>::iterator lt = std::find(listeners.begin(), listeners.end(), listener);
+    if (notifyingNodeLeft_)
+    {
+        // the slot is left empty, so that the others keep their position
+        *lt = NULL;
+        removedNodeListeners_.insert(it->second);
+    }
+    else
+    {
+        listeners.erase(lt);
+        if (listeners.empty())
+            nodeListeners_.erase(it->second);
+    }
+    nodeListenerOwners_.erase(it);
+}
+
+void LteBinder::notifyNodeLeft(OmnetId owner, MacNodeId id)
+{
+    std::map<OmnetId, std::vector<LteNodeListener*> >::iterator it = nodeListeners_.find(owner);
+    if (it == nodeListeners_.end())
+        return;
+
+    // listeners may be added while notifying
+    std::vector<LteNodeListener*>& listeners = it->second;
+    for (unsigned int i = 0; i < listeners.size(); i++)
+    {
+        if (listeners[i] != NULL)
+            listeners[i]->nodeLeft(id);
+    }
+}
+
+void LteBinder::compactNodeListeners()
+{
+    std::set<OmnetId>::iterator it;
+    for (it = removedNodeListeners_.begin(); it != removedNodeListeners_.end(); ++it)
+    {
+        std::vector<LteNodeListener*>& listeners = nodeListeners_[*it];
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), (LteNodeListener*) NULL), listeners.end());
+        if (listeners.empty())
+            nodeListeners_.erase(*it);
+    }
+    removedNodeListeners_.clear();
+}
+
+const std::vector<IPv4Address>& LteBinder::getNodeIpAddresses(MacNodeId id)
+{
+    static const std::vector<IPv4Address> none;
+    return (id < nodes_.size()) ? nodes_[id].ipAddresses : none;
+}
+
+const std::vector<long>& LteBinder::getNodeNonIpAddresses(MacNodeId id)
+{
+    static const std::vector<long> none;
+    return (id < nodes_.size()) ? nodes_[id].nonIpAddresses : none;
+}
+
+void LteBinder::setMacNodeId(IPv4Address address, MacNodeId nodeId)
+{
+    macNodeIdToIPAddress_[address] = nodeId;
+
+    if (nodes_.size() <= nodeId)
+        nodes_.resize(nodeId + 1);
+    std::vector<IPv4Address>& addresses = nodes_[nodeId].ipAddresses;
+    if (std::find(addresses.begin(), addresses.end(), address) == addresses.end())
+        addresses.push_back(address);
+}
+
+void LteBinder::setMacNodeId(long address, MacNodeId nodeId)
+{
+    macNodeIdToNonIPAddress_[address] = nodeId;
+
+    if (nodes_.size() <= nodeId)
+        nodes_.resize(nodeId + 1);
+    std::vector<long>& addresses = nodes_[nodeId].nonIpAddresses;
+    if (std::find(addresses.begin(), addresses.end(), address) == addresses.end())
+        addresses.push_back(address);
 }
 
 MacNodeId LteBinder::registerNode(cModule *module, LteNodeType type,
@@ -669,7 +897,17 @@ MacNodeId LteBinder::registerNode(cModule *module, LteNodeType type,
 
     if (type == UE)
     {
-        macNodeId = macNodeIdCounter_[2]++;
+        if (!freeUeIds_.empty() && freeUeIds_.front().first + nodeIdRecycleDelay_ <= NOW)
+        {
+            macNodeId = freeUeIds_.front().second;
+            freeUeIds_.pop_front();
+        }
+        else
+        {
+            if (macNodeIdCounter_[2] == 0)
+                throw cRuntimeError("LteBinder::registerNode - no UE ids left, consider enabling recycleNodeIds");
+            macNodeId = macNodeIdCounter_[2]++;
+        }
     }
     else if (type == RELAY)
     {
@@ -686,7 +924,14 @@ MacNodeId LteBinder::registerNode(cModule *module, LteNodeType type,
 
     // registering new node to LteBinder
 
-    nodeIds_[macNodeId] = module->getId();
+    if (nodes_.size() <= macNodeId)
+        nodes_.resize(macNodeId + 1);
+    if (nodes_[macNodeId].omnetId == 0)
+        nodeCount_++;
+    else
+        omnetIdToMacNodeId_.erase(nodes_[macNodeId].omnetId);
+    nodes_[macNodeId].omnetId = module->getId();
+    omnetIdToMacNodeId_[module->getId()] = macNodeId;
 
     module->par("macNodeId") = macNodeId;
 
@@ -715,7 +960,11 @@ void LteBinder::registerNextHop(MacNodeId masterId, MacNodeId slaveId)
 
     if (nextHop_.size() <= slaveId)
         nextHop_.resize(slaveId + 1);
+    MacNodeId oldMasterId = nextHop_[slaveId];
     nextHop_[slaveId] = masterId;
+
+    if (oldMasterId != masterId)
+        updateCellD2DPairs(slaveId, oldMasterId);
 }
 
 void LteBinder::initialize(int stage)
@@ -724,6 +973,26 @@ void LteBinder::initialize(int stage)
     {
         numBands_ = par("numBands");
 
+        // size the per-node tables for the expected UEs, so that they do not grow while the nodes register
+        int expectedUes = par("expectedUes");
+        if (expectedUes > 0)
+        {
+            nextHop_.reserve(UE_MIN_ID + expectedUes);
+            nodes_.reserve(UE_MIN_ID + expectedUes);
+            ueList_.reserve(expectedUes);
+        }
+
+        recycleNodeIds_ = par("recycleNodeIds");
+        nodeIdRecycleDelay_ = par("nodeIdRecycleDelay");
+
+        std::string ttiClock = par("ttiClock").stdstringValue();
+        if (ttiClock != "local" && ttiClock != "driver")
+            throw cRuntimeError("LteBinder::initialize - unknown ttiClock %s", ttiClock.c_str());
+        std::string ttiDriverOrder = par("ttiDriverOrder").stdstringValue();
+        if (ttiDriverOrder != "compat" && ttiDriverOrder != "type")
+            throw cRuntimeError("LteBinder::initialize - unknown ttiDriverOrder %s", ttiDriverOrder.c_str());
+        ttiDriverGroupByType_ = (ttiDriverOrder == "type");
+
         const char * stringa;
 
         std::vector<int> apppriority;
@@ -750,6 +1019,197 @@ void LteBinder::initialize(int stage)
     }
 }
 
+void LteBinder::handleMessage(cMessage *msg)
+{
+    // TTI driver: each message runs one phase of the TTI for all the registered nodes
+    short phase = msg->getSchedulingPriority();
+
+    if (msg->getKind() == CHANNEL_MEASUREMENT)
+    {
+        runReceptionTasks();
+        return;
+    }
+
+    if (msg->getKind() == TTI_TRIGGER)
+    {
+        // timers can be unregistered (slot cleared) while ticking
+        std::vector<TtiTimer*>& timers = triggeredTtiTimers_[phase];
+        for (unsigned int i = 0; i < timers.size(); i++)
+        {
+            if (timers[i] != NULL)
+                timers[i]->tick();
+        }
+        timers.clear();
+        return;
+    }
+
+    // the clock ticks every TTI from its start offset
+    TtiClockKey key = getTtiClockKey(phase, NOW);
+    std::vector<TtiTimer*>& timers = ttiTimers_[key];
+
+    // timers started during the previous TTI join the clock
+    std::vector<TtiTimer*>& newTimers = newTtiTimers_[key];
+    for (unsigned int i = 0; i < newTimers.size(); i++)
+    {
+        if (newTimers[i] != NULL)
+            insertTtiTimer(timers, newTimers[i]);
+    }
+    newTimers.clear();
+
+    // timers can be unregistered (slot cleared) while ticking
+    for (unsigned int i = 0; i < timers.size(); i++)
+    {
+        if (timers[i] != NULL)
+            timers[i]->tick();
+    }
+    timers.erase(std::remove(timers.begin(), timers.end(), (TtiTimer*) NULL), timers.end());
+
+    if (timers.empty() && newTimers.empty())
+    {
+        ttiTimers_.erase(key);
+        newTtiTimers_.erase(key);
+        ttiClocks_.erase(key);
+        delete msg;
+    }
+    else
+        scheduleAt(NOW + TTI, msg);
+}
+
+void LteBinder::insertTtiTimer(std::vector<TtiTimer*>& timers, TtiTimer* timer)
+{
+    if (ttiDriverGroupByType_)
+    {
+        // after the last timer of the same module type, so that each phase iterates homogeneous modules
+        cComponentType* type = timer->getModule()->getComponentType();
+        std::vector<TtiTimer*>::reverse_iterator it;
+        for (it = timers.rbegin(); it != timers.rend(); ++it)
+        {
+            if (*it != NULL && (*it)->getModule()->getComponentType() == type)
+            {
+                timers.insert(it.base(), timer);
+                return;
+            }
+        }
+    }
+    // in start order, i.e. the order of the per-node self messages
+    timers.push_back(timer);
+}
+
+LteBinder::TtiClockKey LteBinder::getTtiClockKey(short phase, simtime_t startTime)
+{
+    return TtiClockKey(phase, startTime.raw() % SimTime(TTI).raw());
+}
+
+void LteBinder::registerTtiTimer(TtiTimer* timer)
+{
+    Enter_Method_Silent("registerTtiTimer");
+
+    short phase = timer->getPriority();
+    TtiClockKey key = getTtiClockKey(phase, timer->getStartTime());
+    newTtiTimers_[key].push_back(timer);
+
+    // a timer started off the grid of the running clocks gets its own clock, so that it
+    // ticks at the same times as its self message would with the "local" clock
+    if (ttiClocks_.find(key) == ttiClocks_.end())
+    {
+        cMessage* clock = new cMessage("ttiClock", TTI_TICK);
+        clock->setSchedulingPriority(phase);
+        scheduleAt(NOW + TTI, clock);
+        ttiClocks_[key] = clock;
+    }
+}
+
+void LteBinder::triggerTtiTimer(TtiTimer* timer)
+{
+    Enter_Method_Silent("triggerTtiTimer");
+
+    short phase = timer->getPriority();
+    triggeredTtiTimers_[phase].push_back(timer);
+
+    cMessage*& trigger = ttiTriggers_[phase];
+    if (trigger == NULL)
+    {
+        trigger = new cMessage("ttiTrigger", TTI_TRIGGER);
+        trigger->setSchedulingPriority(phase);
+    }
+    if (!trigger->isScheduled())
+        scheduleAt(NOW, trigger);
+}
+
+void LteBinder::unregisterTtiTimer(TtiTimer* timer)
+{
+    short phase = timer->getPriority();
+    TtiClockKey key = getTtiClockKey(phase, timer->getStartTime());
+    std::map<TtiClockKey, std::vector<TtiTimer*> >* lists[2] = { &ttiTimers_, &newTtiTimers_ };
+    for (int l = 0; l < 2; l++)
+    {
+        std::map<TtiClockKey, std::vector<TtiTimer*> >::iterator pit = lists[l]->find(key);
+        if (pit == lists[l]->end())
+            continue;
+
+        std::vector<TtiTimer*>::iterator it = std::find(pit->second.begin(), pit->second.end(), timer);
+        if (it != pit->second.end())
+            *it = NULL;    // removed at the next tick, it may be in progress
+    }
+
+    std::map<short, std::vector<TtiTimer*> >::iterator pit = triggeredTtiTimers_.find(phase);
+    if (pit != triggeredTtiTimers_.end())
+    {
+        std::vector<TtiTimer*>::iterator it = std::find(pit->second.begin(), pit->second.end(), timer);
+        if (it != pit->second.end())
+            *it = NULL;
+    }
+}
+
+void LteBinder::addReceptionTask(WorkerTask* task)
+{
+    Enter_Method_Silent("addReceptionTask");
+
+    receptionTasks_.push_back(task);
+
+    if (receptionMsg_ == NULL)
+    {
+        receptionMsg_ = new cMessage("channelMeasurement", CHANNEL_MEASUREMENT);
+        receptionMsg_->setSchedulingPriority(TTI_PHASE_MEASUREMENT);
+    }
+    // after all the airframes of this TTI have been received, before they are decoded
+    if (!receptionMsg_->isScheduled())
+        scheduleAt(NOW, receptionMsg_);
+}
+
+void LteBinder::removeReceptionTask(WorkerTask* task)
+{
+    std::vector<WorkerTask*>::iterator it = std::find(receptionTasks_.begin(), receptionTasks_.end(), task);
+    if (it != receptionTasks_.end())
+        receptionTasks_.erase(it);
+}
+
+void LteBinder::runReceptionTasks()
+{
+    // log output is not thread safe: with logging enabled the receivers are measured sequentially.
+    // Each receiver draws from its own RNG stream, so the results are the same
+    if (getEnvir()->isLoggingEnabled())
+    {
+        for (unsigned int i = 0; i < receptionTasks_.size(); i++)
+            receptionTasks_[i]->execute();
+    }
+    else
+    {
+        if (receptionPool_ == NULL)
+            receptionPool_ = new WorkerPool(par("receptionThreads").intValue());
+        receptionPool_->run(receptionTasks_);
+    }
+    receptionTasks_.clear();
+}
+
+unsigned int LteBinder::getCounterRngSeed()
+{
+    int seed = par("counterRngSeed");
+    if (seed < 0)
+        seed = atoi(getEnvir()->getConfigEx()->getVariable("seedset"));
+    return seed;
+}
+
 std::string LteBinder::increment_address(const char* address_string)  //TODO unused function
 {
     IPv4Address addr(address_string);
@@ -780,23 +1240,32 @@ void LteBinder::unregisterNextHop(MacNodeId masterId, MacNodeId slaveId)
 
     if (nextHop_.size() <= slaveId)
         return;
+    MacNodeId oldMasterId = nextHop_[slaveId];
     nextHop_[slaveId] = 0;
+
+    if (oldMasterId != 0)
+        updateCellD2DPairs(slaveId, oldMasterId);
 }
 
 OmnetId LteBinder::getOmnetId(MacNodeId nodeId)
 {
-    std::map<int, OmnetId>::iterator it = nodeIds_.find(nodeId);
-    if(it != nodeIds_.end())
-        return it->second;
+    if (nodeId < nodes_.size())
+        return nodes_[nodeId].omnetId;
+    return 0;
+}
+
+OmnetId LteBinder::getOmnetId(MacNodeId nodeId, unsigned int generation)
+{
+    if (nodeId < nodes_.size() && nodes_[nodeId].generation == generation)
+        return nodes_[nodeId].omnetId;
     return 0;
 }
 
 MacNodeId LteBinder::getMacNodeIdFromOmnetId(OmnetId id){
-	std::map<int, OmnetId>::iterator it;
-	for (it = nodeIds_.begin(); it != nodeIds_.end(); ++it )
-	    if (it->second == id)
-	        return it->first;
-	return 0;
+    std::map<OmnetId, MacNodeId>::iterator it = omnetIdToMacNodeId_.find(id);
+    if (it == omnetIdToMacNodeId_.end())
+        return 0;
+    return it->second;
 }
 
 LteMacBase* LteBinder::getMacFromMacNodeId(MacNodeId id)
@@ -804,16 +1273,12 @@ LteMacBase* LteBinder::getMacFromMacNodeId(MacNodeId id)
     if (id == 0)
         return NULL;
 
-    LteMacBase* mac;
-    if (macNodeIdToModule_.find(id) == macNodeIdToModule_.end())
-    {
+    if (id >= nodes_.size())
+        return NULL;
+    // cleared when the node leaves
+    LteMacBase*& mac = nodes_[id].mac;
+    if (mac == NULL)
         mac = check_and_cast<LteMacBase*>(getMacByMacNodeId(id));
-        macNodeIdToModule_[id] = mac;
-    }
-    else
-    {
-        mac = macNodeIdToModule_[id];
-    }
     return mac;
 }
 
@@ -828,6 +1293,7 @@ MacNodeId LteBinder::getNextHop(MacNodeId slaveId)
 void LteBinder::registerName(MacNodeId nodeId, const char* moduleName)
 {
     int len = strlen(moduleName);
+    delete [] macNodeIdToModuleName_[nodeId];
     macNodeIdToModuleName_[nodeId] = new char[len+1];
     strcpy(macNodeIdToModuleName_[nodeId], moduleName);
 }
@@ -892,6 +1358,7 @@ void LteBinder::addD2DCapability(MacNodeId src, MacNodeId dst)
         throw cRuntimeError("LteBinder::addD2DCapability - Node Id not valid. Src %d Dst %d", src, dst);
 
     d2dPeeringCapability_[src][dst] = true;
+    d2dPeeringSources_[dst].insert(src);
 
     // insert initial communication mode
     // TODO make it configurable from NED
@@ -902,6 +1369,8 @@ void LteBinder::addD2DCapability(MacNodeId src, MacNodeId dst)
     else
         d2dPeeringMode_[src][dst] = IM;
 
+    addCellD2DPair(src, dst);
+
     EV << "LteBinder::addD2DCapability - UE " << src << " may transmit to UE " << dst << " using D2D (current mode " << ((d2dPeeringMode_[src][dst] == DM) ? "DM)" : "IM)") << endl;
 }
 
@@ -920,6 +1389,59 @@ std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> >* LteBinder::getD2DPeeringM
     return &d2dPeeringMode_;
 }
 
+const D2DPairMap& LteBinder::getCellD2DPairs(MacNodeId masterId)
+{
+    return cellD2DPairs_[masterId];
+}
+
+void LteBinder::addCellD2DPair(MacNodeId src, MacNodeId dst)
+{
+    if (nextHop_.size() <= src || nextHop_.size() <= dst)
+        return;
+    if (nextHop_[src] != 0 && nextHop_[src] == nextHop_[dst])
+        cellD2DPairs_[nextHop_[src]][src].insert(dst);
+}
+
+void LteBinder::removeCellD2DPair(MacNodeId masterId, MacNodeId src, MacNodeId dst)
+{
+    std::map<MacNodeId, D2DPairMap>::iterator it = cellD2DPairs_.find(masterId);
+    if (it == cellD2DPairs_.end())
+        return;
+    D2DPairMap::iterator jt = it->second.find(src);
+    if (jt == it->second.end())
+        return;
+    jt->second.erase(dst);
+    if (jt->second.empty())
+        it->second.erase(jt);
+}
+
+void LteBinder::updateCellD2DPairs(MacNodeId nodeId, MacNodeId oldMasterId)
+{
+    // pairs where the node is the transmitter
+    std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> >::iterator it = d2dPeeringMode_.find(nodeId);
+    if (it != d2dPeeringMode_.end())
+    {
+        std::map<MacNodeId, LteD2DMode>::iterator jt = it->second.begin();
+        for (; jt != it->second.end(); ++jt)
+        {
+            removeCellD2DPair(oldMasterId, nodeId, jt->first);
+            addCellD2DPair(nodeId, jt->first);
+        }
+    }
+
+    // pairs where the node is the receiver
+    std::map<MacNodeId, std::set<MacNodeId> >::iterator st = d2dPeeringSources_.find(nodeId);
+    if (st != d2dPeeringSources_.end())
+    {
+        std::set<MacNodeId>::iterator jt = st->second.begin();
+        for (; jt != st->second.end(); ++jt)
+        {
+            removeCellD2DPair(oldMasterId, *jt, nodeId);
+            addCellD2DPair(*jt, nodeId);
+        }
+    }
+}
+
 LteD2DMode LteBinder::getD2DMode(MacNodeId src, MacNodeId dst)
 {
     if (src < UE_MIN_ID || src >= macNodeIdCounter_[2] || dst < UE_MIN_ID || dst >= macNodeIdCounter_[2])
@@ -12,13 +12,19 @@
 
 #include <omnetpp.h>
 #include <string>
+#include <deque>
 
 #include "common/LteCommon.h"
 #include "inet/networklayer/contract/ipv4/IPv4Address.h"
 #include "inet/networklayer/common/L3Address.h"
 #include "corenetwork/binder/PhyPisaData.h"
 #include "corenetwork/nodes/ExtCell.h"
+#include "stack/phy/ChannelModel/ExtCellInterferenceMap.h"
 #include "stack/mac/layer/LteMacBase.h"
+#include "stack/mac/layer/SidelinkConfiguration.h"
+#include "common/timer/TtiTimer.h"
+#include "common/WorkerPool.h"
+#include "common/LteNodeListener.h"
 
 using namespace inet;
 
@@ -53,17 +59,92 @@ class LteBinder : public cSimpleModule
     std::map<IPv4Address, MacNodeId> macNodeIdToIPAddress_;
     std::map<long, MacNodeId> macNodeIdToNonIPAddress_;
     std::map<MacNodeId, char*> macNodeIdToModuleName_;
-    std::map<MacNodeId, LteMacBase*> macNodeIdToModule_;
     DeployerList deployersMap_;
     std::vector<MacNodeId> nextHop_; // MacNodeIdMaster --> MacNodeIdSlave
-    std::map<int, OmnetId> nodeIds_;
+
+    // registration of a MacNodeId
+    struct NodeSlot
+    {
+        OmnetId omnetId;          // 0 if not registered
+        unsigned int generation;  // number of nodes that have left the id so far
+        LteMacBase* mac;          // MAC module, NULL until looked up
+        // addresses associated with the node (see setMacNodeId())
+        std::vector<IPv4Address> ipAddresses;
+        std::vector<long> nonIpAddresses;
+        // UEs only: nodes that have received frames from this one, and the other way round (see addNodeReceiver())
+        std::set<MacNodeId> receivers;
+        std::set<MacNodeId> senders;
+
+        NodeSlot()
+        {
+            omnetId = 0;
+            generation = 0;
+            mac = NULL;
+        }
+    };
+    std::vector<NodeSlot> nodes_; // indexed by MacNodeId
+    std::map<OmnetId, MacNodeId> omnetIdToMacNodeId_; // registered nodes only
+    int nodeCount_; // number of registered nodes
+
+    // if true, the ids of the UEs that have left are assigned again, once nodeIdRecycleDelay_ has elapsed
+    bool recycleNodeIds_;
+    simtime_t nodeIdRecycleDelay_;
+    // UE ids released so far, with their release time, in release order
+    std::deque<std::pair<simtime_t, MacNodeId> > freeUeIds_;
+
+    // modules notified when a node leaves the simulation, grouped by the OmnetId of the node they
+    // belong to (0 for the ones outside any node), in the order they have been added
+    // (NULL for the ones removed while the listeners are being notified)
+    std::map<OmnetId, std::vector<LteNodeListener*> > nodeListeners_;
+    // node each listener belongs to
+    std::map<LteNodeListener*, OmnetId> nodeListenerOwners_;
+    // groups of nodeListeners_ with NULL slots
+    std::set<OmnetId> removedNodeListeners_;
+    // true while the listeners are being notified
+    bool notifyingNodeLeft_;
+
+    // notify the listeners of the given node that node <id> has left
+    void notifyNodeLeft(OmnetId owner, MacNodeId id);
+    // drop the NULL slots of nodeListeners_
+    void compactNodeListeners();
+
+    // drop the node from the per-node tables of the binder
+    void releaseNode(MacNodeId id);
 
     // list of static external cells. Used for intercell interference evaluation
     ExtCellList extCellList_;
+    // incremented when the band utilization of an external cell changes
+    unsigned long extCellVersion_;
+    // mean interference of the external cells, one map per configuration of the channel models using it
+    std::map<ExtCellMapParameters, ExtCellInterferenceMap*> extCellMaps_;
+
+    // parameters of the XML configuration elements parsed so far, shared by the modules
+    std::map<cXMLElement*, ParameterMap> xmlParameters_;
+
+    // sidelink configurations compiled so far, shared by the Mode4 UEs
+    std::vector<SidelinkConfiguration*> sidelinkConfigs_;
 
     // list of all eNBs. Used for inter-cell interference evaluation
     std::vector<EnbInfo*> enbList_;
 
+    // DL band occupancy of an eNB in its last two scheduling periods
+    struct BandOccupancy
+    {
+        std::vector<bool> occupied[2];
+        // index of the last period
+        unsigned int last;
+        // number of periods recorded so far
+        unsigned int periods;
+
+        BandOccupancy()
+        {
+            last = 0;
+            periods = 0;
+        }
+    };
+    // band occupancy of each eNB, indexed by MacNodeId
+    std::vector<BandOccupancy> bandOccupancy_;
+
     // list of all UEs. Used for inter-cell interference evaluation
     std::vector<UeInfo*> ueList_;
 
@@ -90,6 +171,15 @@ class LteBinder : public cSimpleModule
     std::map<MacNodeId, std::map<MacNodeId, bool> > d2dPeeringCapability_;
     // determines if two D2D-capable UEs are communicating in D2D mode or Infrastructure Mode
     std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> > d2dPeeringMode_;
+    // D2D-capable transmitters of each UE (reverse of d2dPeeringMode_)
+    std::map<MacNodeId, std::set<MacNodeId> > d2dPeeringSources_;
+    // D2D pairs whose endpoints are served by the same node: master --> src --> set of dst
+    std::map<MacNodeId, D2DPairMap> cellD2DPairs_;
+
+    // move the D2D pairs of a UE from the index of its old master to the one of the new master
+    void updateCellD2DPairs(MacNodeId nodeId, MacNodeId oldMasterId);
+    void addCellD2DPair(MacNodeId src, MacNodeId dst);
+    void removeCellD2DPair(MacNodeId masterId, MacNodeId src, MacNodeId dst);
 
     /*
      * Multicast support
@@ -103,14 +193,52 @@ class LteBinder : public cSimpleModule
      */
     // store the id of the UEs that are performing handover
     std::set<MacNodeId> ueHandoverTriggered_;
+
+    /*
+     * TTI driver
+     */
+    // if true, the recurring timers of each phase are grouped by module type
+    bool ttiDriverGroupByType_;
+    // a recurring timer ticks every TTI from its start time: the driver keeps one clock per phase
+    // and per start offset within the TTI (start time mod TTI, raw simtime), so that the nodes
+    // starting off the TTI grid of the others keep ticking at their own times
+    typedef std::pair<short, int64_t> TtiClockKey;
+    // recurring timers ticked by the driver, per clock, in tick order
+    std::map<TtiClockKey, std::vector<TtiTimer*> > ttiTimers_;
+    // recurring timers started during the current TTI, joining their clock at the next tick
+    std::map<TtiClockKey, std::vector<TtiTimer*> > newTtiTimers_;
+    // one clock message per phase and start offset
+    std::map<TtiClockKey, cMessage*> ttiClocks_;
+    // timers triggered for the current TTI, per phase, in trigger order
+    std::map<short, std::vector<TtiTimer*> > triggeredTtiTimers_;
+    // one trigger message per phase
+    std::map<short, cMessage*> ttiTriggers_;
+
+    // add a recurring timer to the tick order of its phase
+    void insertTtiTimer(std::vector<TtiTimer*>& timers, TtiTimer* timer);
+    // clock of the recurring timers of the given phase started at the given time
+    TtiClockKey getTtiClockKey(short phase, simtime_t startTime);
+
+    /*
+     * Parallel reception
+     */
+    // threads measuring the receptions, created at the first batch
+    WorkerPool* receptionPool_;
+    // receivers with airframes to be measured in the current TTI
+    std::vector<WorkerTask*> receptionTasks_;
+    // runs the batch, in the measurement phase of the TTI
+    cMessage* receptionMsg_;
+
+    // measure the receptions of the current TTI
+    void runReceptionTasks();
+
   protected:
     virtual void initialize(int stages);
 
     virtual int numInitStages() const { return INITSTAGE_LAST; }
 
-    virtual void handleMessage(cMessage *msg)
-    {
-    }
+    virtual void handleMessage(cMessage *msg);
+
     /**
      * Attaches the application module to a UE module.
      * At the moment only works with UDP
@@ -152,6 +280,13 @@ class LteBinder : public cSimpleModule
         macNodeIdCounter_[0] = ENB_MIN_ID;
         macNodeIdCounter_[1] = RELAY_MIN_ID;
         macNodeIdCounter_[2] = UE_MIN_ID;
+        ttiDriverGroupByType_ = false;
+        receptionPool_ = NULL;
+        receptionMsg_ = NULL;
+        extCellVersion_ = 0;
+        nodeCount_ = 0;
+        recycleNodeIds_ = false;
+        notifyingNodeLeft_ = false;
     }
 
     unsigned int getNumBands()
@@ -168,6 +303,19 @@ class LteBinder : public cSimpleModule
             delete enbList_.back();
             enbList_.pop_back();
         }
+        std::map<TtiClockKey, cMessage*>::iterator ct;
+        for (ct = ttiClocks_.begin(); ct != ttiClocks_.end(); ++ct)
+            cancelAndDelete(ct->second);
+        std::map<short, cMessage*>::iterator it;
+        for (it = ttiTriggers_.begin(); it != ttiTriggers_.end(); ++it)
+            cancelAndDelete(it->second);
+        cancelAndDelete(receptionMsg_);
+        delete receptionPool_;
+        std::map<ExtCellMapParameters, ExtCellInterferenceMap*>::iterator mt;
+        for (mt = extCellMaps_.begin(); mt != extCellMaps_.end(); ++mt)
+            delete mt->second;
+        for (unsigned int i = 0; i < sidelinkConfigs_.size(); i++)
+            delete sidelinkConfigs_[i];
     }
     int getQCIPriority(int);
     double getPacketDelayBudget(int);
@@ -198,9 +346,47 @@ class LteBinder : public cSimpleModule
 
     /**
      * Un-registers a node from the global LteBinder module.
+     *
+     * The node is dropped from all the per-node tables of the binder and the node
+     * listeners are notified, so that no module keeps state about it. For a UE,
+     * only the listeners of the nodes that may know it are: the UE itself, its
+     * master, its D2D peers and the nodes that have received its frames. With
+     * recycleNodeIds, its id is assigned again to a later UE.
      */
     void unregisterNode(MacNodeId id);
 
+    /**
+     * Number of nodes that have left the given id so far: together with the id,
+     * it tells apart the nodes the id has been assigned to (see recycleNodeIds).
+     * The PHY stamps it on the frames it sends, so that the frames still in the
+     * air when their sender leaves are dropped by the PHY and MAC of the receivers
+     */
+    unsigned int getNodeGeneration(MacNodeId id)
+    {
+        return (id < nodes_.size()) ? nodes_[id].generation : 0;
+    }
+
+    // false once the node that had the given id and generation has left the simulation
+    bool isCurrentNode(MacNodeId id, unsigned int generation)
+    {
+        return getNodeGeneration(id) == generation;
+    }
+
+    // addresses associated with the given node (see setMacNodeId()), still available while the node listeners are notified
+    const std::vector<IPv4Address>& getNodeIpAddresses(MacNodeId id);
+    const std::vector<long>& getNodeNonIpAddresses(MacNodeId id);
+
+    /*
+     * Records that <receiverId> has received a frame from the UE <senderId>, thus
+     * may keep state about it: its listeners are notified when the UE leaves
+     */
+    void addNodeReceiver(MacNodeId senderId, MacNodeId receiverId);
+
+    // notify the listener when a node it may know leaves the simulation (see LteNodeListener)
+    void addNodeListener(LteNodeListener* listener);
+    // withdraw a listener (e.g. at its deletion)
+    void removeNodeListener(LteNodeListener* listener);
+
     /**
      * registerNextHop() is called by LteDeployer at network startup
      * to bind each slave (UE or Relay) with its masters. It is also
@@ -233,6 +419,13 @@ class LteBinder : public cSimpleModule
      */
     OmnetId getOmnetId(MacNodeId nodeId);
 
+    /**
+     * As getOmnetId(), but only for the node with the given generation
+     * (see getNodeGeneration()): 0 if it has left the simulation, even if
+     * its id has been assigned to another node in the meantime
+     */
+    OmnetId getOmnetId(MacNodeId nodeId, unsigned int generation);
+
     /**
      * getMacNodeIdFromOmnetId() returns the MacNodeId of the module
      * given its OmnetId
@@ -247,7 +440,7 @@ class LteBinder : public cSimpleModule
      * given the MacNodeId of a node
      *
      * @param id MacNodeId of the module
-     * @return LteMacBase* of the module
+     * @return LteMacBase* of the module, NULL if no node has ever been given the id
      */
     LteMacBase* getMacFromMacNodeId(MacNodeId id);
 
@@ -302,19 +495,13 @@ class LteBinder : public cSimpleModule
      *
      * @param address IP address
      */
-    void setMacNodeId(IPv4Address address, MacNodeId nodeId)
-    {
-        macNodeIdToIPAddress_[address] = nodeId;
-    }
+    void setMacNodeId(IPv4Address address, MacNodeId nodeId);
     /**
      * Associates the given IP address with the given MacNodeId.
      *
      * @param address IP address
      */
-    void setMacNodeId(long address, MacNodeId nodeId)
-    {
-        macNodeIdToNonIPAddress_[address] = nodeId;
-    }
+    void setMacNodeId(long address, MacNodeId nodeId);
     /**
      * Associates the given IP address with the given X2NodeId.
      *
@@ -350,7 +537,7 @@ class LteBinder : public cSimpleModule
     PhyPisaData phyPisaData;
 
     int getNodeCount(){
-        return nodeIds_.size();
+        return nodeCount_;
     }
 
     int addExtCell(ExtCell* extCell)
@@ -359,11 +546,46 @@ class LteBinder : public cSimpleModule
         return extCellList_.size() - 1;
     }
 
-    ExtCellList getExtCellList()
+    const ExtCellList& getExtCellList()
     {
         return extCellList_;
     }
 
+    void updateExtCellVersion()
+    {
+        extCellVersion_++;
+    }
+
+    unsigned long getExtCellVersion()
+    {
+        return extCellVersion_;
+    }
+
+    /*
+     * Interference map of the external cells for the given channel model configuration,
+     * created at the first call. Channel models configured alike share the same map.
+     */
+    ExtCellInterferenceMap* getExtCellInterferenceMap(const ExtCellMapParameters& parameters)
+    {
+        ExtCellInterferenceMap*& map = extCellMaps_[parameters];
+        if (map == NULL)
+            map = new ExtCellInterferenceMap(parameters, extCellVersion_);
+        return map;
+    }
+
+    /*
+     * Parameters of the given XML element (see getParametersFromXML()), parsed at the
+     * first call and shared by all the modules configured with the same element
+     */
+    ParameterMap& getXmlParameters(cXMLElement* xmlData);
+
+    /*
+     * Sidelink configuration compiled from the given XML element, with the given defaults
+     * for the missing parameters. It is compiled at the first call, the following ones
+     * with the same arguments return the same instance.
+     */
+    const SidelinkConfiguration* getSidelinkConfiguration(cXMLElement* xmlConfig, const SidelinkTxParams& defaults);
+
     void addEnbInfo(EnbInfo* info)
     {
         enbList_.push_back(info);
@@ -374,6 +596,37 @@ class LteBinder : public cSimpleModule
         return &enbList_;
     }
 
+    /*
+     * Start a new scheduling period for the DL band occupancy of the given eNB: the last period
+     * becomes the previous one, and the returned vector (one entry per band) must be filled with
+     * the occupancy of the new period. Called by the DL scheduler after each schedule()
+     */
+    std::vector<bool>& newBandOccupancy(MacNodeId enbId, unsigned int numBands)
+    {
+        if (enbId >= bandOccupancy_.size())
+            bandOccupancy_.resize(enbId + 1);
+        BandOccupancy& occupancy = bandOccupancy_[enbId];
+        occupancy.last = 1 - occupancy.last;
+        occupancy.periods++;
+        occupancy.occupied[occupancy.last].assign(numBands, false);
+        return occupancy.occupied[occupancy.last];
+    }
+
+    /*
+     * DL band occupancy of the given eNB in its last scheduling period, or in the previous one.
+     * Returns NULL if that period has not been scheduled yet, in which case all the bands must be
+     * considered as free
+     */
+    const std::vector<bool>* getBandOccupancy(MacNodeId enbId, bool previous)
+    {
+        if (enbId >= bandOccupancy_.size())
+            return NULL;
+        const BandOccupancy& occupancy = bandOccupancy_[enbId];
+        if (occupancy.periods < (previous ? 2u : 1u))
+            return NULL;
+        return &occupancy.occupied[previous ? 1 - occupancy.last : occupancy.last];
+    }
+
     void addUeInfo(UeInfo* info)
     {
         ueList_.push_back(info);
@@ -411,6 +664,8 @@ class LteBinder : public cSimpleModule
     void addD2DCapability(MacNodeId src, MacNodeId dst);
     bool checkD2DCapability(MacNodeId src, MacNodeId dst);
     std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> >* getD2DPeeringModeMap();
+    // D2D-capable pairs whose endpoints are both served by the given node, by transmitter
+    const D2DPairMap& getCellD2DPairs(MacNodeId masterId);
     void setD2DMode(MacNodeId src, MacNodeId dst, LteD2DMode mode);
     LteD2DMode getD2DMode(MacNodeId src, MacNodeId dst);
     bool isFrequencyReuseEnabled(MacNodeId nodeId);
@@ -429,6 +684,40 @@ class LteBinder : public cSimpleModule
     bool hasUeHandoverTriggered(MacNodeId nodeId);
     void removeUeHandoverTriggered(MacNodeId nodeId);
     void updateUeInfoCellId(MacNodeId nodeId, MacCellId cellId);
+
+    /*
+     * TTI driver
+     */
+    // true if TtiTimers must be ticked by the binder instead of their own self messages
+    bool isTtiDriverEnabled()
+    {
+        return strcmp(par("ttiClock").stringValue(), "driver") == 0;
+    }
+    // start ticking a recurring timer from the next TTI
+    void registerTtiTimer(TtiTimer* timer);
+    // tick a timer once, in the current TTI
+    void triggerTtiTimer(TtiTimer* timer);
+    // remove a timer, either recurring or triggered
+    void unregisterTtiTimer(TtiTimer* timer);
+
+    /*
+     * Parallel reception
+     */
+    // true if the receivers must defer the channel measurement of their airframes to the binder
+    bool isParallelReceptionEnabled()
+    {
+        return par("receptionThreads").intValue() > 0;
+    }
+    // measure the receptions of the given receiver in the measurement phase of the current TTI
+    void addReceptionTask(WorkerTask* task);
+    // withdraw a receiver (e.g. at its deletion)
+    void removeReceptionTask(WorkerTask* task);
+
+    /*
+     * Counter-based RNG
+     */
+    // seed of the LteCounterRng instances (parameter counterRngSeed, or the seed set of the run)
+    unsigned int getCounterRngSeed();
 };
 
 #endif
@@ -12,7 +12,7 @@
 #include "corenetwork/binder/PhyPisaData.h"
 #include "common/LteCommon.h"
 
-double blerCurvesNew[3][15][49]={
+static const double blerCurvesNew[3][15][49]={
         {
                 { 0.7208885924, 0.6364279834, 0.5332800360, 0.4360423440, 0.3666968777, 0.2702148823, 0.2545646762, 0.1872308878, 0.1517548369, 0.1063099811, 0.0748798778, 0.0606737487, 0.0532828620, 0.0387772788, 0.0293569902, 0.0226701188, 0.0184603938, 0.0142304934, 0.0120606390, 0.0082131224, 0.0063205729, 0.0046069027, 0.0037611803, 0.0031393568, 0.0026150711, 0.0017728079, 0.0015719911, 0.0009521393, 0.0009466133, 0.0008233501, 0.0006088240, 0.0004728737, 0.0003828146, 0.0003060003, 0.0002537224, 0.0002230114, 0.0002008010, 0.0001679888, 0.0001355403, 0.0001104041, 0.0000908001, 0.0000655503, 0.0000570788, 0.0000456929, 0.0000365713, 0.0000292649, 0.0000234136, 0.0000187286, 0.0000149782},
 
@@ -141,7 +141,7 @@ double blerCurves[3][8][46]={
         }
     };
 
-double lambdaTable[][3]={{1.597911858997, 0.710313546117, 2.249586633581}, {1.596637792198, 0.495826714440, 3.220152818918}, {1.919399495716, 0.432685156729, 4.436018813830}, {1.783436236411, 0.175433296494, 10.165893659026},
+static const double lambdaTable[][3]={{1.597911858997, 0.710313546117, 2.249586633581}, {1.596637792198, 0.495826714440, 3.220152818918}, {1.919399495716, 0.432685156729, 4.436018813830}, {1.783436236411, 0.175433296494, 10.165893659026},
         {1.601185653216, 0.663524990588, 2.413150485557}, {1.013635204668, 0.400976920537, 2.527914083707}, {3.433005091875, 0.640791622132, 5.357443782507}, {1.729162282384, 0.618298264805, 2.796647477133},
         {1.388369315840, 0.235029187439, 5.907220847614}, {2.321342872213, 0.645022737237, 3.598854332109}, {1.968126135269, 0.715414278598, 2.751029989400}, {2.168855708983, 0.692363418760, 3.132539429749},
         {1.871198920414, 0.446293573842, 4.192753447703}, {1.036764658035, 0.772901393001, 1.341393180841}, {1.470343928566, 0.506973491221, 2.900238284697}, {1.358735351867, 0.231040555268, 5.880938739480},
@@ -2644,9 +2644,10 @@ double lambdaTable[][3]={{1.597911858997, 0.710313546117, 2.249586633581}, {1.59
 
 PhyPisaData::PhyPisaData()
 {
-    // TODO Auto-generated constructor stub
-    memcpy(blerCurves_, blerCurvesNew, sizeof(double) * 3 * 15 * 49);
-    memcpy(lambdaTable_, lambdaTable, sizeof(double) * 10000 * 3);
+    // the tables are not copied: being read-only, they are shared by all the instances and,
+    // through the image of the library, by all the simulation processes on the same machine
+    blerCurves_ = blerCurvesNew;
+    lambdaTable_ = lambdaTable;
     channel_.resize(10000);
     double x, y;
     for (int i = 0; i < 1000; i++)
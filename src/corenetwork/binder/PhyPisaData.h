@@ -33,8 +33,8 @@ struct TbErrorStats_t
 
 class PhyPisaData
 {
-    double lambdaTable_[10000][3];
-    double blerCurves_[3][15][49];
+    const double (*lambdaTable_)[3];
+    const double (*blerCurves_)[15][49];
     std::vector<double> channel_;
     public:
     PhyPisaData();
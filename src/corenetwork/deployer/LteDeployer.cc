@@ -33,6 +33,8 @@ LteDeployer::LteDeployer()
 
 LteDeployer::~LteDeployer()
 {
+    if (binder_ != NULL && getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        binder_->removeNodeListener(this);
     binder_ = NULL;
     delete ruSet_;
 }
@@ -107,6 +109,7 @@ void LteDeployer::preInitialize()
 void LteDeployer::initialize()
 {
     preInitialize();
+    binder_->addNodeListener(this);
     return;
 }
 
@@ -354,6 +357,12 @@ void LteDeployer::detachUser(MacNodeId nodeId)
         lambdaMap_.erase(lt);
 }
 
+void LteDeployer::nodeLeft(MacNodeId nodeId)
+{
+    Enter_Method_Silent("nodeLeft");
+    detachUser(nodeId);
+}
+
 void LteDeployer::attachUser(MacNodeId nodeId)
 {
     // add UE to deployer's structures (lambda maps)
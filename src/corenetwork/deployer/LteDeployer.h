@@ -17,6 +17,7 @@
 #include "stack/phy/das/RemoteAntennaSet.h"
 #include "corenetwork/binder/LteBinder.h"
 #include "common/LteCommon.h"
+#include "common/LteNodeListener.h"
 
 class DasFilter;
 
@@ -31,7 +32,7 @@ class DasFilter;
  * Keeps general information about the cell
  */
 // TODO move all the parameters to their own modules
-class LteDeployer : public cSimpleModule
+class LteDeployer : public cSimpleModule, public LteNodeListener
 {
   private:
     /// reference to the global module binder
@@ -443,6 +444,12 @@ class LteDeployer : public cSimpleModule
     void detachUser(MacNodeId nodeId);
     void attachUser(MacNodeId nodeId);
 
+    /*
+     * called by the binder when a node leaves the simulation:
+     * drops its position and lambda/channel state
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
+
     ~LteDeployer();
 };
 
@@ -11,6 +11,20 @@
 
 Define_Module(ExtCell);
 
+ExtCell::ExtCell()
+{
+    ttiTick_ = NULL;
+    counterRng_ = NULL;
+    lazyBandStatus_ = false;
+    statusTti_ = 0;
+}
+
+ExtCell::~ExtCell()
+{
+    cancelAndDelete(ttiTick_);
+    delete counterRng_;
+}
+
 void ExtCell::initialize()
 {
     // get coord
@@ -83,11 +97,25 @@ void ExtCell::initialize()
             startingOffset_ = par("startingOffset");
         }
 
-        // TODO: if extCell-interference is disabled, do not send selfMessages
-        /* Start TTI tick */
-        ttiTick_ = new cMessage("ttiTick_");
-        ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
-        scheduleAt(NOW + TTI, ttiTick_);
+        // random allocations keyed by cell, band and TTI
+        if (par("counterRng").boolValue())
+            counterRng_ = new LteCounterRng(binder_->getCounterRngSeed());
+
+        lazyBandStatus_ = par("lazyBandStatus").boolValue();
+        if (lazyBandStatus_)
+        {
+            // the allocation of a TTI must not depend on when it is generated
+            if (allocationType_ == RANDOM_ALLOC && counterRng_ == NULL)
+                throw cRuntimeError("ExtCell::initialize - lazyBandStatus requires counterRng with RANDOM_ALLOC");
+        }
+        else
+        {
+            // TODO: if extCell-interference is disabled, do not send selfMessages
+            /* Start TTI tick */
+            ttiTick_ = new cMessage("ttiTick_");
+            ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
+            scheduleAt(NOW + TTI, ttiTick_);
+        }
     }
 
     // add this cell to the binder
@@ -115,29 +143,80 @@ void ExtCell::updateBandStatus()
     {
         EV << " ExtCell::updateBandStatus() - generating new random allocation for extCell " << id_ << endl;
 
-        // allocates each band with probability equal to bandUtilization_
-        for (int band = 0; band < numBands_; ++band)
+        if (counterRng_ != NULL)
         {
-            int occ = bernoulli(bandUtilization_);
-            bandStatus_[band] = occ;
+            // the allocation generated by the tick of TTI n is the one of TTI n
+            generateBandStatus(LteCounterRng::currentTti(), bandStatus_);
+        }
+        else
+        {
+            // allocates each band with probability equal to bandUtilization_
+            for (int band = 0; band < numBands_; ++band)
+            {
+                int occ = bernoulli(bandUtilization_);
+                bandStatus_[band] = occ;
+            }
         }
     }
     else    // CONTIGUOUS ALLOC
     {
         EV << " ExtCell::updateBandStatus() - generating new contiguous allocation for extCell " << id_ << endl;
 
+        generateBandStatus(LteCounterRng::currentTti(), bandStatus_);
+    }
+
+    EV << "----- END EXT CELL ALLOCATION UPDATE -----" << endl;
+}
+
+void ExtCell::generateBandStatus(long tti, BandStatus& status)
+{
+    status.assign(numBands_, 0);
+
+    // nothing is allocated before the first tick
+    if (tti <= 0)
+        return;
+
+    if (allocationType_ == RANDOM_ALLOC)
+    {
+        for (int band = 0; band < numBands_; ++band)
+            status[band] = counterRng_->uniform(LteRandomKey(id_, 0, band, tti, RANDOM_EXTCELL_ALLOCATION)) < bandUtilization_;
+    }
+    else    // CONTIGUOUS ALLOC
+    {
         // get the number of bands to be allocated
         int toAlloc = ceil( (double)numBands_ * bandUtilization_);
         int band = startingOffset_;
         int prev = band;
         for (; (band != startingOffset_ || band == prev) && toAlloc > 0; prev = band, band = (band+1)%numBands_)
         {
-            bandStatus_[band] = 1;
+            status[band] = 1;
             toAlloc--;
         }
     }
+}
 
-    EV << "----- END EXT CELL ALLOCATION UPDATE -----" << endl;
+long ExtCell::getStatusTti()
+{
+    // the tick of TTI n is scheduled after the other messages of that instant:
+    // until then, the allocation in force is still the one of TTI n-1
+    double tti = NOW.dbl() / TTI;
+    long n = (long) floor(tti + 0.5);
+    if (fabs(tti - n) < 1e-6)
+        return n - 1;
+    return (long) floor(tti);
+}
+
+void ExtCell::updateLazyBandStatus()
+{
+    long tti = getStatusTti();
+
+    if (tti == statusTti_ + 1)
+        prevBandStatus_.swap(bandStatus_);
+    else
+        generateBandStatus(tti - 1, prevBandStatus_);
+    generateBandStatus(tti, bandStatus_);
+
+    statusTti_ = tti;
 }
 
 void ExtCell::resetBandStatus()
@@ -149,6 +228,18 @@ void ExtCell::resetBandStatus()
     bandStatus_.resize(numBands_, 0);
 }
 
+double ExtCell::getMeanBandStatus(int band)
+{
+    if (allocationType_ == FULL_ALLOC)
+        return 1.0;
+    if (allocationType_ == RANDOM_ALLOC)
+        return bandUtilization_;
+
+    // the contiguous allocation is the same at every TTI
+    int allocated = std::min((int) ceil( (double)numBands_ * bandUtilization_), numBands_);
+    return ((band - startingOffset_ + numBands_) % numBands_) < allocated ? 1.0 : 0.0;
+}
+
 void ExtCell::setBandUtilization(double bandUtilization)
 {
     if (bandUtilization < 0)
@@ -157,4 +248,7 @@ void ExtCell::setBandUtilization(double bandUtilization)
         bandUtilization = 1;
 
     bandUtilization_ = bandUtilization;
+
+    // mean interference computed so far is no longer valid
+    binder_->updateExtCellVersion();
 }
@@ -13,6 +13,7 @@
 #include <omnetpp.h>
 #include "common/LteCommon.h"
 #include "corenetwork/binder/LteBinder.h"
+#include "common/LteCounterRng.h"
 
 typedef std::vector<int> BandStatus;
 
@@ -52,9 +53,18 @@ class ExtCell : public cSimpleModule
     BandStatus bandStatus_;
     BandStatus prevBandStatus_;
 
-    // TTI self message
+    // TTI self message (not used with lazy band status)
     cMessage* ttiTick_;
 
+    // if true, the band status is generated when queried, instead of at each TTI
+    bool lazyBandStatus_;
+
+    // counter-based RNG of the random allocation (NULL to use the module RNG)
+    LteCounterRng* counterRng_;
+
+    // TTI whose allocation is in bandStatus_ (lazy band status only)
+    long statusTti_;
+
     /*** ALLOCATION MANAGEMENT ***/
 
     // Allocation Type for this cell
@@ -72,6 +82,20 @@ class ExtCell : public cSimpleModule
 
     // move the current status in the prevBandStatus structure and reset the former
     void resetBandStatus();
+
+    // fill the status with the allocation of the given TTI (counter-based RNG only)
+    void generateBandStatus(long tti, BandStatus& status);
+
+    // TTI whose allocation is in force now
+    long getStatusTti();
+
+    // bring the current and previous band status up to date (lazy band status only)
+    void refreshBandStatus()
+    {
+        if (lazyBandStatus_ && statusTti_ != getStatusTti())
+            updateLazyBandStatus();
+    }
+    void updateLazyBandStatus();
     /*****************************/
 
   protected:
@@ -79,6 +103,8 @@ class ExtCell : public cSimpleModule
     virtual void handleMessage(cMessage *msg);
 
   public:
+    ExtCell();
+    virtual ~ExtCell();
 
     const inet::Coord getPosition() { return position_; }
 
@@ -90,13 +116,16 @@ class ExtCell : public cSimpleModule
 
     double getTxAngle() { return txAngle_; }
 
-    void setBlock(int band) { bandStatus_.at(band) = 1; }
+    void setBlock(int band) { refreshBandStatus(); bandStatus_.at(band) = 1; }
+
+    void unsetBlock(int band) { refreshBandStatus(); bandStatus_.at(band) = 0; }
 
-    void unsetBlock(int band) { bandStatus_.at(band) = 0; }
+    int getBandStatus(int band) { refreshBandStatus(); return bandStatus_.at(band); }
 
-    int getBandStatus(int band) { return bandStatus_.at(band); }
+    int getPrevBandStatus(int band) { refreshBandStatus(); return prevBandStatus_.at(band); }
 
-    int getPrevBandStatus(int band) { return prevBandStatus_.at(band); }
+    // mean occupation of a band over the TTIs
+    double getMeanBandStatus(int band);
 
     // set the band utilization percentage
     void setBandUtilization(double bandUtilization);
@@ -160,9 +160,11 @@ X2CompProportionalReplyIE* LteCompManagerProportional::buildCoordinatorReply(X2N
 void LteCompManagerProportional::handleClientRequest(X2CompMsg* compMsg)
 {
     X2NodeId sourceId = compMsg->getSourceId();
-    while (compMsg->hasIe())
+    const X2InformationElementsList& ieList = compMsg->getIeList();
+    X2InformationElementsList::const_iterator it = ieList.begin();
+    for (; it != ieList.end(); ++it)
     {
-        X2InformationElement* ie = compMsg->popIe();
+        X2InformationElement* ie = *it;
         if (ie->getType() != COMP_REQUEST_IE)
             throw cRuntimeError("LteCompManagerProportional::handleClientRequest - Expected COMP_REQUEST_IE");
 
@@ -174,16 +176,16 @@ void LteCompManagerProportional::handleClientRequest(X2CompMsg* compMsg)
             reqBlocksMap_.insert(std::pair<X2NodeId, unsigned int>(sourceId, reqBlocks));
         else
             reqBlocksMap_[sourceId] = reqBlocks;
-
-        delete requestIe;
     }
 }
 
 void LteCompManagerProportional::handleCoordinatorReply(X2CompMsg* compMsg)
 {
-    while (compMsg->hasIe())
+    const X2InformationElementsList& ieList = compMsg->getIeList();
+    X2InformationElementsList::const_iterator it = ieList.begin();
+    for (; it != ieList.end(); ++it)
     {
-        X2InformationElement* ie = compMsg->popIe();
+        X2InformationElement* ie = *it;
         if (ie->getType() != COMP_REPLY_IE)
             throw cRuntimeError(
                     "LteCompManagerProportional::handleCoordinatorReply - Expected COMP_REPLY_IE");
@@ -194,8 +196,6 @@ void LteCompManagerProportional::handleCoordinatorReply(X2CompMsg* compMsg)
         std::vector<CompRbStatus> allowedBlocksMap = replyIe->getAllowedBlocksMap();
         UsableBands usableBands = parseAllowedBlocksMap(allowedBlocksMap);
         setUsableBands(usableBands);
-
-        delete replyIe;
     }
 }
 
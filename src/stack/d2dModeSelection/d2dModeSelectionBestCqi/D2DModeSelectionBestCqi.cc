@@ -21,42 +21,57 @@ void D2DModeSelectionBestCqi::doModeSelection()
     EV << NOW << " D2DModeSelectionBestCqi::doModeSelection - Running Mode Selection algorithm..." << endl;
 
     switchList_.clear();
-    std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> >::iterator it = peeringModeMap_->begin();
-    for (; it != peeringModeMap_->end(); ++it)
+
+    // the flows of transmitters with new feedback must be evaluated again
+    std::set<MacNodeId> updated;
+    mac_->getAmc()->takeUpdatedFeedback(updated);
+    std::set<MacNodeId>::iterator ut = updated.begin();
+    for (; ut != updated.end(); ++ut)
+        evaluatedPeers_.erase(*ut);
+
+    // consider only flows within this cell
+    const D2DPairMap& pairs = binder_->getCellD2DPairs(mac_->getMacCellId());
+    D2DPairMap::const_iterator it = pairs.begin();
+    for (; it != pairs.end(); ++it)
     {
         MacNodeId srcId = it->first;
+        std::set<MacNodeId>& evaluated = evaluatedPeers_[srcId];
+        std::map<MacNodeId, LteD2DMode>& peeringModes = (*peeringModeMap_)[srcId];
 
-        // consider only UEs within this cell
-        if (binder_->getNextHop(srcId) != mac_->getMacCellId())
-            continue;
+        // since the D2D CQI is the same for all D2D connections, the mode will be the
+        // same for all destinations: compute it once
+        bool modeComputed = false;
+        LteD2DMode newMode = DM;
 
-        std::map<MacNodeId, LteD2DMode>::iterator jt = it->second.begin();
+        std::set<MacNodeId>::const_iterator jt = it->second.begin();
         for (; jt != it->second.end(); ++jt)
         {
-            MacNodeId dstId = jt->first;   // since the D2D CQI is the same for all D2D connections,
-                                            // the mode will be the same for all destinations
+            MacNodeId dstId = *jt;
 
-            // consider only UEs within this cell
-            if (binder_->getNextHop(dstId) != mac_->getMacCellId())
+            if (evaluated.find(dstId) != evaluated.end())
                 continue;
 
             // skip UEs that are performing handover
             if (binder_->hasUeHandoverTriggered(dstId) || binder_->hasUeHandoverTriggered(srcId))
                 continue;
 
-            LteD2DMode oldMode = jt->second;
-
-            // Compute the achievable bits on a single RB for UL direction
-            // Note that this operation takes into account the CQI returned by the AMC Pilot (by default, it
-            // is the minimum CQI over all RBs)
-            unsigned int bitsUl = mac_->getAmc()->computeBitsOnNRbs(srcId, 0, 0, 1, UL);
-            unsigned int bitsD2D = mac_->getAmc()->computeBitsOnNRbs(srcId, 0, 0, 1, D2D);
+            if (!modeComputed)
+            {
+                // Compute the achievable bits on a single RB for UL direction
+                // Note that this operation takes into account the CQI returned by the AMC Pilot (by default, it
+                // is the minimum CQI over all RBs)
+                unsigned int bitsUl = mac_->getAmc()->computeBitsOnNRbs(srcId, 0, 0, 1, UL);
+                unsigned int bitsD2D = mac_->getAmc()->computeBitsOnNRbs(srcId, 0, 0, 1, D2D);
 
-            EV << NOW << " D2DModeSelectionBestCqi::doModeSelection - bitsUl[" << bitsUl << "] bitsD2D[" << bitsD2D << "]" << endl;
+                EV << NOW << " D2DModeSelectionBestCqi::doModeSelection - bitsUl[" << bitsUl << "] bitsD2D[" << bitsD2D << "]" << endl;
 
-            // compare the bits in the two modes and select the best one
-            LteD2DMode newMode = (bitsUl > bitsD2D) ? IM : DM;
+                // compare the bits in the two modes and select the best one
+                newMode = (bitsUl > bitsD2D) ? IM : DM;
+                modeComputed = true;
+            }
+            evaluated.insert(dstId);
 
+            LteD2DMode oldMode = peeringModes[dstId];
             if (newMode != oldMode)
             {
                 // add this flow to the list of flows to be switched
@@ -68,7 +83,7 @@ void D2DModeSelectionBestCqi::doModeSelection()
                 switchList_.push_back(info);
 
                 // update peering map
-                jt->second = newMode;
+                peeringModes[dstId] = newMode;
 
                 EV << NOW << " D2DModeSelectionBestCqi::doModeSelection - Flow: " << srcId << " --> " << dstId << " [" << d2dModeToA(newMode) << "]" << endl;
             }
@@ -78,6 +93,12 @@ void D2DModeSelectionBestCqi::doModeSelection()
 
 void D2DModeSelectionBestCqi::doModeSwitchAtHandover(MacNodeId nodeId, bool handoverCompleted)
 {
+    // the flows of nodeId must be evaluated again at the next period
+    evaluatedPeers_.erase(nodeId);
+    std::map<MacNodeId, std::set<MacNodeId> >::iterator it = evaluatedPeers_.begin();
+    for (; it != evaluatedPeers_.end(); ++it)
+        it->second.erase(nodeId);
+
     // with this MS algorithm, connections of nodeId will return to DM after handover only
     // if the algorithm triggers the switch at the next period. Thus, it is not necessary to
     // force the switch here.
@@ -17,11 +17,17 @@
 //
 // For each D2D-capable flow, select the mode having the best CQI
 //
+// Only the flows within the cell are considered (see LteBinder::getCellD2DPairs()), and a flow
+// is evaluated again only when the UL or D2D feedback of its transmitter has been updated
+//
 class D2DModeSelectionBestCqi : public D2DModeSelectionBase
 {
 
 protected:
 
+    // for each transmitter, the receivers whose flow has been evaluated with the current feedback
+    std::map<MacNodeId, std::set<MacNodeId> > evaluatedPeers_;
+
     // run the mode selection algorithm
     virtual void doModeSelection();
 
@@ -62,10 +62,10 @@ void LteHandoverManager::handleX2Message(cPacket* pkt)
     else   // X2_HANDOVER_CONTROL_MSG
     {
         X2HandoverControlMsg* hoCommandMsg = check_and_cast<X2HandoverControlMsg*>(x2msg);
-        X2HandoverCommandIE* hoCommandIe = check_and_cast<X2HandoverCommandIE*>(hoCommandMsg->popIe());
+        if (!hoCommandMsg->hasIe())
+            throw cRuntimeError("LteHandoverManager::handleX2Message - handover command without IE");
+        X2HandoverCommandIE* hoCommandIe = check_and_cast<X2HandoverCommandIE*>(hoCommandMsg->getIeList().front());
         receiveHandoverCommand(hoCommandIe->getUeId(), hoCommandMsg->getSourceId(), hoCommandIe->isStartHandover());
-
-        delete hoCommandIe;
     }
 
     delete x2msg;
@@ -211,9 +211,14 @@ unsigned int LteAllocationModule::availableBlocks(const MacNodeId nodeId, const
     }
 }
 
-unsigned int LteAllocationModule::getAllocatedBlocks(Plane plane, const Remote antenna, const Band band)
+unsigned int LteAllocationModule::getAllocatedBlocks(Plane plane, const Remote antenna, const Band band) const
 {
-    return allocatedRbsPerBand_[plane][antenna][band].allocated_;
+    // lookup only: no entries are added to the allocation map of the TTI
+    const AllocatedRbsPerBandMap& bands = allocatedRbsPerBand_[plane][antenna];
+    AllocatedRbsPerBandMap::const_iterator it = bands.find(band);
+    if (it == bands.end())
+        return 0;
+    return it->second.allocated_;
 }
 
 unsigned int LteAllocationModule::getInterferringBlocks(Plane plane, const Remote antenna, const Band band)
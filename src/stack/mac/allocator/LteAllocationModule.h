@@ -233,9 +233,9 @@ class LteAllocationModule
     }
 
     /*
-     * Returns the amount of blocks allocated in a Band
+     * Returns the amount of blocks allocated in a Band (0 if nothing has been allocated in it)
      */
-    unsigned int getAllocatedBlocks(Plane plane, const Remote antenna, const Band band);
+    unsigned int getAllocatedBlocks(Plane plane, const Remote antenna, const Band band) const;
     unsigned int getInterferringBlocks(Plane plane, const Remote antenna, const Band band);
 
     unsigned int getBytes(const Remote antenna, const Band band, const MacNodeId nodeId)
@@ -0,0 +1,90 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/allocator/LteFreeRunIndex.h"
+#include <limits>
+
+static const Band MAX_BAND = std::numeric_limits<Band>::max();
+
+void LteFreeRunIndex::insert(Band first, unsigned int len)
+{
+    runs_[first] = len;
+    byLength_.insert(std::make_pair(len, first));
+}
+
+void LteFreeRunIndex::clear()
+{
+    runs_.clear();
+    byLength_.clear();
+}
+
+void LteFreeRunIndex::build(const std::vector<bool>& free, Band firstBand, Band lastBand)
+{
+    clear();
+
+    unsigned int len = 0;
+    for (unsigned int band = firstBand; band <= lastBand; band++)
+    {
+        if (band < free.size() && free[band])
+        {
+            len++;
+            continue;
+        }
+        if (len > 0)
+            insert(band - len, len);
+        len = 0;
+    }
+    if (len > 0)
+        insert(lastBand + 1 - len, len);
+}
+
+void LteFreeRunIndex::book(Band band)
+{
+    // run starting at or before the band
+    std::map<Band, unsigned int>::iterator it = runs_.upper_bound(band);
+    if (it == runs_.begin())
+        return;
+    --it;
+
+    Band first = it->first;
+    unsigned int len = it->second;
+    if (band >= first + len)
+        return;
+
+    byLength_.erase(std::make_pair(len, first));
+    runs_.erase(it);
+
+    // split the run around the band
+    if (band > first)
+        insert(first, band - first);
+    if (band + 1u < first + len)
+        insert(band + 1, first + len - band - 1);
+}
+
+bool LteFreeRunIndex::bestFit(unsigned int req, bool fromTop, Band& index, unsigned int& len) const
+{
+    if (byLength_.empty())
+        return false;
+
+    std::set<std::pair<unsigned int, Band> >::const_iterator it = byLength_.upper_bound(std::make_pair(req, MAX_BAND));
+    len = (it != byLength_.end()) ? it->first : byLength_.rbegin()->first;
+
+    if (fromTop)
+    {
+        it = byLength_.upper_bound(std::make_pair(len, MAX_BAND));
+        --it;
+        index = it->second + len - 1;
+    }
+    else
+    {
+        it = byLength_.lower_bound(std::make_pair(len, (Band) 0));
+        index = it->second;
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTEFREERUNINDEX_H_
+#define _LTE_LTEFREERUNINDEX_H_
+
+#include "common/LteCommon.h"
+
+/**
+ * Runs of contiguous free bands, indexed both by first band and by length.
+ *
+ * Booking a band splits the run containing it, and the best-fit run for a
+ * request is found without scanning the bands, both in O(log n).
+ */
+class LteFreeRunIndex
+{
+    // length of each run, by first band
+    std::map<Band, unsigned int> runs_;
+
+    // <length, first band> of each run
+    std::set<std::pair<unsigned int, Band> > byLength_;
+
+    void insert(Band first, unsigned int len);
+
+  public:
+
+    void clear();
+
+    bool empty() const
+    {
+        return runs_.empty();
+    }
+
+    /*
+     * Set the free bands, from firstBand to lastBand (included).
+     * free[b] tells whether band b is free
+     */
+    void build(const std::vector<bool>& free, Band firstBand, Band lastBand);
+
+    // mark the given band as no longer free
+    void book(Band band);
+
+    /*
+     * Find the best-fit run for a request of req bands: the shortest run longer than req, or the
+     * longest run if none is. Among runs of the same length, the lowest one is chosen, or the
+     * highest one if fromTop is true.
+     * index is set to the first band of the run, or to its last band if fromTop is true.
+     * Returns false if no band is free.
+     */
+    bool bestFit(unsigned int req, bool fromTop, Band& index, unsigned int& len) const;
+};
+
+#endif
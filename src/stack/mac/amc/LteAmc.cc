@@ -7,6 +7,7 @@
 // and cannot be removed from it.
 //
 
+#include <algorithm>
 #include "stack/mac/amc/LteAmc.h"
 #include "stack/mac/layer/LteMacEnb.h"
 #include "stack/mac/layer/LteMacVUeMode4.h"
@@ -252,6 +253,10 @@ void LteAmc::initialize()
     ulMcsTable_.rescale(mcsScaleUl_);
     d2dMcsTable_.rescale(mcsScaleD2D_);
 
+    // TBS lookup tables (D2D uses the UL ones)
+    buildTbsTables(DL);
+    buildTbsTables(UL);
+
     // Initialize DAS structures
     for (int i = 0; i < numAntennas_; i++)
     {
@@ -363,10 +368,12 @@ void LteAmc::rescaleMcs(double rePerRb, Direction dir)
     if (dir == DL)
     {
         dlMcsTable_.rescale(rePerRb);
+        buildTbsTables(DL);
     }
     else if (dir == UL)
     {
         ulMcsTable_.rescale(rePerRb);
+        buildTbsTables(UL);
     }
     else if (dir == D2D) {
         d2dMcsTable_.rescale(rePerRb);
@@ -377,7 +384,7 @@ void LteAmc::rescaleMcs(double rePerRb, Direction dir)
  *    Functions for feedback management    *
  *******************************************/
 
-void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb)
+void LteAmc::pushFeedback(MacNodeId id, Direction dir, const LteFeedback& fb)
 {
     EV << "Feedback from MacNodeId " << id << " (direction " << dirToA(dir) << ")" << endl;
 
@@ -411,6 +418,8 @@ void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb)
     EV << "ID: " << id << endl;
     EV << "index: " << index << endl;
     (*history)[antenna].at(index).at(txMode).put(fb);
+    if (dir == UL)
+        updatedFeedback_.insert(id);
 
     // DEBUG
 //    printFbhb(dir);
@@ -421,36 +430,31 @@ void LteAmc::pushFeedback(MacNodeId id, Direction dir, LteFeedback fb)
 //    (*history)[antenna].at(index).at(txMode).get().print(0,id,dir,txMode,"LteAmc::pushFeedback");
 }
 
-void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId)
+LteSummaryBuffer& LteAmc::getFeedbackBufferD2D(MacNodeId peerId, Remote antenna, unsigned int index, TxMode txMode)
 {
-    EV << "Feedback from MacNodeId " << id << " (direction D2D), peerId = " << peerId << endl;
+    // the history of a peer only holds the UEs that reported (or were asked) a feedback about it
+    std::vector<std::vector<LteSummaryBuffer> >& ues = d2dFeedbackHistory_[peerId][antenna];
+    if (ues.size() <= index)
+        ues.resize(index + 1);
+    if (ues[index].empty())
+        ues[index].resize(UL_NUM_TXMODE, LteSummaryBuffer(fbhbCapacityD2D_, MAXCW, numBands_, lb_, ub_));
+    return ues[index].at(txMode);
+}
 
-    std::map<MacNodeId, History_> *history = &d2dFeedbackHistory_;
-    std::map<MacNodeId, unsigned int> *nodeIndex = &d2dNodeIndex_;
+void LteAmc::pushFeedbackD2D(MacNodeId id, const LteFeedback& fb, MacNodeId peerId)
+{
+    EV << "Feedback from MacNodeId " << id << " (direction D2D), peerId = " << peerId << endl;
 
     // Put the feedback in the FBHB
     Remote antenna = fb.getAntennaId();
     TxMode txMode = fb.getTxMode();
-    int index = (*nodeIndex).at(id);
+    int index = d2dNodeIndex_.at(id);
 
     EV << "ID: " << id << endl;
     EV << "index: " << index << endl;
 
-    if (history->find(peerId) == history->end())
-    {
-        // initialize new history for this peering UE
-        History_ newHist;
-
-        ConnectedUesMap::const_iterator it, et;
-        it = d2dConnectedUe_.begin();
-        et = d2dConnectedUe_.end();
-        for (; it != et; it++)  // For all UEs (D2D)
-        {
-            newHist[antenna].push_back(std::vector<LteSummaryBuffer>(UL_NUM_TXMODE, LteSummaryBuffer(fbhbCapacityD2D_, MAXCW, numBands_, lb_, ub_)));
-        }
-        (*history)[peerId] = newHist;
-    }
-    (*history)[peerId][antenna].at(index).at(txMode).put(fb);
+    getFeedbackBufferD2D(peerId, antenna, index, txMode).put(fb);
+    updatedFeedback_.insert(id);
 
     // DEBUG
     EV << "PeerId: " << peerId << ", Antenna: " << dasToA(antenna) << ", TxMode: " << txMode << ", Index: " << index << endl;
@@ -459,7 +463,7 @@ void LteAmc::pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId)
 }
 
 
-LteSummaryFeedback LteAmc::getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir)
+const LteSummaryFeedback& LteAmc::getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir)
 {
     MacNodeId nh = getNextHop(id);
     if (id != nh)
@@ -476,7 +480,7 @@ LteSummaryFeedback LteAmc::getFeedback(MacNodeId id, Remote antenna, TxMode txMo
     }
 }
 
-LteSummaryFeedback LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId)
+const LteSummaryFeedback& LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId)
 {
     MacNodeId nh = getNextHop(id);
 
@@ -500,7 +504,7 @@ LteSummaryFeedback LteAmc::getFeedbackD2D(MacNodeId id, Remote antenna, TxMode t
             }
         }
     }
-    return d2dFeedbackHistory_.at(peerId).at(antenna).at(d2dNodeIndex_.at(id)).at(txMode).get();
+    return getFeedbackBufferD2D(peerId, antenna, d2dNodeIndex_.at(id), txMode).get();
 }
 
 /*******************************************
@@ -655,27 +659,16 @@ unsigned int LteAmc::computeReqRbs(MacNodeId id, Band b, Codeword cw, unsigned i
         return 0;
     }
 
-    // Loading TBS vectors
-    const unsigned int* tbsVect;// it is a row of the itbs matrix
-    UserTxParams info = computeTxParams(id, dir);
-    unsigned char layers = info.getLayers().at(cw);
-
-    LteMod mod = info.getCwModulation(cw);
-    unsigned int iTbs = getItbsPerCqi(info.readCqiVector().at(cw), dir);
-    unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
-    tbsVect = itbs2tbs(mod, info.readTxMode(), layers, iTbs-i);
+    const UserTxParams& info = computeTxParams(id, dir);
 
     // Computing RB occupation
-    unsigned int j;
-    for(j = 0; j < 110; ++j)
-    if(tbsVect[j] >= bytes*8)
-    break;
+    unsigned int blocks = getReqRbs(info.readCqiVector().at(cw), info.readTxMode(), info.getLayers().at(cw), bytes, dir);
 
     // DEBUG
     EV << NOW << " LteAmc::getRbs Occupation: " << bytes << " bytes , CQI : " << info.readCqiVector().at(cw) << " \n";
-    EV << NOW << " LteAmc::getRbs Number of RBs: " << j+1 << "\n";
+    EV << NOW << " LteAmc::getRbs Number of RBs: " << blocks << "\n";
 
-    return j+1;
+    return blocks;
 }
 
 unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks, const Direction dir)
@@ -692,9 +685,9 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks
     EV << NOW << " LteAmc::blocks2bits Direction: " << dirToA(dir) << "\n";
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir);
+    const UserTxParams& info = computeTxParams(id, dir);
 
-    std::vector<unsigned char> layers = info.getLayers();
+    const std::vector<unsigned char>& layers = info.getLayers();
 
     unsigned int bits = 0;
     unsigned int codewords = layers.size();
@@ -720,8 +713,7 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, unsigned int blocks
 
         mac_->emitItbs(iTbs);
 
-        const unsigned int* tbsVect = itbs2tbs(mod, info.readTxMode(), layers.at(cw), iTbs-i);
-        bits += tbsVect[blocks-1];
+        bits += readTbsVect(info.readCqiVector().at(cw), info.readTxMode(), layers.at(cw), dir)[blocks - 1];
     }
 
             // DEBUG
@@ -746,7 +738,7 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsign
     EV << NOW << " LteAmc::blocks2bits Direction: " << dirToA(dir) << "\n";
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir);
+    const UserTxParams& info = computeTxParams(id, dir);
 
     // if CQI == 0 the UE is out of range, thus return 0
     if (info.readCqiVector().at(cw) == 0)
@@ -765,7 +757,7 @@ unsigned int LteAmc::computeBitsOnNRbs(MacNodeId id, Band b, Codeword cw, unsign
     EV << NOW << " LteAmc::blocks2bits iTbs: " << iTbs << "\n";
     EV << NOW << " LteAmc::blocks2bits i: " << i << "\n";
 
-    const unsigned int* tbsVect = itbs2tbs(mod, info.readTxMode(), layers, iTbs - i);
+    const unsigned int* tbsVect = readTbsVect(info.readCqiVector().at(cw), info.readTxMode(), layers, dir);
 
     // DEBUG
     EV << NOW << " LteAmc::blocks2bits Resource Blocks: " << blocks << "\n";
@@ -836,9 +828,9 @@ unsigned int LteAmc::computeBitsOnNRbs_MB(MacNodeId id, Band b,  unsigned int bl
     Cqi cqi = readMultiBandCqi(id,dir)[b];
 
     // Acquiring current user scheduling information
-    UserTxParams info = computeTxParams(id, dir);
+    const UserTxParams& info = computeTxParams(id, dir);
 
-    std::vector<unsigned char> layers = info.getLayers();
+    const std::vector<unsigned char>& layers = info.getLayers();
 
     // if CQI == 0 the UE is out of range, thus return 0
     if (cqi == 0)
@@ -856,7 +848,7 @@ unsigned int LteAmc::computeBitsOnNRbs_MB(MacNodeId id, Band b,  unsigned int bl
     EV << NOW << " LteAmc::computeBitsOnNRbs_MB iTbs: " << iTbs << "\n";
     EV << NOW << " LteAmc::computeBitsOnNRbs_MB i: " << i << "\n";
 
-    const unsigned int* tbsVect = itbs2tbs(mod, TRANSMIT_DIVERSITY, layers[0], iTbs - i);
+    const unsigned int* tbsVect = readTbsVect(cqi, TRANSMIT_DIVERSITY, layers[0], dir);
 
     // DEBUG
     EV << NOW << " LteAmc::computeBitsOnNRbs_MB Resource Blocks: " << blocks << "\n";
@@ -879,16 +871,18 @@ std::vector<unsigned short>* LteAmc::getPilotUsableBands(MacNodeId id)
 
 unsigned int LteAmc::getItbsPerCqi(Cqi cqi, const Direction dir)
 {
-    // CQI threshold table selection
-    McsTable* mcsTable;
     if (dir == DL)
-        mcsTable = &dlMcsTable_;
+        return itbsPerCqi_[0][cqi];
     else if ((dir == UL) || (dir == D2D) || (dir == D2D_MULTI))
-        mcsTable = &ulMcsTable_;
+        return itbsPerCqi_[1][cqi];
     else
     {
         throw cRuntimeError("LteAmc::getItbsPerCqi(): Unrecognized direction");
     }
+}
+
+unsigned int LteAmc::computeItbsPerCqi(Cqi cqi, McsTable* mcsTable)
+{
     CQIelem entry = cqiTable[cqi];
     LteMod mod = entry.mod_;
     double rate = entry.rate_;
@@ -926,6 +920,52 @@ unsigned int LteAmc::getItbsPerCqi(Cqi cqi, const Direction dir)
     return iTbs;
 }
 
+void LteAmc::buildTbsTables(Direction dir)
+{
+    int d = (dir == DL) ? 0 : 1;
+    McsTable* mcsTable = (dir == DL) ? &dlMcsTable_ : &ulMcsTable_;
+
+    for (Cqi cqi = 0; cqi <= MAXCQI; ++cqi)
+    {
+        unsigned int iTbs = computeItbsPerCqi(cqi, mcsTable);
+        itbsPerCqi_[d][cqi] = iTbs;
+
+        LteMod mod = cqiTable[cqi].mod_;
+        unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
+        for (int l = 0; l < 4; ++l)
+        {
+            // 1, 2 and 4 layers, 8 layers only with QPSK
+            const unsigned int* tbsVect = NULL;
+            if (l < 3)
+                tbsVect = itbs2tbs(mod, OL_SPATIAL_MULTIPLEXING, 1 << l, iTbs - i);
+            else if (mod == _QPSK)
+                tbsVect = itbs2tbs_qpsk_8[iTbs];
+            tbsRows_[d][cqi][l] = tbsVect;
+
+            // the TBS is not always increasing with the number of blocks
+            unsigned int max = 0;
+            for (unsigned int j = 0; j < 110; ++j)
+            {
+                if (tbsVect != NULL && tbsVect[j] > max)
+                    max = tbsVect[j];
+                maxTbsRows_[d][cqi][l][j] = max;
+            }
+        }
+    }
+}
+
+int LteAmc::tbsLayerIndex(TxMode txMode, unsigned int layers)
+{
+    // only spatial multiplexing uses more than one layer (see itbs2tbs())
+    if (layers == 1 || (txMode != OL_SPATIAL_MULTIPLEXING && txMode != CL_SPATIAL_MULTIPLEXING))
+        return 0;
+    if (layers == 2)
+        return 1;
+    if (layers == 4)
+        return 2;
+    throw cRuntimeError("LteAmc::tbsLayerIndex(): no TBS table for %d layers", layers);
+}
+
 unsigned int LteAmc::getCqiForMcs(unsigned int mcsIndex, const Direction dir)
 {
     // CQI threshold table selection
@@ -1081,81 +1121,44 @@ LteAmc::bytesGain(Cqi cqi, unsigned int layers, unsigned int bytes, Direction di
     if (tbsVect == 0)
         return 0;
 
-    unsigned int i = 0;
-    for (; i < 110; ++i)
-    {
-        if (tbsVect[i] >= (bytes * 8))
-            break;
-    }
-    return i + 1;
+    // first block count whose running maximum reaches the bits, i.e. the first one whose TBS does
+    int d = (dir == DL) ? 0 : 1;
+    int l = (layers == 1) ? 0 : ((layers == 2) ? 1 : ((layers == 4) ? 2 : 3));
+    const unsigned int* maxTbsVect = maxTbsRows_[d][cqi][l];
+    return std::lower_bound(maxTbsVect, maxTbsVect + 110, bytes * 8) - maxTbsVect + 1;
 }
 
 const unsigned int*
 LteAmc::readTbsVect(Cqi cqi, unsigned int layers, Direction dir)
 {
-    unsigned int itbs = getItbsPerCqi(cqi, dir);
-    LteMod mod = cqiTable[cqi].mod_;
+    int d = (dir == DL) ? 0 : 1;
+    switch (layers)
+    {
+        case 1:
+            return tbsRows_[d][cqi][0];
+        case 2:
+            return tbsRows_[d][cqi][1];
+        case 4:
+            return tbsRows_[d][cqi][2];
+        case 8:
+            return tbsRows_[d][cqi][3];
+    }
+    return NULL;
+}
 
-    const unsigned int* tbsVect = NULL;
-    switch (mod)
-    {
-        case _QPSK:
-            {
-            switch (layers)
-            {
-                case 1:
-                    tbsVect = itbs2tbs_qpsk_1[itbs];
-                    break;
-                case 2:
-                    tbsVect = itbs2tbs_qpsk_2[itbs];
-                    break;
-                case 4:
-                    tbsVect = itbs2tbs_qpsk_4[itbs];
-                    break;
-                case 8:
-                    tbsVect = itbs2tbs_qpsk_8[itbs];
-                    break;
-            }
-            break;
-        }
-        case _16QAM:
-            {
-            switch (layers)
-            {
-                case 1:
-                    tbsVect = itbs2tbs_16qam_1[itbs - 9];
-                    break;
-                case 2:
-                    tbsVect = itbs2tbs_16qam_2[itbs - 9];
-                    break;
-                case 4:
-                    tbsVect = itbs2tbs_16qam_4[itbs - 9];
-                    break;
-//                    case 8:
-//                        tbsVect = itbs2tbs_16qam_8[itbs]; break;
-            }
-            break;
-        }
-        case _64QAM:
-            {
-            switch (layers)
-            {
-                case 1:
-                    tbsVect = itbs2tbs_64qam_1[itbs - 15];
-                    break;
-                case 2:
-                    tbsVect = itbs2tbs_64qam_2[itbs - 15];
-                    break;
-                case 4:
-                    tbsVect = itbs2tbs_64qam_4[itbs - 15];
-                    break;
-//                    case 8:
-//                        tbsVect = itbs2tbs_64qam_8[itbs]; break;
-            }
-            break;
-        }
-    }
-    return tbsVect;
+const unsigned int*
+LteAmc::readTbsVect(Cqi cqi, TxMode txMode, unsigned int layers, Direction dir)
+{
+    return tbsRows_[(dir == DL) ? 0 : 1][cqi][tbsLayerIndex(txMode, layers)];
+}
+
+unsigned int
+LteAmc::getReqRbs(Cqi cqi, TxMode txMode, unsigned int layers, unsigned int bytes, Direction dir)
+{
+    if (bytes == 0)
+        return 0;
+    const unsigned int* maxTbsVect = maxTbsRows_[(dir == DL) ? 0 : 1][cqi][tbsLayerIndex(txMode, layers)];
+    return std::lower_bound(maxTbsVect, maxTbsVect + 110, bytes * 8) - maxTbsVect + 1;
 }
 
 /*************************************************
@@ -1376,11 +1379,12 @@ void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
                     continue;
 
                 history = &(ht->second);
-                RemoteSet::iterator it = remoteSet_.begin();
-                RemoteSet::iterator et = remoteSet_.end();
+                History_::iterator it = history->begin();
+                History_::iterator et = history->end();
                 for(; it!=et; it++ )
                 {
-                    (*history).at(*it).at(nodeIndex).clear();
+                    if (nodeIndex < it->second.size())
+                        it->second.at(nodeIndex).clear();
                 }
             }
         }
@@ -1393,6 +1397,22 @@ void LteAmc::detachUser(MacNodeId nodeId, Direction dir)
     }
 }
 
+void LteAmc::removeUser(MacNodeId nodeId)
+{
+    ConnectedUesMap::iterator it = dlConnectedUe_.find(nodeId);
+    if (it != dlConnectedUe_.end() && it->second)
+        detachUser(nodeId, DL);
+    it = ulConnectedUe_.find(nodeId);
+    if (it != ulConnectedUe_.end() && it->second)
+        detachUser(nodeId, UL);
+    it = d2dConnectedUe_.find(nodeId);
+    if (it != d2dConnectedUe_.end() && it->second)
+        detachUser(nodeId, D2D);
+
+    // feedback of the other UEs about the node, rebuilt on demand if the id is recycled
+    d2dFeedbackHistory_.erase(nodeId);
+}
+
 void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
 {
     EV << "##################################" << endl;
@@ -1471,18 +1491,17 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
         }
         else // D2D
         {
+            // drop the old feedback, new buffers are allocated on the next access
             std::map<MacNodeId, History_>::iterator ht = d2dHistory->begin();
             for (; ht != d2dHistory->end(); ++ht)
             {
-                if (ht->first == 0)  // skip fake UE 0
-                    continue;
-
                 history = &(ht->second);
-                RemoteSet::iterator it = remoteSet_.begin();
-                RemoteSet::iterator et = remoteSet_.end();
+                History_::iterator it = history->begin();
+                History_::iterator et = history->end();
                 for(; it!=et; it++ )
                 {
-                    (*history)[*it].at(nodeIndex) = v;
+                    if (nodeIndex < it->second.size())
+                        it->second.at(nodeIndex).clear();
                 }
             }
         }
@@ -1507,24 +1526,7 @@ void LteAmc::attachUser(MacNodeId nodeId, Direction dir)
                 (*history)[*it].push_back(v); // XXX DEBUG THIS!!
             }
         }
-        else // D2D
-        {
-            // initialize an empty feedback for a fake user (id 0), in order to manage
-            // the case of transmission before a feedback has been reported
-            History_ hist;
-            (*d2dHistory)[0] = hist;
-            std::map<MacNodeId, History_>::iterator ht =  d2dHistory->begin();
-            for (; ht != d2dHistory->end(); ++ht)
-            {
-                history = &(ht->second);
-                RemoteSet::iterator it = remoteSet_.begin();
-                RemoteSet::iterator et = remoteSet_.end();
-                for(; it!=et; it++ )
-                {
-                    (*history)[*it].push_back(v); // XXX DEBUG THIS!!
-                }
-            }
-        }
+        // D2D: feedback buffers are allocated on the first access, see getFeedbackBufferD2D()
     }
     // Operation done in any case: use [] because new elements may be created
     (*connectedUe)[nodeId] = true;
@@ -1621,16 +1623,17 @@ void LteAmc::testUe(MacNodeId nodeId, Direction dir)
         for (; ht != d2dHistory->end(); ++ht)
         {
             history = &(ht->second);
-            RemoteSet::iterator it = remoteSet_.begin();
-            RemoteSet::iterator et = remoteSet_.end();
-            std::vector<LteSummaryBuffer> feedback;
+            History_::iterator it = history->begin();
+            History_::iterator et = history->end();
 
             EV << "History" << endl;
             for(; it!=et; it++ )
             {
-                EV << "Remote: " << dasToA(*it) << endl;
-                feedback = (*history).at(*it).at(nodeIndex);
-                for(int i=0; i<numTxModes; i++)
+                EV << "Remote: " << dasToA(it->first) << endl;
+                if (nodeIndex >= it->second.size())
+                    continue;
+                const std::vector<LteSummaryBuffer>& feedback = it->second.at(nodeIndex);
+                for(int i=0; i<(int)feedback.size(); i++)
                 {
                     // Print only non empty feedback summary! (all cqi are != NOSIGNALCQI)
                     Cqi testCqi = (feedback.at(i).get()).getCqi(Codeword(0),Band(0));
@@ -54,6 +54,12 @@ class LteAmc
     McsTable dlMcsTable_;
     McsTable ulMcsTable_;
     McsTable d2dMcsTable_;
+    // iTbs of each CQI, for DL and UL (see buildTbsTables())
+    unsigned int itbsPerCqi_[2][MAXCQI + 1];
+    // itbs2tbs row of each CQI for 1, 2, 4 and 8 layers (NULL if none), for DL and UL
+    const unsigned int* tbsRows_[2][MAXCQI + 1][4];
+    // running maximum over the number of blocks of the above rows, for the inverse lookups
+    unsigned int maxTbsRows_[2][MAXCQI + 1][4][110];
     double mcsScaleDl_;
     double mcsScaleUl_;
     double mcsScaleD2D_;
@@ -78,6 +84,8 @@ class LteAmc
     History_ dlFeedbackHistory_;
     History_ ulFeedbackHistory_;
     std::map<MacNodeId, History_> d2dFeedbackHistory_;
+    // UEs whose UL or D2D feedback has been updated since the last call of takeUpdatedFeedback()
+    std::set<MacNodeId> updatedFeedback_;
     unsigned int fbhbCapacityDl_;
     unsigned int fbhbCapacityUl_;
     unsigned int fbhbCapacityD2D_;
@@ -88,6 +96,9 @@ class LteAmc
     LteMuMimoMatrix muMimoDlMatrix_;
     LteMuMimoMatrix muMimoUlMatrix_;
     LteMuMimoMatrix muMimoD2DMatrix_;
+
+    // D2D feedback buffer of a UE about a peer, allocated on first access
+    LteSummaryBuffer& getFeedbackBufferD2D(MacNodeId peerId, Remote antenna, unsigned int index, TxMode txMode);
     public:
     LteAmc(LteMacBase *mac, LteBinder *binder, LteDeployer *deployer, int numAntennas);
     void initialize();
@@ -104,10 +115,17 @@ class LteAmc
     // CodeRate MCS rescaling
     void rescaleMcs(double rePerRb, Direction dir = DL);
 
-    void pushFeedback(MacNodeId id, Direction dir, LteFeedback fb);
-    void pushFeedbackD2D(MacNodeId id, LteFeedback fb, MacNodeId peerId);
-    LteSummaryFeedback getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir);
-    LteSummaryFeedback getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId);
+    void pushFeedback(MacNodeId id, Direction dir, const LteFeedback& fb);
+    void pushFeedbackD2D(MacNodeId id, const LteFeedback& fb, MacNodeId peerId);
+    const LteSummaryFeedback& getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir);
+    const LteSummaryFeedback& getFeedbackD2D(MacNodeId id, Remote antenna, TxMode txMode, MacNodeId peerId);
+
+    // move into ues the UEs whose UL or D2D feedback has been updated since the previous call
+    void takeUpdatedFeedback(std::set<MacNodeId>& ues)
+    {
+        ues.clear();
+        ues.swap(updatedFeedback_);
+    }
 
     //used when is necessary to know if the requested feedback exists or not
     // LteSummaryFeedback getFeedback(MacNodeId id, Remote antenna, TxMode txMode, const Direction dir,bool& valid);
@@ -125,6 +143,11 @@ class LteAmc
     }
 
 
+    // fill the TBS tables of the given direction from its McsTable
+    void buildTbsTables(Direction dir);
+    unsigned int computeItbsPerCqi(Cqi cqi, McsTable* mcsTable);
+    // index of the TBS tables of a row used with the given txmode and number of layers
+    int tbsLayerIndex(TxMode txMode, unsigned int layers);
     bool existTxParams(MacNodeId id, const Direction dir);
     const UserTxParams & getTxParams(MacNodeId id, const Direction dir);
     const UserTxParams & setTxParams(MacNodeId id, const Direction dir, UserTxParams & info);
@@ -154,6 +177,15 @@ class LteAmc
      */
     const unsigned int* readTbsVect(Cqi cqi, unsigned int layers, Direction dir);
 
+    /*
+     * TBS lookups on the tables precomputed per CQI: readTbsVect() is O(1), getReqRbs() a binary search.
+     * As in itbs2tbs(), the number of layers is only considered with spatial multiplexing.
+     */
+    const unsigned int* readTbsVect(Cqi cqi, TxMode txMode, unsigned int layers, Direction dir);
+
+    // minimum number of blocks carrying <bytes>, 111 if 110 blocks are not enough
+    unsigned int getReqRbs(Cqi cqi, TxMode txMode, unsigned int layers, unsigned int bytes, Direction dir);
+
     /*
      * given <cqi> and <layers> returns bytes allocable in <blocks>
      */
@@ -171,6 +203,12 @@ class LteAmc
     Pmi readWbPmi(const PmiVector & pmi);
     void detachUser(MacNodeId nodeId, Direction dir);
     void attachUser(MacNodeId nodeId, Direction dir);
+
+    /*
+     * drops the state of a node leaving the simulation: detaches it in each direction
+     * it is attached and removes the D2D feedback about it, so that its id can be recycled
+     */
+    void removeUser(MacNodeId nodeId);
     void testUe(MacNodeId nodeId, Direction dir);
     AmcPilot *getPilot() const
     {
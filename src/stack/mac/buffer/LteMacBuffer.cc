@@ -9,12 +9,17 @@
 
 #include "stack/mac/buffer/LteMacBuffer.h"
 
+// initial size of the ring
+static const unsigned int MIN_RING_SIZE = 4;
+// rings larger than this are released when the buffer gets empty
+static const unsigned int MAX_IDLE_RING_SIZE = 64;
+
 LteMacBuffer::LteMacBuffer()
 {
     queueOccupancy_ = 0;
     queueLength_ = 0;
     processed_ = 0;
-    Queue_.clear();
+    head_ = 0;
 }
 
 LteMacBuffer::LteMacBuffer(const LteMacQueue& queue)
@@ -24,14 +29,14 @@ LteMacBuffer::LteMacBuffer(const LteMacQueue& queue)
 
 LteMacBuffer::~LteMacBuffer()
 {
-    Queue_.clear();
 }
 
 LteMacBuffer& LteMacBuffer::operator=(const LteMacBuffer& queue)
 {
     queueOccupancy_ = queue.queueOccupancy_;
     queueLength_ = queue.queueLength_;
-    Queue_ = queue.Queue_;
+    ring_ = queue.ring_;
+    head_ = queue.head_;
     return *this;
 }
 
@@ -40,18 +45,43 @@ LteMacBuffer* LteMacBuffer::dup() const
     return new LteMacBuffer(*this);
 }
 
+void LteMacBuffer::grow()
+{
+    if ((unsigned int) queueLength_ < ring_.size())
+        return;
+
+    // unroll the ring into a larger one
+    std::vector<PacketInfo> ring(ring_.empty() ? MIN_RING_SIZE : 2 * ring_.size());
+    for (int i = 0; i < queueLength_; i++)
+        ring[i] = ring_[slot(i)];
+    ring_.swap(ring);
+    head_ = 0;
+}
+
+void LteMacBuffer::release()
+{
+    if (queueLength_ == 0 && ring_.size() > MAX_IDLE_RING_SIZE)
+    {
+        std::vector<PacketInfo>().swap(ring_);
+        head_ = 0;
+    }
+}
+
 void LteMacBuffer::pushBack(PacketInfo pkt)
 {
+    grow();
+    ring_[slot(queueLength_)] = pkt;
     queueLength_++;
     queueOccupancy_ += pkt.first;
-    Queue_.push_back(pkt);
 }
 
 void LteMacBuffer::pushFront(PacketInfo pkt)
 {
+    grow();
+    head_ = slot(ring_.size() - 1);
+    ring_[head_] = pkt;
     queueLength_++;
     queueOccupancy_ += pkt.first;
-    Queue_.push_front(pkt);
 }
 
 PacketInfo LteMacBuffer::popFront()
@@ -59,11 +89,12 @@ PacketInfo LteMacBuffer::popFront()
     if (queueLength_ <= 0)
         throw cRuntimeError("Packet queue empty");
 
-    PacketInfo pkt = Queue_.front();
-    Queue_.pop_front();
+    PacketInfo pkt = ring_[head_];
+    head_ = slot(1);
     processed_++;
     queueLength_--;
     queueOccupancy_ -= pkt.first;
+    release();
     return pkt;
 }
 
@@ -72,25 +103,61 @@ PacketInfo LteMacBuffer::popBack()
     if (queueLength_ <= 0)
         throw cRuntimeError("Packet queue empty");
 
-    PacketInfo pkt = Queue_.back();
-    Queue_.pop_back();
+    PacketInfo pkt = ring_[slot(queueLength_ - 1)];
     queueLength_--;
     queueOccupancy_ -= pkt.first;
+    release();
     return pkt;
 }
 
+unsigned int LteMacBuffer::consumeBytes(unsigned int bytes)
+{
+    unsigned int consumed = 0;
+    while (queueLength_ > 0 && consumed < bytes)
+    {
+        PacketInfo& pkt = ring_[head_];
+        unsigned int size = pkt.first;
+        processed_++;
+        if (size <= bytes - consumed)
+        {
+            // serve the entire packet
+            head_ = slot(1);
+            queueLength_--;
+            consumed += size;
+        }
+        else
+        {
+            // serve part of the packet
+            size = bytes - consumed;
+            pkt.first -= size;
+            consumed = bytes;
+        }
+        queueOccupancy_ -= size;
+    }
+    release();
+    return consumed;
+}
+
+void LteMacBuffer::clear()
+{
+    queueLength_ = 0;
+    queueOccupancy_ = 0;
+    head_ = 0;
+    release();
+}
+
 PacketInfo& LteMacBuffer::front()
 {
     if (queueLength_ <= 0)
         throw cRuntimeError("Packet queue empty");
-    return Queue_.front();
+    return ring_[head_];
 }
 
 PacketInfo LteMacBuffer::back() const
 {
     if (queueLength_ <= 0)
         throw cRuntimeError("Packet queue empty");
-    return Queue_.back();
+    return ring_[slot(queueLength_ - 1)];
 }
 
 void LteMacBuffer::setProcessed(unsigned int i)
@@ -102,7 +169,7 @@ simtime_t LteMacBuffer::getHolTimestamp() const
 {
     if (queueLength_ <= 0)
         throw cRuntimeError("Packet queue empty");
-    return Queue_.front().second;
+    return ring_[head_].second;
 }
 
 unsigned int LteMacBuffer::getProcessed() const
@@ -110,12 +177,6 @@ unsigned int LteMacBuffer::getProcessed() const
     return processed_;
 }
 
-const std::list<PacketInfo>*
-LteMacBuffer::getPacketlist() const
-{
-    return &Queue_;
-}
-
 unsigned int LteMacBuffer::getQueueOccupancy() const
 {
     return queueOccupancy_;
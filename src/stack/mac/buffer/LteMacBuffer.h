@@ -18,6 +18,10 @@ class LteMacQueue;
 /**
  * @class LteMacBuffer
  * @brief  Buffers for MAC packets
+ *
+ * Packets are stored in a ring, which is only allocated when
+ * the first packet is inserted, and occupancy is kept updated,
+ * so that all the status reads are O(1) and do not allocate.
  */
 class LteMacBuffer
 {
@@ -72,9 +76,28 @@ class LteMacBuffer
      */
     PacketInfo popBack();
 
+    /**
+     * consumeBytes() removes up to the given number of bytes
+     * from the front of the queue: packets entirely covered are
+     * extracted, a packet partially covered is shrunk.
+     * NOTE: Each packet served, even partially, increases the
+     * processed_ variable, as with popFront().
+     *
+     * @param bytes bytes to remove
+     * @return bytes actually removed
+     */
+    unsigned int consumeBytes(unsigned int bytes);
+
+    /**
+     * clear() extracts all the packets from the queue,
+     * without increasing the processed_ variable.
+     */
+    void clear();
+
     /**
      * front() returns the  packet in front
      * of the queue without performing actual extraction.
+     * NOTE: The reference is invalidated by insertions.
      *
      * @return zero-size packet if queue is empty,
      *             pkt on successful operation
@@ -138,11 +161,6 @@ class LteMacBuffer
      */
     unsigned int getProcessed() const;
 
-    /**
-     * Get direct (readonly) access to pdu list
-     */
-    const std::list<PacketInfo>* getPacketlist() const;
-
     friend std::ostream &operator << (std::ostream &stream, const LteMacQueue* queue);
 
   private:
@@ -155,8 +173,23 @@ class LteMacBuffer
     /// Number of queued  packets
     int queueLength_;
 
-    /// List of  packets
-    std::list<PacketInfo> Queue_;
+    /// Ring of  packets: its size is zero or a power of two
+    std::vector<PacketInfo> ring_;
+
+    /// Position of the front packet in the ring
+    unsigned int head_;
+
+    /// Position in the ring of the i-th packet from the front
+    unsigned int slot(unsigned int i) const
+    {
+        return (head_ + i) & (ring_.size() - 1);
+    }
+
+    /// Make room for one more packet
+    void grow();
+
+    /// Release the ring of a large buffer once it is empty
+    void release();
 };
 
 #endif
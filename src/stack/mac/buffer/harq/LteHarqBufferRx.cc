@@ -87,6 +87,9 @@ void LteHarqBufferRx::sendFeedback()
                     hfb->getControlInfo())->getDestId()
                    << " result: " << r << endl;
 
+                if (processes_[i]->getUnitStatus(cw) == RXHARQ_PDU_CORRUPTED)
+                    macOwner_->signalHarqNack(nodeId_, i);
+
                 macOwner_->takeObj(hfb);
                 macOwner_->sendLowerPackets(hfb);
             }
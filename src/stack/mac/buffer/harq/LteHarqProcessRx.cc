@@ -77,6 +77,7 @@ LteHarqFeedback *LteHarqProcessRx::createFeedback(Codeword cw)
     UserControlInfo *fbInfo = new UserControlInfo();
     fbInfo->setSourceId(pduInfo->getDestId());
     fbInfo->setDestId(pduInfo->getSourceId());
+    fbInfo->setDestGeneration(pduInfo->getSourceGeneration());
     fbInfo->setFrameType(HARQPKT);
     fb->setControlInfo(fbInfo);
 
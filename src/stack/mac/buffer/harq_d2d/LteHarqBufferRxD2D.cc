@@ -100,6 +100,9 @@ void LteHarqBufferRxD2D::sendFeedback()
                     hfb->getControlInfo())->getDestId()
                    << " result: " << r << endl;
 
+                if (processes_[i]->getUnitStatus(cw) == RXHARQ_PDU_CORRUPTED)
+                    macOwner_->signalHarqNack(nodeId_, i);
+
                 macOwner_->sendLowerPackets(hfb);
             }
         }
@@ -46,6 +46,7 @@ LteHarqFeedback *LteHarqProcessRxD2D::createFeedback(Codeword cw)
         UserControlInfo *fbInfo = new UserControlInfo();
         fbInfo->setSourceId(pduInfo->getDestId());
         fbInfo->setDestId(pduInfo->getSourceId());
+        fbInfo->setDestGeneration(pduInfo->getSourceGeneration());
         fbInfo->setFrameType(HARQPKT);
         fb->setControlInfo(fbInfo);
     }
@@ -19,12 +19,17 @@
 #include "corenetwork/deployer/LteDeployer.h"
 #include "stack/mac/packet/LteHarqFeedback_m.h"
 #include "stack/mac/buffer/LteMacBuffer.h"
+#include "stack/mac/packet/LteMacSduRequest.h"
+#include "stack/rlc/um/LteRlcUmRealistic.h"
 #include "assert.h"
+#include <limits>
 
 LteMacBase::LteMacBase()
 {
     mbuf_.clear();
     macBuffers_.clear();
+    rlcUm_ = NULL;
+    binder_ = NULL;
 }
 
 LteMacBase::~LteMacBase()
@@ -46,6 +51,9 @@ LteMacBase::~LteMacBase()
         delete hrit->second;
     harqTxBuffers_.clear();
     harqRxBuffers_.clear();
+
+    if (binder_ != NULL && getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        binder_->removeNodeListener(this);
 }
 
 void LteMacBase::sendUpperPackets(cPacket* pkt)
@@ -84,6 +92,15 @@ void LteMacBase::fromPhy(cPacket *pkt)
     UserControlInfo *userInfo = check_and_cast<UserControlInfo *>(pkt->getControlInfo());
     MacNodeId src = userInfo->getSourceId();
 
+    // the state of the sender has been dropped when it left (see nodeLeft()), and
+    // its id may already belong to another node
+    if (!binder_->isCurrentNode(src, userInfo->getSourceGeneration()))
+    {
+        EV << NOW << "Mac::fromPhy: node " << nodeId_ << " dropping packet from departed node " << src << endl;
+        delete pkt;
+        return;
+    }
+
     if (userInfo->getFrameType() == HARQPKT)
     {
         // H-ARQ feedback, send it to TX buffer of source
@@ -227,71 +244,64 @@ bool LteMacBase::bufferizePacket(cPacket* pkt)
 
 void LteMacBase::deleteQueues(MacNodeId nodeId)
 {
-    LteMacBuffers::iterator mit;
-    LteMacBufferMap::iterator vit;
-    for (mit = mbuf_.begin(); mit != mbuf_.end(); )
+    // the CIDs of a node are contiguous
+    MacCid firstCid = idToMacCid(nodeId, 0);
+    MacCid lastCid = idToMacCid(nodeId, std::numeric_limits<LogicalCid>::max());
+
+    LteMacBuffers::iterator mit = mbuf_.lower_bound(firstCid);
+    while (mit != mbuf_.end() && mit->first <= lastCid)
     {
-        if (MacCidToNodeId(mit->first) == nodeId)
+        while (!mit->second->empty())
         {
-            while (!mit->second->empty())
-            {
-                cPacket* pkt = mit->second->popFront();
-                delete pkt;
-            }
-            delete mit->second;        // Delete Queue
-            mbuf_.erase(mit++);        // Delete Elem
-        }
-        else
-        {
-            ++mit;
+            cPacket* pkt = mit->second->popFront();
+            delete pkt;
         }
+        delete mit->second;        // Delete Queue
+        mbuf_.erase(mit++);        // Delete Elem
     }
-    for (vit = macBuffers_.begin(); vit != macBuffers_.end(); )
+    LteMacBufferMap::iterator vit = macBuffers_.lower_bound(firstCid);
+    while (vit != macBuffers_.end() && vit->first <= lastCid)
     {
-        if (MacCidToNodeId(vit->first) == nodeId)
-        {
-            while (!vit->second->isEmpty())
-                vit->second->popFront();
-            delete vit->second;        // Delete Queue
-            macBuffers_.erase(vit++);        // Delete Elem
-        }
-        else
-        {
-            ++vit;
-        }
+        vit->second->clear();
+        delete vit->second;        // Delete Queue
+        macBuffers_.erase(vit++);        // Delete Elem
     }
 
     // delete H-ARQ buffers
-    HarqTxBuffers::iterator hit;
-    for (hit = harqTxBuffers_.begin(); hit != harqTxBuffers_.end(); )
+    HarqTxBuffers::iterator hit = harqTxBuffers_.find(nodeId);
+    if (hit != harqTxBuffers_.end())
     {
-        if (hit->first == nodeId)
-        {
-            delete hit->second; // Delete Queue
-            harqTxBuffers_.erase(hit++); // Delete Elem
-        }
-        else
-        {
-            ++hit;
-        }
+        delete hit->second; // Delete Queue
+        harqTxBuffers_.erase(hit); // Delete Elem
     }
-    HarqRxBuffers::iterator hit2;
-    for (hit2 = harqRxBuffers_.begin(); hit2 != harqRxBuffers_.end();)
+    HarqRxBuffers::iterator hit2 = harqRxBuffers_.find(nodeId);
+    if (hit2 != harqRxBuffers_.end())
     {
-        if (hit2->first == nodeId)
-        {
-            delete hit2->second; // Delete Queue
-            harqRxBuffers_.erase(hit2++); // Delete Elem
-        }
-        else
-        {
-            ++hit2;
-        }
+        delete hit2->second; // Delete Queue
+        harqRxBuffers_.erase(hit2); // Delete Elem
     }
 
     // TODO remove traffic descriptor and lcg entry
 }
 
+void LteMacBase::nodeLeft(MacNodeId nodeId)
+{
+    if (nodeId == nodeId_)
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+    EV << NOW << " LteMacBase::nodeLeft - dropping the state of node " << nodeId << endl;
+
+    LteMacBase::deleteQueues(nodeId);
+
+    // connection descriptors
+    MacCid firstCid = idToMacCid(nodeId, 0);
+    MacCid lastCid = idToMacCid(nodeId, std::numeric_limits<LogicalCid>::max());
+    connDesc_.erase(connDesc_.lower_bound(firstCid), connDesc_.upper_bound(lastCid));
+    connDescIn_.erase(connDescIn_.lower_bound(firstCid), connDescIn_.upper_bound(lastCid));
+    resetHarq_.erase(nodeId);
+}
+
 
 /*
  * Main functions
@@ -312,6 +322,7 @@ void LteMacBase::initialize(int stage)
 
         /* Get reference to binder */
         binder_ = getBinder();
+        binder_->addNodeListener(this);
 
         /* Set The MAC MIB */
 
@@ -320,9 +331,15 @@ void LteMacBase::initialize(int stage)
         harqProcesses_ = par("harqProcesses");
 
         /* Start TTI tick */
-        ttiTick_ = new cMessage("ttiTick_");
-        ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
-        scheduleAt(NOW + TTI, ttiTick_);
+        ttiTimer_ = new TtiTimer(this, this, "ttiTick_", TTI_TICK, TTI_PHASE_MAC);   // TTI TICK after other messages
+        ttiTimer_->start();
+
+        flushHarqTimer_ = new TtiTimer(this, this, "flushHarqMsg", FLUSH_HARQ, TTI_PHASE_MAC);   // after the TTI TICK
+
+        /* RLC UM of this NIC, for direct SDU requests */
+        cModule* rlc = getParentModule()->getSubmodule("rlc");
+        if (rlc != NULL)
+            rlcUm_ = dynamic_cast<LteRlcUmRealistic*>(rlc->getSubmodule("um"));
         totalOverflowedBytes_ = 0;
         macBufferOverflowDl_ = registerSignal("macBufferOverflowDl");
         macBufferOverflowUl_ = registerSignal("macBufferOverflowUl");
@@ -342,12 +359,55 @@ void LteMacBase::initialize(int stage)
     }
 }
 
+void LteMacBase::requestMacSdus(const MacSduRequests& requests)
+{
+    MacSduRequests direct;
+    direct.reserve(requests.size());
+
+    MacSduRequests::const_iterator it;
+    for (it = requests.begin(); it != requests.end(); ++it)
+    {
+        // the RLC mux forwards the requests of UM connections only to the UM entity
+        if (rlcUm_ != NULL && it->lteInfo->getRlcType() == UM)
+        {
+            direct.push_back(*it);
+            continue;
+        }
+
+        // send the request message to the upper layer
+        LteMacSduRequest* macSduRequest = new LteMacSduRequest("LteMacSduRequest");
+        macSduRequest->setUeId(MacCidToNodeId(it->cid));
+        macSduRequest->setLcid(MacCidToLcid(it->cid));
+        macSduRequest->setSduSize(it->sduSize);
+        macSduRequest->setControlInfo(it->lteInfo->dup());
+        sendUpperPackets(macSduRequest);
+    }
+
+    if (direct.empty())
+        return;
+
+    std::vector<cPacket*> pdus;
+    rlcUm_->rlcPduMake(direct, pdus);
+
+    EV << "LteMacBase : Received " << pdus.size() << " RLC PDUs from the RLC UM" << endl;
+    for (unsigned int i = 0; i < pdus.size(); ++i)
+    {
+        take(pdus[i]);
+        emit(receivedPacketFromUpperLayer, pdus[i]);
+        fromRlc(pdus[i]);
+    }
+}
+
 void LteMacBase::handleMessage(cMessage* msg)
 {
     if (msg->isSelfMessage())
     {
-        handleSelfMessage();
-        scheduleAt(NOW + TTI, ttiTick_);
+        if (msg->getKind() == TTI_TICK)
+            ttiTimer_->handle();
+        else if (msg->getKind() == FLUSH_HARQ)
+            flushHarqTimer_->handle();
+        else
+            throw cRuntimeError("LteMacBase::handleMessage - unexpected self message %s", msg->getName());
         return;
     }
 
@@ -379,7 +439,8 @@ void LteMacBase::finish()
 
 void LteMacBase::deleteModule(){
     EV_DEBUG << "LteMacBase - module deleted.";
-    cancelAndDelete(ttiTick_);
+    delete ttiTimer_;
+    delete flushHarqTimer_;
     cSimpleModule::deleteModule();
 }
 
@@ -11,12 +11,15 @@
 #define _LTE_LTEMACBASE_H_
 
 #include "common/LteCommon.h"
+#include "common/timer/TtiTimer.h"
+#include "common/LteNodeListener.h"
 
 class LteHarqBufferTx;
 class LteHarqBufferRx;
 class LteBinder;
 class LteControlInfo;
 class LteMacBuffer;
+class LteRlcUmRealistic;
 
 /**
  * Map associating a nodeId with the corresponding TX H-ARQ buffer.
@@ -38,6 +41,20 @@ typedef std::pair<MacCid, LteMacBuffer*> CidBufferPair;
 typedef std::pair<LteTrafficClass, CidBufferPair> LcgPair;
 typedef std::multimap<LteTrafficClass, CidBufferPair> LcgMap;
 
+/**
+ * Request of a MAC SDU to the RLC for a connection: the RLC answers
+ * with a RLC PDU of (at most) the requested size
+ */
+struct MacSduRequest
+{
+    MacCid cid;
+    /// connection descriptor
+    LteControlInfo* lteInfo;
+    /// requested size, MAC header excluded (bytes)
+    unsigned int sduSize;
+};
+typedef std::vector<MacSduRequest> MacSduRequests;
+
 /**
  * @class LteMacBase
  * @brief MAC Layer
@@ -48,7 +65,7 @@ typedef std::multimap<LteTrafficClass, CidBufferPair> LcgMap;
  * On each TTI, the handleSelfMessage() is called
  * to perform scheduling and other tasks
  */
-class LteMacBase : public cSimpleModule
+class LteMacBase : public cSimpleModule, public TtiListener, public LteNodeListener
 {
     friend class LteHarqBufferTx;
     friend class LteHarqBufferRx;
@@ -85,8 +102,14 @@ class LteMacBase : public cSimpleModule
 
     int harqProcesses_;
 
-    /// TTI self message
-    cMessage* ttiTick_;
+    /// TTI timer, runs the main loop
+    TtiTimer* ttiTimer_;
+
+    /// Timer triggering the flush of the Tx H-ARQ buffers after the main loop
+    TtiTimer* flushHarqTimer_;
+
+    /// RLC UM of the same NIC, serving the SDU requests by direct method call (NULL if not available)
+    LteRlcUmRealistic* rlcUm_;
 
     /// MacNodeId
     MacNodeId nodeId_;
@@ -155,6 +178,16 @@ class LteMacBase : public cSimpleModule
      */
     virtual void deleteQueues(MacNodeId nodeId);
 
+    /**
+     * nodeLeft() is called by the binder when a node leaves the
+     * simulation: deletes its queues, H-ARQ buffers and connection
+     * descriptors. Unlike deleteQueues() at the UE, the queues of the
+     * other nodes are kept
+     *
+     * @param nodeId Id of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
+
     //* public utility function - drops ownership of an object
     void dropObj(cOwnedObject* obj)
     {
@@ -237,6 +270,14 @@ class LteMacBase : public cSimpleModule
         return false;
     }
 
+    /**
+     * Called by the RX H-ARQ buffer of srcId when a NACK is sent for
+     * the given process and the process waits for a retransmission
+     */
+    virtual void signalHarqNack(MacNodeId srcId, unsigned char acid)
+    {
+    }
+
     // check whether HARQ processes have been aborted during this TTI
     bool isHarqReset(MacNodeId srcId)
     {
@@ -273,7 +314,7 @@ class LteMacBase : public cSimpleModule
     /**
      * Deleting the module
      *
-     * Method is overridden in order to cancel the periodic TTI self-message,
+     * Method is overridden in order to cancel the periodic TTI self-messages,
      * afterwards the deleteModule method of cSimpleModule is called.
      */
     virtual void deleteModule();
@@ -285,6 +326,27 @@ class LteMacBase : public cSimpleModule
      */
     virtual void handleSelfMessage() = 0;
 
+    /**
+     * TTI tick: runs the main loop (TTI_TICK). Other kinds
+     * are handled by the derived classes owning the timers.
+     */
+    virtual void handleTtiTick(short kind)
+    {
+        if (kind != TTI_TICK)
+            throw cRuntimeError("LteMacBase::handleTtiTick - unexpected tick kind %d", kind);
+        handleSelfMessage();
+    }
+
+    /**
+     * Requests the MAC SDUs of this TTI to the RLC in a single call, then handles
+     * the RLC PDUs as if they had been received from the upper layer, in the order
+     * of the requests. Requests that the RLC UM cannot serve directly are sent as
+     * LteMacSduRequest messages.
+     *
+     * @param requests one request per scheduled connection
+     */
+    void requestMacSdus(const MacSduRequests& requests);
+
     /**
      * sendLowerPackets() is used
      * to send packets to lower layer
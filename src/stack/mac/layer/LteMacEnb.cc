@@ -21,6 +21,7 @@
 #include "stack/mac/amc/UserTxParams.h"
 #include "stack/mac/packet/LteRac_m.h"
 #include "common/LteCommon.h"
+#include <limits>
 
 Define_Module( LteMacEnb);
 
@@ -189,18 +190,15 @@ void LteMacEnb::deleteQueues(MacNodeId nodeId)
 {
     LteMacBase::deleteQueues(nodeId);
 
-    LteMacBufferMap::iterator bit;
-    for (bit = bsrbuf_.begin(); bit != bsrbuf_.end();)
+    // the CIDs of a node are contiguous
+    MacCid firstCid = idToMacCid(nodeId, 0);
+    MacCid lastCid = idToMacCid(nodeId, std::numeric_limits<LogicalCid>::max());
+
+    LteMacBufferMap::iterator bit = bsrbuf_.lower_bound(firstCid);
+    while (bit != bsrbuf_.end() && bit->first <= lastCid)
     {
-        if (MacCidToNodeId(bit->first) == nodeId)
-        {
-            delete bit->second; // Delete Queue
-            bsrbuf_.erase(bit++); // Delete Elem
-        }
-        else
-        {
-            ++bit;
-        }
+        delete bit->second; // Delete Queue
+        bsrbuf_.erase(bit++); // Delete Elem
     }
 
     //update harq status in schedulers
@@ -215,6 +213,24 @@ void LteMacEnb::deleteQueues(MacNodeId nodeId)
     enbSchedulerUl_->removePendingRac(nodeId);
 }
 
+void LteMacEnb::nodeLeft(MacNodeId nodeId)
+{
+    if (nodeId == nodeId_)
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+    LteMacBase::nodeLeft(nodeId);
+    deleteQueues(nodeId);
+    enbSchedulerUl_->removeHarqStatus(nodeId);
+    if (amc_ != NULL)
+        amc_->removeUser(nodeId);
+}
+
+void LteMacEnb::signalHarqNack(MacNodeId srcId, unsigned char acid)
+{
+    enbSchedulerUl_->signalRtx(srcId, acid);
+}
+
 void LteMacEnb::initialize(int stage)
 {
     LteMacBase::initialize(stage);
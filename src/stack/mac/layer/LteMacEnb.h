@@ -176,6 +176,20 @@ class LteMacEnb : public LteMacBase
      */
     virtual void deleteQueues(MacNodeId nodeId);
 
+    /**
+     * nodeLeft() on ENB also removes the connections
+     * and the H-ARQ status of the node from the schedulers
+     *
+     * @param nodeId Id of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
+
+    /**
+     * Queues the retransmission of the given UL process of srcId
+     * in the uplink scheduler
+     */
+    virtual void signalHarqNack(MacNodeId srcId, unsigned char acid);
+
     /**
      * Getter for AMC module
      */
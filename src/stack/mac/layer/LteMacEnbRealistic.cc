@@ -21,7 +21,6 @@
 #include "stack/mac/amc/UserTxParams.h"
 #include "stack/mac/packet/LteRac_m.h"
 #include "common/LteCommon.h"
-#include "stack/mac/packet/LteMacSduRequest.h"
 
 Define_Module( LteMacEnbRealistic);
 
@@ -65,19 +64,12 @@ void LteMacEnbRealistic::initialize(int stage)
     LteMacEnb::initialize(stage);
 }
 
-void LteMacEnbRealistic::handleMessage(cMessage* msg)
+void LteMacEnbRealistic::handleTtiTick(short kind)
 {
-    if (msg->isSelfMessage())
-    {
-        if (strcmp(msg->getName(), "flushHarqMsg") == 0)
-        {
-            flushHarqBuffers();
-            delete msg;
-            return;
-        }
-    }
-
-    LteMacBase::handleMessage(msg);
+    if (kind == FLUSH_HARQ)
+        flushHarqBuffers();
+    else
+        LteMacBase::handleTtiTick(kind);
 }
 
 void LteMacEnbRealistic::macSduRequest()
@@ -85,6 +77,7 @@ void LteMacEnbRealistic::macSduRequest()
     EV << "----- START LteMacEnbRealistic::macSduRequest -----\n";
 
     // Ask for a MAC sdu for each scheduled user on each codeword
+    MacSduRequests requests;
     LteMacScheduleList::const_iterator it;
     for (it = scheduleListDl_->begin(); it != scheduleListDl_->end(); it++)
     {
@@ -102,15 +95,16 @@ void LteMacEnbRealistic::macSduRequest()
             allocatedBytes += enbSchedulerDl_->allocator_->getBytes(MACRO,b,destId);
         }
 
-        // send the request message to the upper layer
-        LteMacSduRequest* macSduRequest = new LteMacSduRequest("LteMacSduRequest");
-        macSduRequest->setUeId(destId);
-        macSduRequest->setLcid(MacCidToLcid(destCid));
-        macSduRequest->setSduSize(allocatedBytes - MAC_HEADER);    // do not consider MAC header size
-        macSduRequest->setControlInfo((&connDesc_[destCid])->dup());
-        sendUpperPackets(macSduRequest);
+        MacSduRequest request;
+        request.cid = destCid;
+        request.lteInfo = &connDesc_[destCid];
+        request.sduSize = allocatedBytes - MAC_HEADER;    // do not consider MAC header size
+        requests.push_back(request);
     }
 
+    // all the requests of the TTI go to the RLC at once
+    requestMacSdus(requests);
+
     EV << "------ END LteMacEnbRealistic::macSduRequest ------\n";
 }
 
@@ -443,9 +437,7 @@ void LteMacEnbRealistic::handleSelfMessage()
 
     // Message that triggers flushing of Tx H-ARQ buffers for all users
     // This way, flushing is performed after the (possible) reception of new MAC PDUs
-    cMessage* flushHarqMsg = new cMessage("flushHarqMsg");
-    flushHarqMsg->setSchedulingPriority(1);        // after other messages
-    scheduleAt(NOW, flushHarqMsg);
+    flushHarqTimer_->trigger();
 
     EV << "--- END " << ((nodeType==MACRO_ENB)?"MACRO":"MICRO") << " ENB MAIN LOOP ---" << endl;
 }
@@ -25,15 +25,14 @@ class LteMacEnbRealistic : public LteMacEnb
     virtual void initialize(int stage);
 
     /**
-     * Analyze gate of incoming packet
-     * and call proper handler
+     * TTI tick: flushes the Tx H-ARQ buffers after the main loop (FLUSH_HARQ)
      */
-    virtual void handleMessage(cMessage *msg);
+    virtual void handleTtiTick(short kind);
 
     /**
-     * macSduRequest() sends a message to the RLC layer
-     * requesting MAC SDUs (one for each CID),
-     * according to the Schedule List.
+     * macSduRequest() requests MAC SDUs (one for each CID)
+     * to the RLC layer, according to the Schedule List.
+     * All the requests are issued at once (see requestMacSdus())
      */
     virtual void macSduRequest();
 
@@ -291,8 +291,7 @@ void LteMacEnbRealisticD2D::clearBsrBuffers(MacNodeId ueId)
         LteMacBuffer* buf = vit->second;
         EV << NOW << "LteMacEnbRealisticD2D::clearBsrBuffers - Length was " << buf->getQueueOccupancy() << endl;
 
-        while (!buf->isEmpty())
-            buf->popFront();
+        buf->clear();
 
         EV << NOW << "LteMacEnbRealisticD2D::clearBsrBuffers - New length is " << buf->getQueueOccupancy() << endl;
 
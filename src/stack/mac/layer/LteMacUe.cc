@@ -758,8 +758,7 @@ void LteMacUe::deleteQueues(MacNodeId nodeId)
     }
     for (vit = macBuffers_.begin(); vit != macBuffers_.end(); )
     {
-        while (!vit->second->isEmpty())
-            vit->second->popFront();
+        vit->second->clear();
         delete vit->second;                  // Delete Queue
         macBuffers_.erase(vit++);           // Delete Elem
     }
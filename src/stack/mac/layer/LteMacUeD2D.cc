@@ -648,8 +648,7 @@ void LteMacUeD2D::macHandleD2DModeSwitch(cPacket* pkt)
                     LteMacBufferMap::iterator macBuff_it = macBuffers_.find(cid);
                     if (macBuff_it != macBuffers_.end())
                     {
-                        while (!(macBuff_it->second->isEmpty()))
-                            macBuff_it->second->popFront();
+                        macBuff_it->second->clear();
                         macBuffers_.erase(macBuff_it);
                     }
 
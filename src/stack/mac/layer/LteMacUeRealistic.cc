@@ -19,7 +19,6 @@
 #include "inet/common/ModuleAccess.h"
 #include "inet/networklayer/ipv4/IPv4InterfaceData.h"
 #include "corenetwork/binder/LteBinder.h"
-#include "stack/mac/packet/LteMacSduRequest.h"
 
 Define_Module(LteMacUeRealistic);
 
@@ -47,46 +46,38 @@ void LteMacUeRealistic::initialize(int stage)
     }
 }
 
-void LteMacUeRealistic::handleMessage(cMessage* msg)
+void LteMacUeRealistic::handleTtiTick(short kind)
 {
-    if (msg->isSelfMessage())
-    {
-        if (strcmp(msg->getName(), "flushHarqMsg") == 0)
-        {
-            flushHarqBuffers();
-            delete msg;
-            return;
-        }
-    }
-
-    LteMacBase::handleMessage(msg);
+    if (kind == FLUSH_HARQ)
+        flushHarqBuffers();
+    else
+        LteMacBase::handleTtiTick(kind);
 }
 
 bool LteMacUeRealistic::macSduRequest()
 {
     EV << "----- START LteMacUeRealistic::macSduRequest -----\n";
-    bool sent = false;
     // Ask for a MAC sdu for each scheduled user on each codeword
+    MacSduRequests requests;
     LteMacScheduleList::const_iterator it;
     for (it = scheduleList_->begin(); it != scheduleList_->end(); it++)
     {
         MacCid destCid = it->first.first;
         Codeword cw = it->first.second;
-        MacNodeId destId = MacCidToNodeId(destCid);
 
         // get the number of granted bytes
         unsigned int allocatedBytes = schedulingGrant_->getGrantedCwBytes(cw);
 
-        // send the request message to the upper layer
-        LteMacSduRequest* macSduRequest = new LteMacSduRequest("LteMacSduRequest");
-        macSduRequest->setUeId(destId);
-        macSduRequest->setLcid(MacCidToLcid(destCid));
-        macSduRequest->setSduSize(allocatedBytes - MAC_HEADER);    // do not consider MAC header size
-        macSduRequest->setControlInfo((&connDesc_[destCid])->dup());
-        sendUpperPackets(macSduRequest);
-
-        sent = true;
+        MacSduRequest request;
+        request.cid = destCid;
+        request.lteInfo = &connDesc_[destCid];
+        request.sduSize = allocatedBytes - MAC_HEADER;    // do not consider MAC header size
+        requests.push_back(request);
     }
+    bool sent = !requests.empty();
+
+    // all the requests of the TTI go to the RLC at once
+    requestMacSdus(requests);
 
     EV << "------ END LteMacUeRealistic::macSduRequest ------\n";
     return sent;
@@ -554,9 +545,7 @@ void LteMacUeRealistic::handleSelfMessage()
 
         // Message that triggers flushing of Tx H-ARQ buffers for all users
         // This way, flushing is performed after the (possible) reception of new MAC PDUs
-        cMessage* flushHarqMsg = new cMessage("flushHarqMsg");
-        flushHarqMsg->setSchedulingPriority(1);        // after other messages
-        scheduleAt(NOW, flushHarqMsg);
+        flushHarqTimer_->trigger();
 
 //        // deleting non-periodic grant
 //        if (!schedulingGrant_->getPeriodic())
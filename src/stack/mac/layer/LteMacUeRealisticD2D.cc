@@ -715,9 +715,7 @@ void LteMacUeRealisticD2D::handleSelfMessage()
 
         // Message that triggers flushing of Tx H-ARQ buffers for all users
         // This way, flushing is performed after the (possible) reception of new MAC PDUs
-        cMessage* flushHarqMsg = new cMessage("flushHarqMsg");
-        flushHarqMsg->setSchedulingPriority(1);        // after other messages
-        scheduleAt(NOW, flushHarqMsg);
+        flushHarqTimer_->trigger();
     }
 
     //============================ DEBUG ==========================
@@ -825,8 +823,7 @@ void LteMacUeRealisticD2D::macHandleD2DModeSwitch(cPacket* pkt)
                     LteMacBufferMap::iterator macBuff_it = macBuffers_.find(cid);
                     if (macBuff_it != macBuffers_.end())
                     {
-                        while (!(macBuff_it->second->isEmpty()))
-                            macBuff_it->second->popFront();
+                        macBuff_it->second->clear();
                         delete macBuff_it->second;
                         macBuffers_.erase(macBuff_it);
                     }
@@ -41,6 +41,7 @@ Define_Module(LteMacVUeMode4);
 LteMacVUeMode4::LteMacVUeMode4() :
     LteMacUeRealisticD2D()
 {
+    sidelinkConfig_ = NULL;
 }
 
 LteMacVUeMode4::~LteMacVUeMode4()
@@ -54,10 +55,23 @@ void LteMacVUeMode4::initialize(int stage)
 
     if (stage == inet::INITSTAGE_LOCAL)
     {
-        parseUeTxConfig(par("txConfig").xmlValue());
-        parseCbrTxConfig(par("txConfig").xmlValue());
-        parseRriConfig(par("txConfig").xmlValue());
-        resourceReservationInterval_ = validResourceReservationIntervals_.at(0);
+        // the configuration is compiled once and shared by all the UEs with the same one
+        SidelinkTxParams defaults;
+        defaults.minMcs = par("minMCSPSSCH");
+        defaults.maxMcs = par("maxMCSPSSCH");
+        defaults.minSubchannels = par("minSubchannelNumberPSSCH");
+        defaults.maxSubchannels = par("maxSubchannelNumberPSSCH");
+        defaults.allowedRetx = par("allowedRetxNumberPSSCH");
+        sidelinkConfig_ = binder_->getSidelinkConfiguration(par("txConfig").xmlValue(), defaults);
+
+        const SidelinkTxParams& ueTxParams = sidelinkConfig_->getUeTxParams();
+        minMCSPSSCH_ = ueTxParams.minMcs;
+        maxMCSPSSCH_ = ueTxParams.maxMcs;
+        minSubchannelNumberPSSCH_ = ueTxParams.minSubchannels;
+        maxSubchannelNumberPSSCH_ = ueTxParams.maxSubchannels;
+        allowedRetxNumberPSSCH_ = ueTxParams.allowedRetx;
+        currentCbrIndex_ = sidelinkConfig_->getDefaultCbrIndex();
+        resourceReservationInterval_ = sidelinkConfig_->getResourceReservationIntervals().at(0);
         subchannelSize_ = par("subchannelSize");
         numSubchannels_ = par("numSubchannels");
         probResourceKeep_ = par("probResourceKeep");
@@ -74,20 +88,33 @@ void LteMacVUeMode4::initialize(int stage)
 
         // Register the necessary signals for this simulation
 
-        grantStartTime          = registerSignal("grantStartTime");
-        grantBreak              = registerSignal("grantBreak");
-        grantBreakTiming        = registerSignal("grantBreakTiming");
-        grantBreakSize          = registerSignal("grantBreakSize");
-        droppedTimeout          = registerSignal("droppedTimeout");
-        grantBreakMissedTrans   = registerSignal("grantBreakMissedTrans");
-        missedTransmission      = registerSignal("missedTransmission");
-        selectedMCS             = registerSignal("selectedMCS");
-        selectedSubchannelIndex = registerSignal("selectedSubchannelIndex");
-        selectedNumSubchannels  = registerSignal("selectedNumSubchannels");
-        maximumCapacity         = registerSignal("maximumCapacity");
-        grantRequests           = registerSignal("grantRequests");
-        packetDropDCC           = registerSignal("packetDropDCC");
-        macNodeID               = registerSignal("macNodeID");
+        simtime_t aggregationPeriod = par("statisticAggregationPeriod");
+
+        grantStartTime.init(this, "grantStartTime");
+        grantBreak.init(this, "grantBreak", AGGREGATE_SUM, aggregationPeriod);
+        grantBreakTiming.init(this, "grantBreakTiming", AGGREGATE_SUM, aggregationPeriod);
+        grantBreakSize.init(this, "grantBreakSize");
+        droppedTimeout.init(this, "droppedTimeout", AGGREGATE_SUM, aggregationPeriod);
+        grantBreakMissedTrans.init(this, "grantBreakMissedTrans", AGGREGATE_SUM, aggregationPeriod);
+        missedTransmission.init(this, "missedTransmission", AGGREGATE_SUM, aggregationPeriod);
+        selectedMCS.init(this, "selectedMCS", AGGREGATE_MEAN, aggregationPeriod);
+        selectedSubchannelIndex.init(this, "selectedSubchannelIndex", AGGREGATE_MEAN, aggregationPeriod);
+        selectedNumSubchannels.init(this, "selectedNumSubchannels", AGGREGATE_MEAN, aggregationPeriod);
+        maximumCapacity.init(this, "maximumCapacity", AGGREGATE_MEAN, aggregationPeriod);
+        grantRequests.init(this, "grantRequests", AGGREGATE_SUM, aggregationPeriod);
+        packetDropDCC.init(this, "packetDropDCC", AGGREGATE_SUM, aggregationPeriod);
+        macNodeID.init(this, "macNodeID");
+
+        LteStatistic* statistics[] = {
+            &grantStartTime, &grantBreak, &grantBreakTiming, &grantBreakSize, &droppedTimeout, &grantBreakMissedTrans,
+            &missedTransmission, &selectedMCS, &selectedNumSubchannels, &selectedSubchannelIndex, &maximumCapacity,
+            &grantRequests, &packetDropDCC, &macNodeID
+        };
+        for (LteStatistic* statistic : statistics)
+        {
+            if (statistic->enabled() && statistic->aggregated())
+                aggregatedStatistics_.push_back(statistic);
+        }
     }
     else if (stage == inet::INITSTAGE_NETWORK_LAYER_3)
     {
@@ -104,7 +131,7 @@ void LteMacVUeMode4::initialize(int stage)
         // LTE UE Section
         nodeId_ = getAncestorPar("macNodeId");
 
-        emit(macNodeID, nodeId_);
+        macNodeID.emit(nodeId_);
 
         /* Insert UeInfo in the Binder */
         ueInfo_ = new UeInfo();
@@ -120,201 +147,6 @@ void LteMacVUeMode4::initialize(int stage)
     }
 }
 
-void LteMacVUeMode4::parseUeTxConfig(cXMLElement* xmlConfig)
-{
-    if (xmlConfig == 0)
-    throw cRuntimeError("No sidelink configuration file specified");
-
-    // Get channel Model field which contains parameters fields
-    cXMLElementList ueTxConfig = xmlConfig->getElementsByTagName("userEquipment-txParameters");
-
-    if (ueTxConfig.empty())
-        throw cRuntimeError("No userEquipment-txParameters configuration found in configuration file");
-
-    if (ueTxConfig.size() > 1)
-        throw cRuntimeError("More than one userEquipment-txParameters configuration found in configuration file.");
-
-    cXMLElement* ueTxConfigData = ueTxConfig.front();
-
-    ParameterMap params;
-    getParametersFromXML(ueTxConfigData, params);
-
-    //get lambda max threshold
-    ParameterMap::iterator it = params.find("minMCS-PSSCH");
-    if (it != params.end())
-    {
-        minMCSPSSCH_ = (int)it->second;
-    }
-    else
-        minMCSPSSCH_ = (int)par("minMCSPSSCH");
-    it = params.find("maxMCS-PSSCH");
-    if (it != params.end())
-    {
-        maxMCSPSSCH_ = (int)it->second;
-    }
-    else
-        maxMCSPSSCH_ = (int)par("minMCSPSSCH");
-    it = params.find("minSubchannel-NumberPSSCH");
-    if (it != params.end())
-    {
-        minSubchannelNumberPSSCH_ = (int)it->second;
-    }
-    else
-        minSubchannelNumberPSSCH_ = (int)par("minSubchannelNumberPSSCH");
-    it = params.find("maxSubchannel-NumberPSSCH");
-    if (it != params.end())
-    {
-        maxSubchannelNumberPSSCH_ = (int)it->second;
-    }
-    else
-        maxSubchannelNumberPSSCH_ = (int)par("maxSubchannelNumberPSSCH");
-    it = params.find("allowedRetxNumberPSSCH");
-    if (it != params.end())
-    {
-        allowedRetxNumberPSSCH_ = (int)it->second;
-    }
-    else
-        allowedRetxNumberPSSCH_ = (int)par("allowedRetxNumberPSSCH");
-}
-
-void LteMacVUeMode4::parseCbrTxConfig(cXMLElement* xmlConfig)
-{
-    if (xmlConfig == 0)
-    throw cRuntimeError("No cbr configuration specified");
-
-    // Get channel Model field which contains parameters fields
-    cXMLElementList cbrTxConfig = xmlConfig->getElementsByTagName("Sl-CBR-CommonTxConfigList");
-
-    if (cbrTxConfig.empty())
-        throw cRuntimeError("No Sl-CBR-CommonTxConfigList found in configuration file");
-
-    cXMLElement* cbrTxConfigData = cbrTxConfig.front();
-
-    ParameterMap params;
-    getParametersFromXML(cbrTxConfigData, params);
-
-    //get lambda max threshold
-    ParameterMap::iterator it = params.find("default-cbr-ConfigIndex");
-    if (it != params.end())
-    {
-        defaultCbrIndex_ = it->second;
-        currentCbrIndex_ = defaultCbrIndex_;
-    }
-
-    cXMLElementList cbrLevelConfigs = xmlConfig->getElementsByTagName("cbr-ConfigIndex");
-
-    if (cbrLevelConfigs.empty())
-        throw cRuntimeError("No cbr-Levels-Config found in configuration file");
-
-    cXMLElementList::iterator xmlIt;
-    for(xmlIt = cbrLevelConfigs.begin(); xmlIt != cbrLevelConfigs.end(); xmlIt++)
-    {
-        std::unordered_map<std::string, double> cbrLevelsMap;
-        ParameterMap cbrLevelsParams;
-        getParametersFromXML((*xmlIt), cbrLevelsParams);
-        it = cbrLevelsParams.find("cbr-lower");
-        if (it != cbrLevelsParams.end())
-        {
-            cbrLevelsMap.insert(pair<std::string, double>("cbr-lower",  it->second));
-        }
-        it = cbrLevelsParams.find("cbr-upper");
-        if (it != cbrLevelsParams.end())
-        {
-            cbrLevelsMap.insert(pair<std::string, double>("cbr-upper",  it->second));
-        }
-        it = cbrLevelsParams.find("cbr-PSSCH-TxConfig-Index");
-        if (it != cbrLevelsParams.end())
-        {
-            cbrLevelsMap.insert(pair<std::string, double>("cbr-PSSCH-TxConfig-Index",  it->second));
-        }
-        cbrLevels_.push_back(cbrLevelsMap);
-    }
-
-    cXMLElementList cbrTxConfigs = xmlConfig->getElementsByTagName("cbr-PSSCH-TxConfig");
-
-    if (cbrTxConfigs.empty())
-        throw cRuntimeError("No CBR-TxConfig found in configuration file");
-
-    cXMLElementList cbrTxParams = xmlConfig->getElementsByTagName("txParameters");
-
-    for(xmlIt = cbrTxParams.begin(); xmlIt != cbrTxParams.end(); xmlIt++)
-    {
-        std::unordered_map<std::string, double> cbrMap;
-        ParameterMap cbrParams;
-        getParametersFromXML((*xmlIt), cbrParams);
-        it = cbrParams.find("minMCS-PSSCH");
-        if (it != cbrParams.end())
-        {
-            cbrMap.insert({"minMCS-PSSCH",  it->second});
-        }
-        else
-            cbrMap.insert({"minMCS-PSSCH",  par("minMCSPSSCH")});
-        it = cbrParams.find("maxMCS-PSSCH");
-        if (it != cbrParams.end())
-        {
-            cbrMap.insert({"maxMCS-PSSCH",  it->second});
-        }
-        else
-            cbrMap.insert({"maxMCS-PSSCH",  par("maxMCSPSSCH")});
-        it = cbrParams.find("minSubchannel-NumberPSSCH");
-        if (it != cbrParams.end())
-        {
-            cbrMap.insert({"minSubchannel-NumberPSSCH",  it->second});
-        }
-        else
-            cbrMap.insert({"minSubchannel-NumberPSSCH",  par("minSubchannelNumberPSSCH")});
-        it = cbrParams.find("maxSubchannel-NumberPSSCH");
-        if (it != cbrParams.end())
-        {
-            cbrMap.insert({"maxSubchannel-NumberPSSCH",  it->second});
-        }
-        else
-            cbrMap.insert({"maxSubchannel-NumberPSSCH",  par("maxSubchannelNumberPSSCH")});
-        it = cbrParams.find("allowedRetxNumberPSSCH");
-        if (it != cbrParams.end())
-        {
-            cbrMap.insert({"allowedRetxNumberPSSCH",  it->second});
-        }
-        else
-            cbrMap.insert({"allowedRetxNumberPSSCH",  par("allowedRetxNumberPSSCH")});
-        it = cbrParams.find("cr-Limit");
-        if (it != cbrParams.end())
-        {
-            cbrMap.insert({"cr-Limit",  it->second});
-        }
-        cbrPSSCHTxConfigList_.push_back(cbrMap);
-    }
-}
-
-void LteMacVUeMode4::parseRriConfig(cXMLElement* xmlConfig)
-{
-    if (xmlConfig == 0)
-    throw cRuntimeError("No cbr configuration specified");
-
-    // Get channel Model field which contains parameters fields
-    cXMLElementList rriConfig = xmlConfig->getElementsByTagName("RestrictResourceReservationPeriodList");
-
-    if (rriConfig.empty())
-        throw cRuntimeError("No RestrictResourceReservationPeriodList found in configuration file");
-
-    cXMLElementList rriConfigs = xmlConfig->getElementsByTagName("RestrictResourceReservationPeriod");
-
-    if (rriConfigs.empty())
-        throw cRuntimeError("No RestrictResourceReservationPeriods found in configuration file");
-
-    cXMLElementList::iterator xmlIt;
-    for(xmlIt = rriConfigs.begin(); xmlIt != rriConfigs.end(); xmlIt++)
-    {
-        ParameterMap rriParams;
-        getParametersFromXML((*xmlIt), rriParams);
-        ParameterMap::iterator it = rriParams.find("rri");
-        if (it != rriParams.end())
-        {
-            validResourceReservationIntervals_.push_back(it->second);
-        }
-    }
-}
-
 int LteMacVUeMode4::getNumAntennas()
 {
     /* Get number of antennas: +1 is for MACRO */
@@ -532,36 +364,10 @@ void LteMacVUeMode4::handleMessage(cMessage *msg)
             Cbr* cbrPkt = check_and_cast<Cbr*>(pkt);
             cbr_ = cbrPkt->getCbr();
 
-            currentCbrIndex_ = defaultCbrIndex_;
             if (useCBR_)
-            {
-                std::vector<std::unordered_map<std::string, double>>::iterator it;
-                for (it = cbrLevels_.begin(); it!=cbrLevels_.end(); it++)
-                {
-                    double cbrUpper = (*it).at("cbr-upper");
-                    double cbrLower = (*it).at("cbr-lower");
-                    double index = (*it).at("cbr-PSSCH-TxConfig-Index");
-                    if (cbrLower == 0){
-                        if (cbr_< cbrUpper)
-                        {
-                            currentCbrIndex_ = (int)index;
-                            break;
-                        }
-                    } else if (cbrUpper == 1){
-                        if (cbr_ > cbrLower)
-                        {
-                            currentCbrIndex_ = (int)index;
-                            break;
-                        }
-                    } else {
-                        if (cbr_ > cbrLower && cbr_<= cbrUpper)
-                        {
-                            currentCbrIndex_ = (int)index;
-                            break;
-                        }
-                    }
-                }
-            }
+                currentCbrIndex_ = sidelinkConfig_->getCbrTxConfigIndex(cbr_);
+            else
+                currentCbrIndex_ = sidelinkConfig_->getDefaultCbrIndex();
 
             int b;
             int a;
@@ -618,7 +424,7 @@ void LteMacVUeMode4::handleMessage(cMessage *msg)
 
             if (schedulingGrant_ != NULL && periodCounter_ > remainingTime_)
             {
-                emit(grantBreakTiming, 1);
+                grantBreakTiming.emit(1);
                 delete schedulingGrant_;
                 schedulingGrant_ = NULL;
                 macGenerateSchedulingGrant(remainingTime_, lteInfo->getPriority());
@@ -650,6 +456,10 @@ void LteMacVUeMode4::handleSelfMessage()
 {
     EV << "----- UE MAIN LOOP -----" << endl;
 
+    // emit the aggregated statistics at the end of their period
+    for (unsigned int i = 0; i < aggregatedStatistics_.size(); i++)
+        aggregatedStatistics_[i]->tick();
+
     // extract pdus from all harqrxbuffers and pass them to unmaker
     HarqRxBuffers::iterator hit = harqRxBuffers_.begin();
     HarqRxBuffers::iterator het = harqRxBuffers_.end();
@@ -710,7 +520,7 @@ void LteMacVUeMode4::handleSelfMessage()
         }
         else if (expirationCounter_ <= 0)
         {
-            emit(grantBreak, 1);
+            grantBreak.emit(1);
             mode4Grant->setExpiration(0);
             expiredGrant_ = true;
         }
@@ -794,9 +604,7 @@ void LteMacVUeMode4::handleSelfMessage()
         }
         // Message that triggers flushing of Tx H-ARQ buffers for all users
         // This way, flushing is performed after the (possible) reception of new MAC PDUs
-        cMessage* flushHarqMsg = new cMessage("flushHarqMsg");
-        flushHarqMsg->setSchedulingPriority(1);        // after other messages
-        scheduleAt(NOW, flushHarqMsg);
+        flushHarqTimer_->trigger();
     }
     //============================ DEBUG ==========================
     HarqTxBuffers::iterator it;
@@ -860,14 +668,14 @@ void LteMacVUeMode4::macHandleSps(cPacket* pkt)
     // Gives us the time at which we will send the subframe.
     simtime_t selectedStartTime = (simTime() + SimTime(std::get<1>(selectedCR), SIMTIME_MS) - TTI).trunc(SIMTIME_MS);
 
-    emit(grantStartTime, selectedStartTime);
+    grantStartTime.emit(selectedStartTime);
 
     int initiailSubchannel = std::get<2>(selectedCR);
     int finalSubchannel = initiailSubchannel + mode4Grant->getNumSubchannels(); // Is this actually one additional subchannel?
 
     // Emit statistic about the use of resources, i.e. the initial subchannel and it's length.
-    emit(selectedSubchannelIndex, initiailSubchannel);
-    emit(selectedNumSubchannels, mode4Grant->getNumSubchannels());
+    selectedSubchannelIndex.emit(initiailSubchannel);
+    selectedNumSubchannels.emit(mode4Grant->getNumSubchannels());
 
     // Determine the RBs on which we will send our message
     RbMap grantedBlocks;
@@ -891,19 +699,9 @@ void LteMacVUeMode4::macHandleSps(cPacket* pkt)
     mode4Grant->setStartingSubchannel(initiailSubchannel);
     mode4Grant->setMcs(maxMCSPSSCH_);
 
-    LteMod mod = _QPSK;
-    if (maxMCSPSSCH_ > 9 && maxMCSPSSCH_ < 17)
-    {
-        mod = _16QAM;
-    }
-    else if (maxMCSPSSCH_ > 16 && maxMCSPSSCH_ < 29 )
-    {
-        mod = _64QAM;
-    }
-
-    unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
-
-    const unsigned int* tbsVect = itbs2tbs(mod, SINGLE_ANTENNA_PORT0, 1, maxMCSPSSCH_ - i);
+    const unsigned int* tbsVect = sidelinkConfig_->getTbsPerMcs().at(maxMCSPSSCH_);
+    if (tbsVect == NULL)
+        throw cRuntimeError("LteMacVUeMode4::macHandleSps - no TBS table for MCS %d", maxMCSPSSCH_);
     maximumCapacity_ = tbsVect[totalGrantedBlocks-1];
     mode4Grant->setGrantedCwBytes(currentCw_, maximumCapacity_);
     // Simply flips the codeword.
@@ -935,34 +733,19 @@ void LteMacVUeMode4::macGenerateSchedulingGrant(double maximumLatency, int prior
     mode4Grant -> setSpsPriority(priority);
     mode4Grant -> setPeriod(resourceReservationInterval_ * 100);
     mode4Grant -> setMaximumLatency(maximumLatency);
-    mode4Grant -> setPossibleRRIs(validResourceReservationIntervals_);
+    mode4Grant -> setPossibleRRIs(sidelinkConfig_->getResourceReservationIntervals());
 
     int minSubchannelNumberPSSCH = minSubchannelNumberPSSCH_;
     int maxSubchannelNumberPSSCH = maxSubchannelNumberPSSCH_;
 
     if (useCBR_)
     {
-        int cbrMinSubchannelNum;
-        int cbrMaxSubchannelNum;
-        std::unordered_map<std::string,double> cbrMap = cbrPSSCHTxConfigList_.at(currentCbrIndex_);
+        const SidelinkTxParams& cbrParams = sidelinkConfig_->getCbrTxConfig(currentCbrIndex_).params;
 
-        std::unordered_map<std::string,double>::const_iterator got = cbrMap.find("allowedRetxNumberPSSCH");
-        if ( got == cbrMap.end() )
-            allowedRetxNumberPSSCH_ = allowedRetxNumberPSSCH_;
-        else
-            allowedRetxNumberPSSCH_ = min((int)got->second, allowedRetxNumberPSSCH_);
-
-        got = cbrMap.find("minSubchannel-NumberPSSCH");
-        if ( got == cbrMap.end() )
-            cbrMinSubchannelNum = minSubchannelNumberPSSCH_;
-        else
-            cbrMinSubchannelNum = (int)got->second;
+        allowedRetxNumberPSSCH_ = min(cbrParams.allowedRetx, allowedRetxNumberPSSCH_);
 
-        got = cbrMap.find("maxSubchannel-NumberPSSCH");
-        if ( got == cbrMap.end() )
-            cbrMaxSubchannelNum = maxSubchannelNumberPSSCH_;
-        else
-            cbrMaxSubchannelNum = (int)got->second;
+        int cbrMinSubchannelNum = cbrParams.minSubchannels;
+        int cbrMaxSubchannelNum = cbrParams.maxSubchannels;
 
         /**
          * Need to pick the number of subchannels for this reservation
@@ -1004,7 +787,7 @@ void LteMacVUeMode4::macGenerateSchedulingGrant(double maximumLatency, int prior
 
     schedulingGrant_ = mode4Grant;
 
-    emit(grantRequests, 1);
+    grantRequests.emit(1);
 }
 
 void LteMacVUeMode4::flushHarqBuffers()
@@ -1020,22 +803,14 @@ void LteMacVUeMode4::flushHarqBuffers()
     HarqTxBuffers::iterator it2;
     for(it2 = harqTxBuffers_.begin(); it2 != harqTxBuffers_.end(); it2++)
     {
-        std::unordered_map<std::string,double> cbrMap = cbrPSSCHTxConfigList_.at(currentCbrIndex_);
-        std::unordered_map<std::string,double>::const_iterator got;
+        const SidelinkCbrTxConfig& cbrTxConfig = sidelinkConfig_->getCbrTxConfig(currentCbrIndex_);
 
         if (packetDropping_) {
-            double crLimit;
-            got = cbrMap.find("cr-Limit");
-            if (got == cbrMap.end())
-                crLimit = 1;
-            else
-                crLimit = got->second;
-
-            if (channelOccupancyRatio_ > crLimit) {
+            if (channelOccupancyRatio_ > cbrTxConfig.crLimit) {
                 // Need to drop the unit currently selected
                 UnitList ul = it2->second->firstAvailable();
                 it2->second->forceDropProcess(ul.first);
-                emit(packetDropDCC, 1);
+                packetDropDCC.emit(1);
             }
         }
 
@@ -1050,20 +825,8 @@ void LteMacVUeMode4::flushHarqBuffers()
                 if (pduLength > 0)
                 {
                     if (useCBR_){
-                        int cbrMinMCS;
-                        int cbrMaxMCS;
-
-                        got = cbrMap.find("minMCS-PSSCH");
-                        if ( got == cbrMap.end() )
-                            cbrMinMCS = minMCSPSSCH_;
-                        else
-                            cbrMinMCS = (int)got->second;
-
-                        got = cbrMap.find("maxMCS-PSSCH");
-                        if ( got == cbrMap.end() )
-                            cbrMaxMCS = maxMCSPSSCH_;
-                        else
-                            cbrMaxMCS = (int)got->second;
+                        int cbrMinMCS = cbrTxConfig.params.minMcs;
+                        int cbrMaxMCS = cbrTxConfig.params.maxMcs;
 
                         if (maxMCSPSSCH_ < cbrMinMCS || cbrMaxMCS < minMCSPSSCH_)
                         {
@@ -1081,23 +844,13 @@ void LteMacVUeMode4::flushHarqBuffers()
                     bool foundValidMCS = false;
                     int totalGrantedBlocks = mode4Grant->getTotalGrantedBlocks();
 
+                    const std::vector<const unsigned int*>& tbsPerMcs = sidelinkConfig_->getTbsPerMcs();
                     int mcsCapacity = 0;
-                    for (int mcs=minMCS; mcs <= maxMCS; mcs++)
+                    for (int mcs=minMCS; mcs <= maxMCS && mcs < (int) tbsPerMcs.size(); mcs++)
                     {
-                        LteMod mod = _QPSK;
-                        if (maxMCSPSSCH_ > 9 && maxMCSPSSCH_ < 17)
-                        {
-                            mod = _16QAM;
-                        }
-                        else if (maxMCSPSSCH_ > 16 && maxMCSPSSCH_ < 29 )
-                        {
-                            mod = _64QAM;
-                        }
-
-                        unsigned int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
-
-                        const unsigned int* tbsVect = itbs2tbs(mod, SINGLE_ANTENNA_PORT0, 1, mcs - i);
-                        mcsCapacity = tbsVect[totalGrantedBlocks-1];
+                        if (tbsPerMcs[mcs] == NULL)
+                            continue;
+                        mcsCapacity = tbsPerMcs[mcs][totalGrantedBlocks-1];
 
                         if (mcsCapacity > pduLength)
                         {
@@ -1135,7 +888,7 @@ void LteMacVUeMode4::flushHarqBuffers()
 
                             missedTransmissions_ = 0;
 
-                            emit(selectedMCS, mcs);
+                            selectedMCS.emit(mcs);
 
                             break;
                         }
@@ -1149,8 +902,8 @@ void LteMacVUeMode4::flushHarqBuffers()
                         simtime_t elapsedTime = NOW - receivedTime_;
                         remainingTime_ -= elapsedTime.dbl();
 
-                        emit(grantBreakSize, pduLength);
-                        emit(maximumCapacity, mcsCapacity);
+                        grantBreakSize.emit(pduLength);
+                        maximumCapacity.emit(mcsCapacity);
 
                         if (remainingTime_ <= 0)
                         {
@@ -1174,7 +927,7 @@ void LteMacVUeMode4::flushHarqBuffers()
         {
             // if no transmission check if we need to break the grant.
             ++missedTransmissions_;
-            emit(missedTransmission, 1);
+            missedTransmission.emit(1);
 
             LteMode4SchedulingGrant* phyGrant = mode4Grant->dup();
 
@@ -1197,7 +950,7 @@ void LteMacVUeMode4::flushHarqBuffers()
                 schedulingGrant_ = NULL;
                 missedTransmissions_ = 0;
 
-                emit(grantBreakMissedTrans, 1);
+                grantBreakMissedTrans.emit(1);
             }
 
             // Send Grant to PHY layer for sci creation
@@ -1214,6 +967,9 @@ void LteMacVUeMode4::flushHarqBuffers()
 
 void LteMacVUeMode4::finish()
 {
+    for (unsigned int i = 0; i < aggregatedStatistics_.size(); i++)
+        aggregatedStatistics_[i]->flush();
+
     binder_->removeUeInfo(ueInfo_);
 
     delete preconfiguredTxParams_;
@@ -21,6 +21,8 @@
 
 #include "stack/mac/layer/LteMacUeRealisticD2D.h"
 #include "corenetwork/deployer/LteDeployer.h"
+#include "common/LteStatistic.h"
+#include "stack/mac/layer/SidelinkConfiguration.h"
 #include <unordered_map>
 
 //class LteMode4SchedulingGrant;
@@ -55,7 +57,6 @@ protected:
    int maximumCapacity_;
    int allowedRetxNumberPSSCH_;
    int reselectAfter_;
-   int defaultCbrIndex_;
    int currentCbrIndex_;
    double channelOccupancyRatio_;
    double cbr_;
@@ -70,10 +71,9 @@ protected:
 
    std::map<UnitList, int> pduRecord_;
 
-   std::vector<std::unordered_map<std::string, double>> cbrPSSCHTxConfigList_;
-   std::vector<std::unordered_map<std::string, double>> cbrLevels_;
+   // sidelink configuration, shared with the other UEs
+   const SidelinkConfiguration* sidelinkConfig_;
    std::unordered_map<double, int> previousTransmissions_;
-   std::vector<double> validResourceReservationIntervals_;
 
    McsTable dlMcsTable_;
    McsTable ulMcsTable_;
@@ -91,20 +91,23 @@ protected:
 
    UeInfo* ueInfo_;
 
-   simsignal_t grantStartTime;
-   simsignal_t grantBreak;
-   simsignal_t grantBreakTiming;
-   simsignal_t grantBreakSize;
-   simsignal_t droppedTimeout;
-   simsignal_t grantBreakMissedTrans;
-   simsignal_t missedTransmission;
-   simsignal_t selectedMCS;
-   simsignal_t selectedNumSubchannels;
-   simsignal_t selectedSubchannelIndex;
-   simsignal_t maximumCapacity;
-   simsignal_t grantRequests;
-   simsignal_t packetDropDCC;
-   simsignal_t macNodeID;
+   LteStatistic grantStartTime;
+   LteStatistic grantBreak;
+   LteStatistic grantBreakTiming;
+   LteStatistic grantBreakSize;
+   LteStatistic droppedTimeout;
+   LteStatistic grantBreakMissedTrans;
+   LteStatistic missedTransmission;
+   LteStatistic selectedMCS;
+   LteStatistic selectedNumSubchannels;
+   LteStatistic selectedSubchannelIndex;
+   LteStatistic maximumCapacity;
+   LteStatistic grantRequests;
+   LteStatistic packetDropDCC;
+   LteStatistic macNodeID;
+
+   // aggregated statistics with listeners, ticked every TTI (see LteStatistic::tick())
+   std::vector<LteStatistic*> aggregatedStatistics_;
 
 //   // Lte AMC module
 //   LteAmc *amc_;
@@ -157,21 +160,6 @@ protected:
      */
     virtual void macPduMake();
 
-    /**
-     * Parse transmission configuration for a Ue
-     */
-    void parseUeTxConfig(cXMLElement* xmlConfig);
-
-    /**
-     * Parse transmission configuration for CBR
-     */
-    void parseCbrTxConfig(cXMLElement* xmlConfig);
-
-    /**
-     * Parse transmission configuration for Resource Reservation Intervals
-     */
-    void parseRriConfig(cXMLElement* xmlConfig);
-
     /**
      * Purges PDUs from the HARQ buffers for sending to the PHY layer.
      */
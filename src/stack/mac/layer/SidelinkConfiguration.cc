@@ -0,0 +1,224 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "stack/mac/layer/SidelinkConfiguration.h"
+#include "stack/mac/amc/LteMcs.h"
+
+SidelinkConfiguration::SidelinkConfiguration(cXMLElement* xmlConfig, const SidelinkTxParams& defaults)
+{
+    xml_ = xmlConfig;
+    defaults_ = defaults;
+    defaultCbrIndex_ = 0;
+
+    parseUeTxConfig(xmlConfig);
+    parseCbrTxConfig(xmlConfig);
+    parseRriConfig(xmlConfig);
+}
+
+void SidelinkConfiguration::parseUeTxConfig(cXMLElement* xmlConfig)
+{
+    if (xmlConfig == 0)
+    throw cRuntimeError("No sidelink configuration file specified");
+
+    // Get channel Model field which contains parameters fields
+    cXMLElementList ueTxConfig = xmlConfig->getElementsByTagName("userEquipment-txParameters");
+
+    if (ueTxConfig.empty())
+        throw cRuntimeError("No userEquipment-txParameters configuration found in configuration file");
+
+    if (ueTxConfig.size() > 1)
+        throw cRuntimeError("More than one userEquipment-txParameters configuration found in configuration file.");
+
+    cXMLElement* ueTxConfigData = ueTxConfig.front();
+
+    ParameterMap params;
+    getParametersFromXML(ueTxConfigData, params);
+
+    ParameterMap::iterator it = params.find("minMCS-PSSCH");
+    if (it != params.end())
+        ueTxParams_.minMcs = (int)it->second;
+    else
+        ueTxParams_.minMcs = defaults_.minMcs;
+    it = params.find("maxMCS-PSSCH");
+    if (it != params.end())
+        ueTxParams_.maxMcs = (int)it->second;
+    else
+        ueTxParams_.maxMcs = defaults_.minMcs;
+
+    // all the MCSs are used with the modulation of the maximum one
+    LteMod mod = _QPSK;
+    if (ueTxParams_.maxMcs > 9 && ueTxParams_.maxMcs < 17)
+    {
+        mod = _16QAM;
+    }
+    else if (ueTxParams_.maxMcs > 16 && ueTxParams_.maxMcs < 29 )
+    {
+        mod = _64QAM;
+    }
+    int i = (mod == _QPSK ? 0 : (mod == _16QAM ? 9 : (mod == _64QAM ? 15 : 0)));
+    // the tables of the modulation have 10 (QPSK), 7 (16QAM) and 12 (64QAM) rows: MCSs past the last one stay NULL
+    int last = (mod == _QPSK ? 9 : (mod == _16QAM ? 15 : 26));
+    tbsPerMcs_.assign(29, NULL);
+    for (int mcs = i; mcs <= last; mcs++)
+        tbsPerMcs_[mcs] = itbs2tbs(mod, SINGLE_ANTENNA_PORT0, 1, mcs - i);
+
+    it = params.find("minSubchannel-NumberPSSCH");
+    if (it != params.end())
+        ueTxParams_.minSubchannels = (int)it->second;
+    else
+        ueTxParams_.minSubchannels = defaults_.minSubchannels;
+    it = params.find("maxSubchannel-NumberPSSCH");
+    if (it != params.end())
+        ueTxParams_.maxSubchannels = (int)it->second;
+    else
+        ueTxParams_.maxSubchannels = defaults_.maxSubchannels;
+    it = params.find("allowedRetxNumberPSSCH");
+    if (it != params.end())
+        ueTxParams_.allowedRetx = (int)it->second;
+    else
+        ueTxParams_.allowedRetx = defaults_.allowedRetx;
+}
+
+void SidelinkConfiguration::parseCbrTxConfig(cXMLElement* xmlConfig)
+{
+    // Get channel Model field which contains parameters fields
+    cXMLElementList cbrTxConfig = xmlConfig->getElementsByTagName("Sl-CBR-CommonTxConfigList");
+
+    if (cbrTxConfig.empty())
+        throw cRuntimeError("No Sl-CBR-CommonTxConfigList found in configuration file");
+
+    cXMLElement* cbrTxConfigData = cbrTxConfig.front();
+
+    ParameterMap params;
+    getParametersFromXML(cbrTxConfigData, params);
+
+    ParameterMap::iterator it = params.find("default-cbr-ConfigIndex");
+    if (it != params.end())
+        defaultCbrIndex_ = (int)it->second;
+
+    cXMLElementList cbrLevelConfigs = xmlConfig->getElementsByTagName("cbr-ConfigIndex");
+
+    if (cbrLevelConfigs.empty())
+        throw cRuntimeError("No cbr-Levels-Config found in configuration file");
+
+    cXMLElementList::iterator xmlIt;
+    for(xmlIt = cbrLevelConfigs.begin(); xmlIt != cbrLevelConfigs.end(); xmlIt++)
+    {
+        ParameterMap cbrLevelsParams;
+        getParametersFromXML((*xmlIt), cbrLevelsParams);
+
+        ParameterMap::iterator lower = cbrLevelsParams.find("cbr-lower");
+        ParameterMap::iterator upper = cbrLevelsParams.find("cbr-upper");
+        ParameterMap::iterator index = cbrLevelsParams.find("cbr-PSSCH-TxConfig-Index");
+        if (lower == cbrLevelsParams.end() || upper == cbrLevelsParams.end() || index == cbrLevelsParams.end())
+            throw cRuntimeError("cbr-ConfigIndex %d needs cbr-lower, cbr-upper and cbr-PSSCH-TxConfig-Index",
+                (int)cbrLevels_.size());
+
+        SidelinkCbrLevel level;
+        level.lower = (double)lower->second;
+        level.upper = (double)upper->second;
+        level.txConfigIndex = (int)(double)index->second;
+        cbrLevels_.push_back(level);
+    }
+
+    cXMLElementList cbrTxConfigs = xmlConfig->getElementsByTagName("cbr-PSSCH-TxConfig");
+
+    if (cbrTxConfigs.empty())
+        throw cRuntimeError("No CBR-TxConfig found in configuration file");
+
+    cXMLElementList cbrTxParams = xmlConfig->getElementsByTagName("txParameters");
+
+    for(xmlIt = cbrTxParams.begin(); xmlIt != cbrTxParams.end(); xmlIt++)
+    {
+        SidelinkCbrTxConfig txConfig;
+        ParameterMap cbrParams;
+        getParametersFromXML((*xmlIt), cbrParams);
+        it = cbrParams.find("minMCS-PSSCH");
+        if (it != cbrParams.end())
+            txConfig.params.minMcs = (int)it->second;
+        else
+            txConfig.params.minMcs = defaults_.minMcs;
+        it = cbrParams.find("maxMCS-PSSCH");
+        if (it != cbrParams.end())
+            txConfig.params.maxMcs = (int)it->second;
+        else
+            txConfig.params.maxMcs = defaults_.maxMcs;
+        it = cbrParams.find("minSubchannel-NumberPSSCH");
+        if (it != cbrParams.end())
+            txConfig.params.minSubchannels = (int)it->second;
+        else
+            txConfig.params.minSubchannels = defaults_.minSubchannels;
+        it = cbrParams.find("maxSubchannel-NumberPSSCH");
+        if (it != cbrParams.end())
+            txConfig.params.maxSubchannels = (int)it->second;
+        else
+            txConfig.params.maxSubchannels = defaults_.maxSubchannels;
+        it = cbrParams.find("allowedRetxNumberPSSCH");
+        if (it != cbrParams.end())
+            txConfig.params.allowedRetx = (int)it->second;
+        else
+            txConfig.params.allowedRetx = defaults_.allowedRetx;
+        it = cbrParams.find("cr-Limit");
+        if (it != cbrParams.end())
+            txConfig.crLimit = (double)it->second;
+        else
+            txConfig.crLimit = 1;
+        cbrTxConfigs_.push_back(txConfig);
+    }
+}
+
+void SidelinkConfiguration::parseRriConfig(cXMLElement* xmlConfig)
+{
+    // Get channel Model field which contains parameters fields
+    cXMLElementList rriConfig = xmlConfig->getElementsByTagName("RestrictResourceReservationPeriodList");
+
+    if (rriConfig.empty())
+        throw cRuntimeError("No RestrictResourceReservationPeriodList found in configuration file");
+
+    cXMLElementList rriConfigs = xmlConfig->getElementsByTagName("RestrictResourceReservationPeriod");
+
+    if (rriConfigs.empty())
+        throw cRuntimeError("No RestrictResourceReservationPeriods found in configuration file");
+
+    cXMLElementList::iterator xmlIt;
+    for(xmlIt = rriConfigs.begin(); xmlIt != rriConfigs.end(); xmlIt++)
+    {
+        ParameterMap rriParams;
+        getParametersFromXML((*xmlIt), rriParams);
+        ParameterMap::iterator it = rriParams.find("rri");
+        if (it != rriParams.end())
+        {
+            resourceReservationIntervals_.push_back(it->second);
+        }
+    }
+}
+
+int SidelinkConfiguration::getCbrTxConfigIndex(double cbr) const
+{
+    std::vector<SidelinkCbrLevel>::const_iterator it;
+    for (it = cbrLevels_.begin(); it != cbrLevels_.end(); it++)
+    {
+        if (it->lower == 0)
+        {
+            if (cbr < it->upper)
+                return it->txConfigIndex;
+        }
+        else if (it->upper == 1)
+        {
+            if (cbr > it->lower)
+                return it->txConfigIndex;
+        }
+        else
+        {
+            if (cbr > it->lower && cbr <= it->upper)
+                return it->txConfigIndex;
+        }
+    }
+    return defaultCbrIndex_;
+}
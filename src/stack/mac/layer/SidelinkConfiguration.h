@@ -0,0 +1,120 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_SIDELINKCONFIGURATION_H_
+#define _LTE_SIDELINKCONFIGURATION_H_
+
+#include "common/LteCommon.h"
+
+/// PSSCH transmission parameters
+struct SidelinkTxParams
+{
+    int minMcs;
+    int maxMcs;
+    int minSubchannels;
+    int maxSubchannels;
+    int allowedRetx;
+
+    bool operator==(const SidelinkTxParams& other) const
+    {
+        return minMcs == other.minMcs && maxMcs == other.maxMcs && minSubchannels == other.minSubchannels
+            && maxSubchannels == other.maxSubchannels && allowedRetx == other.allowedRetx;
+    }
+};
+
+/// CBR range and the transmission configuration to be used within it (cbr-ConfigIndex)
+struct SidelinkCbrLevel
+{
+    double lower;
+    double upper;
+    int txConfigIndex;
+};
+
+/// Transmission configuration of a CBR level (cbr-PSSCH-TxConfig)
+struct SidelinkCbrTxConfig
+{
+    SidelinkTxParams params;
+    // channel occupancy ratio limit, 1 if not configured
+    double crLimit;
+};
+
+/**
+ * Sidelink transmission configuration of the Mode4 UEs, compiled from the XML
+ * configuration (see sidelink_configuration.xml).
+ *
+ * It is built once by the binder for each configuration and set of default
+ * parameters (see LteBinder::getSidelinkConfiguration()), then shared read-only
+ * by all the UEs using them.
+ */
+class SidelinkConfiguration
+{
+    // UE transmission parameters (userEquipment-txParameters)
+    SidelinkTxParams ueTxParams_;
+
+    // single layer TBS row of each MCS up to 28 (NULL if not in the tables of the modulation of the maximum UE MCS)
+    std::vector<const unsigned int*> tbsPerMcs_;
+
+    // CBR levels and their transmission configurations (Sl-CBR-CommonTxConfigList)
+    int defaultCbrIndex_;
+    std::vector<SidelinkCbrLevel> cbrLevels_;
+    std::vector<SidelinkCbrTxConfig> cbrTxConfigs_;
+
+    // valid resource reservation intervals (RestrictResourceReservationPeriodList)
+    std::vector<double> resourceReservationIntervals_;
+
+    cXMLElement* xml_;
+    SidelinkTxParams defaults_;
+
+    void parseUeTxConfig(cXMLElement* xmlConfig);
+    void parseCbrTxConfig(cXMLElement* xmlConfig);
+    void parseRriConfig(cXMLElement* xmlConfig);
+
+  public:
+    /*
+     * Compile the given XML configuration. The defaults are used for the parameters
+     * missing in it (i.e. those of the NED parameters of the MAC)
+     */
+    SidelinkConfiguration(cXMLElement* xmlConfig, const SidelinkTxParams& defaults);
+
+    // true if this has been compiled from the given configuration and defaults
+    bool matches(cXMLElement* xmlConfig, const SidelinkTxParams& defaults) const
+    {
+        return xml_ == xmlConfig && defaults_ == defaults;
+    }
+
+    const SidelinkTxParams& getUeTxParams() const
+    {
+        return ueTxParams_;
+    }
+
+    const std::vector<const unsigned int*>& getTbsPerMcs() const
+    {
+        return tbsPerMcs_;
+    }
+
+    int getDefaultCbrIndex() const
+    {
+        return defaultCbrIndex_;
+    }
+
+    // index of the transmission configuration of the first CBR level containing cbr, the default one if none
+    int getCbrTxConfigIndex(double cbr) const;
+
+    const SidelinkCbrTxConfig& getCbrTxConfig(int index) const
+    {
+        return cbrTxConfigs_.at(index);
+    }
+
+    const std::vector<double>& getResourceReservationIntervals() const
+    {
+        return resourceReservationIntervals_;
+    }
+};
+
+#endif
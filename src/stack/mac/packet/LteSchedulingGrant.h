@@ -280,7 +280,7 @@ public:
     {
         return possibleRRIs;
     }
-    void setPossibleRRIs(std::vector<double> RRIs)
+    void setPossibleRRIs(const std::vector<double>& RRIs)
     {
         this->possibleRRIs = RRIs;
     }
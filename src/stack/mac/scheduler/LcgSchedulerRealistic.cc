@@ -223,11 +223,8 @@ LcgSchedulerRealistic::schedule(unsigned int availableBytes, Direction grantDir)
 
                     availableBytes -= toServe;
 
-                    while (!vQueue->isEmpty())
-                    {
-                        // remove SDUs from virtual buffer
-                        vQueue->popFront();
-                    }
+                    // remove SDUs from virtual buffer
+                    vQueue->clear();
 
                     toServe = 0;
 
@@ -262,22 +259,8 @@ LcgSchedulerRealistic::schedule(unsigned int availableBytes, Direction grantDir)
                         elem->sentSdus_++;
 
                     // update buffer
-                    while (alloc > 0)
-                    {
-                        // update pkt info
-                        PacketInfo newPktInfo = vQueue->popFront();
-                        if (newPktInfo.first > alloc)
-                        {
-                            newPktInfo.first = newPktInfo.first - alloc;
-                            vQueue->pushFront(newPktInfo);
-                            alloc = 0;
-                        }
-                        else
-                        {
-                            alloc -= newPktInfo.first;
-                        }
-
-                    }
+                    if (alloc > 0)
+                        vQueue->consumeBytes(alloc);
 
                     toServe -= availableBytes;
                     availableBytes = 0;
@@ -10,12 +10,28 @@
 #include "stack/mac/scheduler/LteScheduler.h"
 #include "stack/mac/scheduler/LteSchedulerEnb.h"
 #include "stack/mac/scheduler/LteSchedulerEnbUl.h"
+#include <limits>
 
 /**
  * TODO:
  * - rimuovere i commenti dalle funzioni quando saranno implementate nel enb scheduler
  */
 
+void LteScheduler::removeActiveConnections(MacNodeId nodeId)
+{
+    // the CIDs of a node are contiguous
+    MacCid firstCid = idToMacCid(nodeId, 0);
+    MacCid lastCid = idToMacCid(nodeId, std::numeric_limits<LogicalCid>::max());
+
+    ActiveSet::iterator it = activeConnectionSet_.lower_bound(firstCid);
+    while (it != activeConnectionSet_.end() && *it <= lastCid)
+    {
+        MacCid cid = *it;
+        ++it;   // cid is erased from the active set
+        removeActiveConnection(cid);
+    }
+}
+
 void LteScheduler::setEnbScheduler(LteSchedulerEnb* eNbScheduler)
 {
     eNbScheduler_ = eNbScheduler;
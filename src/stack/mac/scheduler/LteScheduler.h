@@ -159,6 +159,9 @@ class LteScheduler
     {
     }
 
+    /// removes the active connections of the given node, through removeActiveConnection()
+    void removeActiveConnections(MacNodeId nodeId);
+
     virtual void updateSchedulingInfo()
     {
     }
@@ -27,6 +27,7 @@ LteSchedulerEnb::LteSchedulerEnb()
     mac_ = 0;
     allocator_ = 0;
     scheduler_ = 0;
+    counterRng_ = 0;
     vbuf_ = 0;
     harqTxBuffers_ = 0;
     harqRxBuffers_ = 0;
@@ -46,6 +47,7 @@ LteSchedulerEnb::~LteSchedulerEnb()
     delete allocator_;
     if(scheduler_)
         delete scheduler_;
+    delete counterRng_;
 }
 
 void LteSchedulerEnb::initialize(Direction dir, LteMacEnb* mac)
@@ -67,6 +69,9 @@ void LteSchedulerEnb::initialize(Direction dir, LteMacEnb* mac)
     scheduler_ = getScheduler(discipline);
     scheduler_->setEnbScheduler(this);
 
+    if (mac_->par("schedulingCounterRng").boolValue())
+        counterRng_ = new LteCounterRng(binder_->getCounterRngSeed());
+
     // Create Allocator
     if (discipline == ALLOCATOR_BESTFIT)   // NOTE: create this type of allocator for every scheduler using Frequency Reuse
         allocator_ = new LteAllocationModuleFrequencyReuse(mac_, direction_);
@@ -108,6 +113,15 @@ LteMacScheduleList* LteSchedulerEnb::schedule()
 
     // record assigned resource blocks statistics
     resourceBlockStatistics();
+
+    // publish the DL band occupancy, used for inter-cell interference evaluation
+    if (direction_ == DL)
+    {
+        unsigned int numBands = mac_->getDeployer()->getNumBands();
+        std::vector<bool>& occupied = binder_->newBandOccupancy(mac_->getMacNodeId(), numBands);
+        for (unsigned int b = 0; b < numBands; b++)
+            occupied[b] = (allocator_->getAllocatedBlocks(MAIN_PLANE, MACRO, b) != 0);
+    }
     return &scheduleList_;
 }
 
@@ -549,16 +563,7 @@ unsigned int LteSchedulerEnb::scheduleGrant(MacCid cid, unsigned int bytes,
 //                        conn->front().first = (vQueueFrontSize-toServe);
 
                         // just decrementing the first element is not correct because the queueOccupancy would not be updated
-                        // we need to pop the element from the queue and then push it again with a new value
-                        unsigned int newSize = conn->front().first - (toServe-MAC_HEADER-RLC_HEADER_UM);
-                        PacketInfo info = conn->popFront();
-
-                        // push the element only if the size is > 0
-                        if (newSize > 0)
-                        {
-                            info.first = newSize;
-                            conn->pushFront(info);
-                        }
+                        conn->consumeBytes(toServe-MAC_HEADER-RLC_HEADER_UM);
                     }
                     else
                     {
@@ -903,16 +908,5 @@ ActiveSet LteSchedulerEnb::readActiveConnections()
 
 void LteSchedulerEnb::removeActiveConnections(MacNodeId nodeId)
 {
-    ActiveSet active = scheduler_->readActiveSet();
-    ActiveSet::iterator it = active.begin();
-    ActiveSet::iterator et = active.end();
-    MacCid cid;
-    for (; it != et; ++it)
-    {
-        cid = *it;
-        if (MacCidToNodeId(cid) == nodeId)
-        {
-            scheduler_->removeActiveConnection(cid);
-        }
-    }
+    scheduler_->removeActiveConnections(nodeId);
 }
@@ -13,6 +13,7 @@
 #include "common/LteCommon.h"
 #include "stack/mac/buffer/harq/LteHarqBufferTx.h"
 #include "stack/mac/allocator/LteAllocatorUtils.h"
+#include "common/LteCounterRng.h"
 
 /// forward declarations
 class LteScheduler;
@@ -77,6 +78,9 @@ class LteSchedulerEnb
     // Scheduling agent.
     LteScheduler *scheduler_;
 
+    // Counter-based RNG of the scheduling agent (NULL unless schedulingCounterRng is set)
+    LteCounterRng *counterRng_;
+
     // Operational Direction. Set via initialize().
     Direction direction_;
 
@@ -431,26 +431,7 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
         else if (connDesc.getRlcType() == AM)
             alloc -= RLC_HEADER_AM;
         // alloc is the number of effective bytes allocated (without overhead)
-        while (!conn->isEmpty() && alloc > 0)
-        {
-            unsigned int vPktSize = conn->front().first;
-            if (vPktSize <= alloc)
-            {
-                // serve the entire vPkt
-                conn->popFront();
-                alloc -= vPktSize;
-            }
-            else
-            {
-                // serve partial vPkt
-
-                // update pkt info
-                PacketInfo newPktInfo = conn->popFront();
-                newPktInfo.first = newPktInfo.first - alloc;
-                conn->pushFront(newPktInfo);
-                alloc = 0;
-            }
-        }
+        conn->consumeBytes(alloc);
 
         EV << "LteSchedulerEnbDlRealistic::grant Codeword allocation: " << cwAllocatedBytes << "bytes" << endl;
 
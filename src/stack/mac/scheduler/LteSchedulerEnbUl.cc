@@ -48,7 +48,9 @@ LteSchedulerEnbUl::updateHarqDescs()
     HarqRxBuffers::iterator it;
     HarqStatus::iterator currentStatus;
 
-    for (it=harqRxBuffers_->begin();it!=harqRxBuffers_->end();++it)
+    round_++;
+
+    for (it=harqRxBuffers_->begin();it!=harqRxBuffers_->end();)
     {
         if ((currentStatus=harqStatus_.find(it->first)) != harqStatus_.end())
         {
@@ -63,9 +65,35 @@ LteSchedulerEnbUl::updateHarqDescs()
             EV << NOW << "LteSchedulerEnbUl::updateHarqDescs UE " << it->first << " initialized the H-ARQ status " << endl;
             harqStatus_[it->first]=0;
         }
+        ++it;
     }
 }
 
+unsigned long LteSchedulerEnbUl::rtxRound(MacNodeId nodeId, unsigned char acid, unsigned int processes, bool next)
+{
+    HarqStatus::iterator currentStatus = harqStatus_.find(nodeId);
+    // the status is initialized in the next round, check again then
+    if (currentStatus == harqStatus_.end())
+        return round_ + 1;
+
+    // rounds until (current process + 2) is acid
+    unsigned int wait = (acid + 2 * processes - 2 - currentStatus->second) % processes;
+    if (wait == 0 && next)
+        wait = processes;
+    return round_ + wait;
+}
+
+void LteSchedulerEnbUl::signalRtx(MacNodeId nodeId, unsigned char acid)
+{
+    HarqRxBuffers::iterator it = harqRxBuffers_->find(nodeId);
+    if (it == harqRxBuffers_->end())
+        return;
+
+    // if the process is due in the current round after rtxschedule() has run, it is
+    // checked in the next round and queued again from there
+    rtxQueue_[rtxRound(nodeId, acid, it->second->getProcesses(), false)].insert(nodeId);
+}
+
 bool LteSchedulerEnbUl::racschedule()
 {
     EV << NOW << " LteSchedulerEnbUl::racschedule --------------------::[ START RAC-SCHEDULE ]::--------------------" << endl;
@@ -141,68 +169,42 @@ LteSchedulerEnbUl::rtxschedule()
         EV << NOW << " LteSchedulerEnbUl::rtxschedule eNodeB: " << mac_->getMacCellId() << endl;
         EV << NOW << " LteSchedulerEnbUl::rtxschedule Direction: " << (direction_ == UL ? "UL" : "DL") << endl;
 
-        HarqRxBuffers::iterator it= harqRxBuffers_->begin() , et=harqRxBuffers_->end();
+        // only the UEs with a process due in this round can retransmit: they are
+        // served in the order of their H-ARQ buffers
+        std::set<MacNodeId> rtxNodes;
+        RtxQueue::iterator qt = rtxQueue_.begin();
+        while (qt != rtxQueue_.end() && qt->first <= round_)
+        {
+            rtxNodes.insert(qt->second.begin(), qt->second.end());
+            rtxQueue_.erase(qt++);
+        }
 
-        for(; it != et; ++it)
+        std::set<MacNodeId>::iterator nit = rtxNodes.begin(), net = rtxNodes.end();
+        for(; nit != net; ++nit)
         {
             // get current nodeId
-            MacNodeId nodeId = it->first;
+            MacNodeId nodeId = *nit;
 
-            if(nodeId == 0){
-                // UE has left the simulation - erase queue and continue
-                harqRxBuffers_->erase(nodeId);
+            HarqRxBuffers::iterator it = harqRxBuffers_->find(nodeId);
+            if (it == harqRxBuffers_->end())
                 continue;
-            }
-            OmnetId id = binder_->getOmnetId(nodeId);
-            if(id == 0){
-                harqRxBuffers_->erase(nodeId);
-                continue;
-            }
 
-            // get current Harq Process for nodeId
-            unsigned char currentAcid = harqStatus_.at(nodeId);
+            schedulePerNodeRtx(nodeId, it->second);
 
-            // check whether the UE has a H-ARQ process waiting for retransmission. If not, skip UE.
-            bool skip = true;
-            unsigned char acid = (currentAcid + 2) % (it->second->getProcesses());
-            LteHarqProcessRx* currentProcess = it->second->getProcess(acid);
-            std::vector<RxUnitStatus> procStatus = currentProcess->getProcessStatus();
-            std::vector<RxUnitStatus>::iterator pit = procStatus.begin();
-            for (; pit != procStatus.end(); ++pit )
+            // processes still waiting for retransmission are checked again when they are due
+            unsigned int processes = it->second->getProcesses();
+            for (unsigned char acid = 0; acid < processes; ++acid)
             {
-                if (pit->second == RXHARQ_PDU_CORRUPTED)
-                {
-                    skip = false;
-                    break;
-                }
-            }
-            if (skip)
-                continue;
-
-            EV << NOW << "LteSchedulerEnbUl::rtxschedule UE: " << nodeId << "Acid: " << (unsigned int)currentAcid << endl;
-
-            // Get user transmission parameters
-            const UserTxParams& txParams = mac_->getAmc()->computeTxParams(nodeId, direction_);// get the user info
-
-            unsigned int codewords = txParams.getLayers().size();// get the number of available codewords
-            unsigned int allocatedBytes =0;
-
-            // TODO handle the codewords join case (sizeof(cw0+cw1) < currentTbs && currentLayers ==1)
-
-            for(Codeword cw = 0; (cw < MAX_CODEWORDS) && (codewords>0); ++cw)
-            {
-                unsigned int rtxBytes=0;
-                // FIXME PERFORMANCE: check for rtx status before calling rtxAcid
-
-                // perform a retransmission on available codewords for the selected acid
-                rtxBytes=LteSchedulerEnbUl::schedulePerAcidRtx(nodeId, cw,currentAcid);
-                if (rtxBytes>0)
+                LteHarqProcessRx* process = it->second->getProcess(acid);
+                for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
                 {
-                    --codewords;
-                    allocatedBytes+=rtxBytes;
+                    if (process->getUnitStatus(cw) == RXHARQ_PDU_CORRUPTED)
+                    {
+                        rtxQueue_[rtxRound(nodeId, acid, processes, true)].insert(nodeId);
+                        break;
+                    }
                 }
             }
-            EV << NOW << "LteSchedulerEnbUl::rtxschedule user " << nodeId << " allocated bytes : " << allocatedBytes << endl;
         }
 
         if (mac_->isD2DCapable())
@@ -288,6 +290,55 @@ LteSchedulerEnbUl::rtxschedule()
     return 0;
 }
 
+void
+LteSchedulerEnbUl::schedulePerNodeRtx(MacNodeId nodeId, LteHarqBufferRx* buffer)
+{
+    // get current Harq Process for nodeId
+    unsigned char currentAcid = harqStatus_.at(nodeId);
+
+    // check whether the UE has a H-ARQ process waiting for retransmission. If not, skip UE.
+    bool skip = true;
+    unsigned char acid = (currentAcid + 2) % (buffer->getProcesses());
+    LteHarqProcessRx* currentProcess = buffer->getProcess(acid);
+    std::vector<RxUnitStatus> procStatus = currentProcess->getProcessStatus();
+    std::vector<RxUnitStatus>::iterator pit = procStatus.begin();
+    for (; pit != procStatus.end(); ++pit )
+    {
+        if (pit->second == RXHARQ_PDU_CORRUPTED)
+        {
+            skip = false;
+            break;
+        }
+    }
+    if (skip)
+        return;
+
+    EV << NOW << "LteSchedulerEnbUl::rtxschedule UE: " << nodeId << "Acid: " << (unsigned int)currentAcid << endl;
+
+    // Get user transmission parameters
+    const UserTxParams& txParams = mac_->getAmc()->computeTxParams(nodeId, direction_);// get the user info
+
+    unsigned int codewords = txParams.getLayers().size();// get the number of available codewords
+    unsigned int allocatedBytes =0;
+
+    // TODO handle the codewords join case (sizeof(cw0+cw1) < currentTbs && currentLayers ==1)
+
+    for(Codeword cw = 0; (cw < MAX_CODEWORDS) && (codewords>0); ++cw)
+    {
+        unsigned int rtxBytes=0;
+        // FIXME PERFORMANCE: check for rtx status before calling rtxAcid
+
+        // perform a retransmission on available codewords for the selected acid
+        rtxBytes=LteSchedulerEnbUl::schedulePerAcidRtx(nodeId, cw,currentAcid);
+        if (rtxBytes>0)
+        {
+            --codewords;
+            allocatedBytes+=rtxBytes;
+        }
+    }
+    EV << NOW << "LteSchedulerEnbUl::rtxschedule user " << nodeId << " allocated bytes : " << allocatedBytes << endl;
+}
+
 unsigned int
 LteSchedulerEnbUl::schedulePerAcidRtx(MacNodeId nodeId, Codeword cw, unsigned char acid,
     std::vector<BandLimit>* bandLim, Remote antenna, bool limitBl)
@@ -658,3 +709,8 @@ void LteSchedulerEnbUl::removePendingRac(MacNodeId nodeId)
 {
     racStatus_.erase(nodeId);
 }
+
+void LteSchedulerEnbUl::removeHarqStatus(MacNodeId nodeId)
+{
+    harqStatus_.erase(nodeId);
+}
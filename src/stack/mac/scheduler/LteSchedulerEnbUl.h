@@ -23,6 +23,7 @@ class LteSchedulerEnbUl : public LteSchedulerEnb
 
     typedef std::map<MacNodeId, unsigned char> HarqStatus;
     typedef std::map<MacNodeId, bool> RacStatus;
+    typedef std::map<unsigned long, std::set<MacNodeId> > RtxQueue;
 
     /// Minimum scheduling unit, represents the MAC SDU size
     unsigned int scheduleUnit_;
@@ -43,8 +44,42 @@ class LteSchedulerEnbUl : public LteSchedulerEnb
     //! RAC requests flags: signals wheter an UE shall be granted the RAC allocation
     RacStatus racStatus_;
 
+    //! Number of calls to updateHarqDescs(), i.e. of scheduling rounds
+    unsigned long round_;
+
+    //! UEs with a H-ARQ process waiting for retransmission, by round in which the process is considered
+    RtxQueue rtxQueue_;
+
+    /**
+     * Returns the first round in which the given process is the one considered for
+     * retransmission, i.e. the current process plus two.
+     *
+     * @param nodeId The node ID
+     * @param acid The ACID
+     * @param processes number of H-ARQ processes of the node
+     * @param next if true, the current round is excluded
+     */
+    unsigned long rtxRound(MacNodeId nodeId, unsigned char acid, unsigned int processes, bool next);
+
+    /**
+     * Schedules the retransmission of the current process (plus two) of the given UE, if it
+     * waits for one, on all the available codewords.
+     *
+     * @param nodeId The node ID
+     * @param buffer The H-ARQ RX buffer of the node
+     */
+    void schedulePerNodeRtx(MacNodeId nodeId, LteHarqBufferRx* buffer);
+
   public:
 
+    /**
+     * Default Constructor.
+     */
+    LteSchedulerEnbUl()
+    {
+        round_ = 0;
+    }
+
     //! Updates HARQ descriptor current process pointer (to be called every TTI by main loop).
     void updateHarqDescs();
 
@@ -68,6 +103,12 @@ class LteSchedulerEnbUl : public LteSchedulerEnb
         racStatus_[nodeId] = true;
     }
 
+    /**
+     * signals that the given process of an UE waits for retransmission
+     * (called by eNb when the NACK is sent)
+     */
+    virtual void signalRtx(MacNodeId nodeId, unsigned char acid);
+
     /**
      * Schedules retransmission for the Harq Process of the given UE on a set of logical bands.
      * Each band has also assigned a band limit amount of bytes: no more than the specified
@@ -88,6 +129,9 @@ class LteSchedulerEnbUl : public LteSchedulerEnb
     virtual void initHarqStatus(MacNodeId id, unsigned char acid);
 
     void removePendingRac(MacNodeId nodeId);
+
+    //! Forgets the H-ARQ process counter of the given UE (e.g. when it leaves the simulation)
+    void removeHarqStatus(MacNodeId nodeId);
 };
 
 #endif // _LTE_LTE_SCHEDULER_ENB_UL_H_
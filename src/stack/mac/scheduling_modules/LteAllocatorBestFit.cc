@@ -16,52 +16,6 @@ LteAllocatorBestFit::LteAllocatorBestFit()
 {
 }
 
-void LteAllocatorBestFit::checkHole(Candidate& candidate, Band holeIndex, unsigned int holeLen, unsigned int req)
-{
-    if (holeLen > req)
-    {
-        // this hole would satisfy requested load
-        if (!candidate.greater)
-        {
-            // The current candidate would not satisfy the requested load.
-            // The hole is a better candidate. Update
-            candidate.greater = true;
-            candidate.index = holeIndex;
-            candidate.len = holeLen;
-        }
-        else
-        {   // The current candidate would satisfy the requested load.
-            // compare the length of the hole with that of the best candidate
-            if (candidate.len > holeLen)
-            {
-                // the hole is a better candidate. Update
-                candidate.greater = true;
-                candidate.index = holeIndex;
-                candidate.len = holeLen;
-            }
-        }
-    }
-    else
-    {
-        // this hole would NOT satisfy requested load
-        if (!candidate.greater)
-        {
-            // The current candidate would not satisfy the requested load.
-            // compare the length of the hole with that of the best candidate
-            if (candidate.len < holeLen)
-            {
-                // the hole is a better candidate. Update
-                candidate.greater = false;
-                candidate.index = holeIndex;
-                candidate.len = holeLen;
-            }
-        }
-        // else do not update. The current candidate would satisfy the requested load.
-    }
-//       std::cout << " New candidate is: index[" << candidate.index << "], len["<< candidate.len << "]" << endl;
-
-}
-
 void LteAllocatorBestFit::prepareSchedule()
 {
     EV << NOW << " LteAllocatorBestFit::schedule " << eNbScheduler_->mac_->getMacNodeId() << endl;
@@ -88,8 +42,11 @@ void LteAllocatorBestFit::prepareSchedule()
     // Get the active connection Set
     activeConnectionTempSet_ = activeConnectionSet_;
 
-    // Create a Conflict Map wich, for every nodeId, have a set of conflicting nodes
-    const std::map<MacNodeId,std::set<MacNodeId> >* conflictMap = mac_->getMeshMaster()->getConflictMap();
+    // Get the total number of bands
+    unsigned int numBands = mac_->getDeployer()->getNumBands();
+
+    // Build the free holes of the subframe
+    initFreeRuns(alreadyAllocatedBands, firstUnallocatedBand, firstUnallocatedBandIM, numBands);
 
     // record the amount of allocated bytes (for optimal comparison)
     unsigned int totalAllocatedBytes = 0;
@@ -256,9 +213,6 @@ void LteAllocatorBestFit::prepareSchedule()
         // This calculus is for coherence with the allocation done in the ScheduleGrant function
         req_RBs = (vQueueFrontSize+req_Bytes1RB-1)/req_Bytes1RB;
 
-        // Get the total number of bands
-        unsigned int numBands = mac_->getDeployer()->getNumBands();
-
         unsigned int blocks = 0;
         // Set the band counter to zero
         int band=0;
@@ -274,148 +228,20 @@ void LteAllocatorBestFit::prepareSchedule()
         candidate.len = 0;
         candidate.greater = false;
 
-        // info for the current hole considered
-        bool newHole = true;
-        Band holeIndex = 0;
-        unsigned int holeLen = 0;
-
         // TODO: Find a better way to allocate IM from the end of the frame
         if (enableFrequencyReuse || dir == D2D_MULTI)
         {
-//            std::cout << NOW << " UE " << nodeId << " is D2D enabled" << endl;
-
-            // Check if the allocation is possible starting from the first unallocated band
-            for( band=firstUnallocatedBand; band<numBands; band++ )
-            {
-                bool jump_band = false;
-                // Jump to the next band if this have been already allocated
-                if( alreadyAllocatedBands.find(band) != alreadyAllocatedBands.end() ) { jump_band = true; }
-                /*
-                 * Jump to the next band if:
-                 * - dedicated is true
-                 * - the node is a D2D one
-                 * - the band is occupied by an INFRASTRCUCTURE node.
-                 *  If dedicated is "false" a D2D UE can
-                 * share a band with one or more INFRASTRUCTURE UEs.
-                 */
-                if( enableFrequencyReuse && bandStatusMap_[band].first == CELLT && dedicated_ ) { jump_band = true; }
-                /*
-                 * Jump to the next band if the current band is occupied by a conflicting node (i.e. there's an edge in the
-                 * conflict graph)
-                 */
-                if( conflictMap->find(nodeId)!=conflictMap->end() )
-                {
-                    std::set<MacNodeId>::const_iterator conf_it = conflictMap->find(nodeId)->second.begin();
-                    std::set<MacNodeId>::const_iterator conf_et = conflictMap->find(nodeId)->second.end();
-                    for(;conf_it!=conf_et;++conf_it)
-                    {
-                        // Check if this band is occupied by an interfering node for the nodeId
-                        if(bandStatusMap_[band].second.find(*conf_it) != bandStatusMap_[band].second.end())
-                        {
-                            // Set jump_band to "true" cause we have to jump to the next band
-                            jump_band = true;
-                            break;
-                        }
-                    }
-                }
-
-                // Check if this band is occupied by a node for whom the nodeId is an interfering node
-                std::set<MacNodeId>::const_iterator it =  bandStatusMap_[band].second.begin();
-                for(;it!=bandStatusMap_[band].second.end();++it)
-                {
-                    if(conflictMap->find(*it)!=conflictMap->end())
-                    {
-                        if(conflictMap->find(*it)->second.find(nodeId)!=conflictMap->find(*it)->second.end())
-                        {
-                            jump_band = true;
-                            break;
-                        }
-                    }
-                }
-
-                if(jump_band)
-                {
-//                    std::cout << NOW << " UE " << nodeId << " --- skipping band " << band << endl;
-
-                    if (!newHole)
-                    {
-                        // found a hole <holeIndex,holeLen>
-                        checkHole(candidate, holeIndex, holeLen, req_RBs);
-
-                        // reset
-                        newHole = true;
-                        holeIndex = 0;
-                        holeLen = 0;
-                    }
-                    jump_band = false;
-                    continue;
-                }
-
-
-                // Going here means that this band can be allocated
-                if (newHole)
-                {
-                    holeIndex = band;
-                    newHole = false;
-                }
-                holeLen++;
-
-            }
+            // Skip the bands occupied by nodes conflicting with nodeId (i.e. there's an edge in the conflict graph)
+            std::map<MacNodeId, LteFreeRunIndex>::const_iterator rt = conflictRuns_.find(nodeId);
+            const LteFreeRunIndex& runs = (rt != conflictRuns_.end()) ? rt->second : (enableFrequencyReuse ? d2dRuns_ : sharedRuns_);
+            runs.bestFit(req_RBs, false, candidate.index, candidate.len);
         }
         else
         {
-            bool jump_band = false;
-
             // Check if the allocation is possible starting from the first unallocated band (going back)
-            for( band=firstUnallocatedBandIM; band>=0; band-- )
-            {
-                // Jump to the next band if this have been already allocated
-                if( alreadyAllocatedBands.find(band) != alreadyAllocatedBands.end() ) jump_band = true;
-                /*
-                 * Jump to the next band if the node is on Infrastructure and the band is already
-                 * allocated to an Infrastructure node (As standard, the same bands are not shared
-                 *  between two,or more, nodes in Infrastructure mode).
-                 */
-                if( !enableFrequencyReuse && bandStatusMap_[band].first == CELLT ) jump_band = true;
-                /*
-                 * Jump to the next band if:
-                 * - the node is an Infrastructure one
-                 * - dedicated is true
-                 * - the band is occupied by a D2D node.
-                 *  If dedicated is "false" an Infrastructure UE can share a band with one or more D2D UEs.
-                 */
-                if( !enableFrequencyReuse && bandStatusMap_[band].first == D2DT && dedicated_ ) jump_band = true;
-
-
-                if(jump_band)
-                {
-                    if (!newHole)
-                    {
-                        // found a hole <holeIndex,holeLen>
-                        checkHole(candidate, holeIndex, holeLen, req_RBs);
-
-                        // reset
-                        newHole = true;
-                        holeIndex = 0;
-                        holeLen = 0;
-                    }
-
-                    jump_band = false;
-                    continue;
-                }
-
-                // Going here means that this band can be allocated
-                if (newHole)
-                {
-                    holeIndex = band;
-                    newHole = false;
-                }
-                holeLen++;
-
-            }
+            cellRuns_.bestFit(req_RBs, true, candidate.index, candidate.len);
         }
-
-        checkHole(candidate, holeIndex, holeLen, req_RBs);
+        candidate.greater = (candidate.len > req_RBs);
 
         if (enableFrequencyReuse || dir == D2D_MULTI)
         {
@@ -569,10 +395,89 @@ void LteAllocatorBestFit::initAndReset()
 
 void LteAllocatorBestFit::setAllocationType(std::vector<Band> bookedBands,AllocationUeType type,MacNodeId nodeId)
 {
+    // UEs that can no longer use the booked bands because of a conflict with nodeId
+    std::map<MacNodeId, std::set<MacNodeId> >::const_iterator nt = conflictNeighbours_.find(nodeId);
+    if (nt != conflictNeighbours_.end())
+    {
+        std::set<MacNodeId>::const_iterator jt = nt->second.begin();
+        for (; jt != nt->second.end(); ++jt)
+        {
+            if (conflictRuns_.find(*jt) != conflictRuns_.end())
+                continue;
+            if (binder_->isFrequencyReuseEnabled(*jt))
+            {
+                conflictRuns_[*jt] = d2dRuns_;
+                conflictRunsReuse_.insert(*jt);
+            }
+            else
+            {
+                conflictRuns_[*jt] = sharedRuns_;
+            }
+        }
+    }
+
     std::vector<Band>::iterator it = bookedBands.begin();
     for(;it!=bookedBands.end();++it)
     {
         bandStatusMap_[*it].first = type;
         bandStatusMap_[*it].second.insert(nodeId);
+
+        /*
+         * As standard, the same bands are not shared between two, or more, nodes in Infrastructure mode.
+         * If dedicated is "true", D2D and Infrastructure nodes do not share bands either, unless the
+         * D2D node does not use frequency reuse (i.e. its multicast flows)
+         */
+        if (type == CELLT || dedicated_)
+            cellRuns_.book(*it);
+        if (type == CELLT && dedicated_)
+        {
+            d2dRuns_.book(*it);
+            std::set<MacNodeId>::const_iterator rt = conflictRunsReuse_.begin();
+            for (; rt != conflictRunsReuse_.end(); ++rt)
+                conflictRuns_[*rt].book(*it);
+        }
+        if (nt != conflictNeighbours_.end())
+        {
+            std::set<MacNodeId>::const_iterator jt = nt->second.begin();
+            for (; jt != nt->second.end(); ++jt)
+                conflictRuns_[*jt].book(*it);
+        }
+    }
+}
+
+void LteAllocatorBestFit::initFreeRuns(const std::set<Band>& alreadyAllocatedBands, Band firstUnallocatedBand,
+    int firstUnallocatedBandIM, unsigned int numBands)
+{
+    // bands occupied by RAC and RTX cannot be used by anyone
+    std::vector<bool> free(std::max(numBands, (unsigned int) (firstUnallocatedBandIM + 1)), true);
+    std::set<Band>::const_iterator it = alreadyAllocatedBands.begin();
+    for (; it != alreadyAllocatedBands.end(); ++it)
+    {
+        if (*it < free.size())
+            free[*it] = false;
+    }
+
+    d2dRuns_.clear();
+    if (firstUnallocatedBand < numBands)
+        d2dRuns_.build(free, firstUnallocatedBand, numBands - 1);
+    sharedRuns_ = d2dRuns_;
+    cellRuns_.clear();
+    if (firstUnallocatedBandIM >= 0)
+        cellRuns_.build(free, 0, firstUnallocatedBandIM);
+    conflictRuns_.clear();
+    conflictRunsReuse_.clear();
+
+    // Create a Conflict Map wich, for every nodeId, have a set of conflicting nodes
+    const std::map<MacNodeId,std::set<MacNodeId> >* conflictMap = mac_->getMeshMaster()->getConflictMap();
+    conflictNeighbours_.clear();
+    std::map<MacNodeId,std::set<MacNodeId> >::const_iterator ct = conflictMap->begin();
+    for (; ct != conflictMap->end(); ++ct)
+    {
+        std::set<MacNodeId>::const_iterator jt = ct->second.begin();
+        for (; jt != ct->second.end(); ++jt)
+        {
+            conflictNeighbours_[ct->first].insert(*jt);
+            conflictNeighbours_[*jt].insert(ct->first);
+        }
     }
 }
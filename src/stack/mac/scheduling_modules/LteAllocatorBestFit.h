@@ -13,6 +13,7 @@
 #include "stack/mac/scheduler/LteScheduler.h"
 #include "stack/mac/allocator/LteAllocatorUtils.h"
 #include "stack/mac/allocator/LteAllocationModule.h"
+#include "stack/mac/allocator/LteFreeRunIndex.h"
 
 struct Candidate {
     Band index;
@@ -54,13 +55,30 @@ class LteAllocatorBestFit : public virtual LteScheduler
      * Parameter that specify if the Allocator puts D2D and Infrastructure UEs on dedicated resources
      */
     bool dedicated_;
-    /**
-     * Enumerator specified for the return of mutualExclusiveAllocation() function.
-     * @see mutualExclusiveAllocation()
-     */
 
-    // returns the next "hole" in the subframe where the UEs can be eventually allocated
-    void checkHole(Candidate& candidate, Band holeIndex, unsigned int holeLen, unsigned int req);
+    /*
+     * Free "holes" of the subframe, kept up to date by setAllocationType():
+     * - d2dRuns_ for D2D (and multicast) flows of UEs using frequency reuse, allocated from the start
+     *   of the frame. It does not account for conflicts, since bands can be reused by non-conflicting UEs
+     * - sharedRuns_ as d2dRuns_, for the multicast flows of UEs not using frequency reuse: these share
+     *   the bands of infrastructure flows even if dedicated_ is set
+     * - conflictRuns_ for the D2D flows of UEs conflicting with an already allocated UE, created
+     *   as a copy of d2dRuns_ (or sharedRuns_) when the first conflicting UE is allocated
+     * - cellRuns_ for infrastructure flows, allocated from the end of the frame
+     */
+    LteFreeRunIndex d2dRuns_;
+    LteFreeRunIndex sharedRuns_;
+    LteFreeRunIndex cellRuns_;
+    std::map<MacNodeId, LteFreeRunIndex> conflictRuns_;
+    // UEs of conflictRuns_ using frequency reuse
+    std::set<MacNodeId> conflictRunsReuse_;
+
+    // for each UE, the UEs that cannot share a band with it (edges of the conflict graph in either direction)
+    std::map<MacNodeId, std::set<MacNodeId> > conflictNeighbours_;
+
+    // build the free holes and the conflict neighbours at the beginning of the TTI
+    void initFreeRuns(const std::set<Band>& alreadyAllocatedBands, Band firstUnallocatedBand, int firstUnallocatedBandIM,
+        unsigned int numBands);
 
 
   public:
@@ -35,14 +35,6 @@ void LtePf::prepareSchedule()
         MacCid cid = *cidIt;
         ++cidIt;
         MacNodeId nodeId = MacCidToNodeId(cid);
-        OmnetId id = binder_->getOmnetId(nodeId);
-        if(nodeId == 0 || id == 0)
-        {
-            // node has left the simulation - erase corresponding CIDs
-            activeConnectionSet_.erase(cid);
-            activeConnectionTempSet_.erase(cid);
-            continue;
-        }
 
         // if we are allocating the UL subframe, this connection may be either UL or D2D
         Direction dir;
@@ -51,13 +43,6 @@ void LtePf::prepareSchedule()
         else
             dir = DL;
 
-        // check if node is still a valid node in the simulation - might have been dynamically removed
-        if(getBinder()->getOmnetId(nodeId) == 0){
-            activeConnectionTempSet_.erase(cid);
-            EV << "CID " << cid << " of node "<< nodeId << " removed from active connection set - no OmnetId in Binder known.";
-            continue;
-        }
-
         // compute available blocks for the current user
         const UserTxParams& info = eNbScheduler_->mac_->getAmc()->computeTxParams(nodeId,dir);
         const std::set<Band>& bands = info.readBands();
@@ -94,7 +79,7 @@ void LtePf::prepareSchedule()
 
         if (pfRate_.find(cid)==pfRate_.end()) pfRate_[cid]=0;
         if(pfRate_[cid] < scoreEpsilon_) s = 1.0 / scoreEpsilon_;
-        else if(availableBlocks > 0) s = ((availableBytes / availableBlocks) / pfRate_[cid]) + uniform(getEnvir()->getRNG(0),-scoreEpsilon_/2.0, scoreEpsilon_/2.0);
+        else if(availableBlocks > 0) s = ((availableBytes / availableBlocks) / pfRate_[cid]) + scoreJitter(nodeId, cid, dir);
         else s = 0.0;
         // Create a new score descriptor for the connection, where the score is equal to the ratio between bytes per slot and long term rate
         ScoreDesc desc(cid,s);
@@ -149,6 +134,18 @@ void LtePf::prepareSchedule()
     }
 }
 
+double LtePf::scoreJitter(MacNodeId nodeId, MacCid cid, Direction dir)
+{
+    LteCounterRng* rng = eNbScheduler_->counterRng_;
+    if (rng == NULL)
+        return uniform(getEnvir()->getRNG(0),-scoreEpsilon_/2.0, scoreEpsilon_/2.0);
+
+    // same jitter for the same connection in the same TTI, whatever the order of the draws
+    LteRandomKey key(nodeId, eNbScheduler_->mac_->getMacNodeId(), 0, LteCounterRng::currentTti(), RANDOM_SCHEDULING_JITTER,
+        (dir << 8) | (MacCidToLcid(cid) & 0xFF));
+    return rng->uniform(key, -scoreEpsilon_/2.0, scoreEpsilon_/2.0);
+}
+
 void LtePf::commitSchedule()
 {
     unsigned int total = eNbScheduler_->resourceBlocks_;
@@ -32,6 +32,9 @@ class LtePf : public LteScheduler
     //! Small number to slightly blur away scores.
     const double scoreEpsilon_;
 
+    //! Random blur of the score of a connection, in [-scoreEpsilon_/2, scoreEpsilon_/2)
+    double scoreJitter(MacNodeId nodeId, MacCid cid, Direction dir);
+
   public:
 
     double & pfAlpha()
@@ -9,89 +9,156 @@
 
 #include "stack/pdcp_rrc/ConnectionsTable.h"
 
-ConnectionsTable::ConnectionsTable()
+/// Initial size of the table
+static const unsigned int INITIAL_TABLE_SIZE = 16;
+
+/// Unused entry: all fields equal to 0xFF
+static ConnectionsTable::entry_ emptyEntry()
 {
-    // Table is resetted by putting all fields equal to 0xFF
-    memset(ht_, 0xFF, sizeof(struct entry_) * TABLE_SIZE);
+    ConnectionsTable::entry_ entry;
+    memset(&entry, 0xFF, sizeof(entry));
+    entry.entity_ = NULL;
+    return entry;
 }
 
-unsigned int ConnectionsTable::hash_func(uint32_t srcAddr, uint32_t dstAddr,
-    uint16_t srcPort, uint16_t dstPort)
+ConnectionsTable::ConnectionsTable()
 {
-    return (srcPort | dstPort | srcAddr | dstAddr) % TABLE_SIZE;
+    ht_.assign(INITIAL_TABLE_SIZE, emptyEntry());
+    entries_ = 0;
 }
 
 unsigned int ConnectionsTable::hash_func(uint32_t srcAddr, uint32_t dstAddr,
     uint16_t srcPort, uint16_t dstPort, uint16_t dir)
 {
-    return (srcPort | dstPort | srcAddr | dstAddr | dir) % TABLE_SIZE;
+    // 64-bit finalizer of MurmurHash3 over the packed fields
+    uint64_t key = (((uint64_t) srcAddr << 32) | dstAddr)
+        ^ ((((uint64_t) srcPort << 32) | ((uint64_t) dstPort << 16) | dir) * 0x9E3779B97F4A7C15ULL);
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return key & (ht_.size() - 1);
 }
 
-LogicalCid ConnectionsTable::find_entry(uint32_t srcAddr, uint32_t dstAddr,
-    uint16_t srcPort, uint16_t dstPort)
+void ConnectionsTable::grow()
 {
-    int hashIndex = hash_func(srcAddr, dstAddr, srcPort, dstPort);
-    while (1)
+    std::vector<entry_> old;
+    old.swap(ht_);
+
+    // fill the larger table again
+    ht_.assign(old.size() * 2, emptyEntry());
+    for (unsigned int i = 0; i < old.size(); ++i)
     {
-        if (ht_[hashIndex].lcid_ == 0xFFFF)            // Entry not found
-            return 0xFFFF;
-        if (ht_[hashIndex].srcAddr_ == srcAddr &&
-            ht_[hashIndex].dstAddr_ == dstAddr &&
-            ht_[hashIndex].srcPort_ == srcPort &&
-            ht_[hashIndex].dstPort_ == dstPort)
-            return ht_[hashIndex].lcid_;                // Entry found
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
+        if (old[i].lcid_ == 0xFFFF)
+            continue;
+        unsigned int hashIndex = hash_func(old[i].srcAddr_, old[i].dstAddr_, old[i].srcPort_, old[i].dstPort_, old[i].dir_);
+        while (ht_[hashIndex].lcid_ != 0xFFFF)
+            hashIndex = (hashIndex + 1) & (ht_.size() - 1);
+        ht_[hashIndex] = old[i];
     }
 }
 
-LogicalCid ConnectionsTable::find_entry(uint32_t srcAddr, uint32_t dstAddr,
+void ConnectionsTable::remove_address(uint32_t addr, std::vector<LogicalCid>& lcids)
+{
+    unsigned int i;
+    for (i = 0; i < ht_.size(); ++i)
+    {
+        if (ht_[i].lcid_ != 0xFFFF && (ht_[i].srcAddr_ == addr || ht_[i].dstAddr_ == addr))
+            break;
+    }
+    if (i == ht_.size())
+        return;
+
+    std::vector<entry_> old;
+    old.swap(ht_);
+
+    // fill the table again with the other connections
+    ht_.assign(old.size(), emptyEntry());
+    for (i = 0; i < old.size(); ++i)
+    {
+        if (old[i].lcid_ == 0xFFFF)
+            continue;
+        if (old[i].srcAddr_ == addr || old[i].dstAddr_ == addr)
+        {
+            lcids.push_back(old[i].lcid_);
+            entries_--;
+            continue;
+        }
+        unsigned int hashIndex = hash_func(old[i].srcAddr_, old[i].dstAddr_, old[i].srcPort_, old[i].dstPort_, old[i].dir_);
+        while (ht_[hashIndex].lcid_ != 0xFFFF)
+            hashIndex = (hashIndex + 1) & (ht_.size() - 1);
+        ht_[hashIndex] = old[i];
+    }
+}
+
+ConnectionsTable::entry_* ConnectionsTable::find_flow(uint32_t srcAddr, uint32_t dstAddr,
     uint16_t srcPort, uint16_t dstPort, uint16_t dir)
 {
-    int hashIndex = hash_func(srcAddr, dstAddr, srcPort, dstPort, dir);
+    unsigned int hashIndex = hash_func(srcAddr, dstAddr, srcPort, dstPort, dir);
     while (1)
     {
-        if (ht_[hashIndex].lcid_ == 0xFFFF)            // Entry not found
-            return 0xFFFF;
-        if (ht_[hashIndex].srcAddr_ == srcAddr &&
-            ht_[hashIndex].dstAddr_ == dstAddr &&
-            ht_[hashIndex].srcPort_ == srcPort &&
-            ht_[hashIndex].dstPort_ == dstPort &&
-            ht_[hashIndex].dir_ == dir)
-            return ht_[hashIndex].lcid_;                // Entry found
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
+        entry_& entry = ht_[hashIndex];
+        if (entry.lcid_ == 0xFFFF)            // Entry not found
+            return NULL;
+        if (entry.srcAddr_ == srcAddr &&
+            entry.dstAddr_ == dstAddr &&
+            entry.srcPort_ == srcPort &&
+            entry.dstPort_ == dstPort &&
+            entry.dir_ == dir)
+            return &entry;                // Entry found
+        hashIndex = (hashIndex + 1) & (ht_.size() - 1);    // Linear scanning of the hash table
     }
 }
 
+LogicalCid ConnectionsTable::find_entry(uint32_t srcAddr, uint32_t dstAddr,
+    uint16_t srcPort, uint16_t dstPort)
+{
+    entry_* entry = find_flow(srcAddr, dstAddr, srcPort, dstPort);
+    return (entry == NULL) ? 0xFFFF : entry->lcid_;
+}
+
+LogicalCid ConnectionsTable::find_entry(uint32_t srcAddr, uint32_t dstAddr,
+    uint16_t srcPort, uint16_t dstPort, uint16_t dir)
+{
+    entry_* entry = find_flow(srcAddr, dstAddr, srcPort, dstPort, dir);
+    return (entry == NULL) ? 0xFFFF : entry->lcid_;
+}
+
+ConnectionsTable::entry_* ConnectionsTable::create_flow(uint32_t srcAddr, uint32_t dstAddr,
+    uint16_t srcPort, uint16_t dstPort, uint16_t dir, LogicalCid lcid)
+{
+    // keep the table at most half full
+    if (2 * (entries_ + 1) > ht_.size())
+        grow();
+    entries_++;
+
+    unsigned int hashIndex = hash_func(srcAddr, dstAddr, srcPort, dstPort, dir);
+    while (ht_[hashIndex].lcid_ != 0xFFFF)
+        hashIndex = (hashIndex + 1) & (ht_.size() - 1);    // Linear scanning of the hash table
+    entry_& entry = ht_[hashIndex];
+    entry.srcAddr_ = srcAddr;
+    entry.dstAddr_ = dstAddr;
+    entry.srcPort_ = srcPort;
+    entry.dstPort_ = dstPort;
+    entry.dir_ = dir;
+    entry.lcid_ = lcid;
+    entry.entity_ = NULL;
+    return &entry;
+}
+
 void ConnectionsTable::create_entry(uint32_t srcAddr, uint32_t dstAddr,
     uint16_t srcPort, uint16_t dstPort, LogicalCid lcid)
 {
-    int hashIndex = hash_func(srcAddr, dstAddr, srcPort, dstPort);
-    while (ht_[hashIndex].lcid_ != 0xFFFF)
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
-    ht_[hashIndex].srcAddr_ = srcAddr;
-    ht_[hashIndex].dstAddr_ = dstAddr;
-    ht_[hashIndex].srcPort_ = srcPort;
-    ht_[hashIndex].dstPort_ = dstPort;
-    ht_[hashIndex].lcid_ = lcid;
-    return;
+    create_flow(srcAddr, dstAddr, srcPort, dstPort, 0xFFFF, lcid);
 }
 
 void ConnectionsTable::create_entry(uint32_t srcAddr, uint32_t dstAddr,
     uint16_t srcPort, uint16_t dstPort, uint16_t dir, LogicalCid lcid)
 {
-    int hashIndex = hash_func(srcAddr, dstAddr, srcPort, dstPort, dir);
-    while (ht_[hashIndex].lcid_ != 0xFFFF)
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
-    ht_[hashIndex].srcAddr_ = srcAddr;
-    ht_[hashIndex].dstAddr_ = dstAddr;
-    ht_[hashIndex].srcPort_ = srcPort;
-    ht_[hashIndex].dstPort_ = dstPort;
-    ht_[hashIndex].dir_ = dir;
-    ht_[hashIndex].lcid_ = lcid;
-    return;
+    create_flow(srcAddr, dstAddr, srcPort, dstPort, dir, lcid);
 }
 
 ConnectionsTable::~ConnectionsTable()
 {
-    memset(ht_, 0xFF, sizeof(struct entry_) * TABLE_SIZE);
 }
@@ -10,11 +10,10 @@
 #ifndef _LTE_CONNECTIONSTABLE_H_
 #define _LTE_CONNECTIONSTABLE_H_
 
-/// This is the maximum number of allowed connections * 2
-#define TABLE_SIZE 2048
-
 #include "common/LteCommon.h"
 
+class LtePdcpEntity;
+
 /**
  * @class ConnectionsTable
  * @brief Hash table to keep track of connections
@@ -22,16 +21,42 @@
  * This is an hash table used by the RRC layer
  * to assign CIDs to different connections.
  * The table is in the format:
- *  __________________________________________________________
- * | srcAddr | dstAddr | srcPort | dstPort | Direction | LCID |
+ *  _____________________________________________________________________
+ * | srcAddr | dstAddr | srcPort | dstPort | Direction | LCID | PDCP entity |
  *
  * A 4-tuple (plus direction) is used to check if connection was already
  * established and return the proper LCID, otherwise a
- * new entry is added to the table
+ * new entry is added to the table.
+ *
+ * The table uses open addressing with linear probing, and doubles its size
+ * whenever it gets half full, so that lookups stay O(1) with any number of
+ * connections. Each entry also caches the PDCP entity of the connection,
+ * so that a packet of a known flow is classified with a single lookup.
  */
 class ConnectionsTable
 {
   public:
+    /**
+     * \struct entry
+     * \brief hash table entry
+     *
+     * This structure contains an entry of the
+     * connections hash table. It contains
+     * all fields of the 4-tuple, the direction (0xFFFF if
+     * not used), the associated LCID (Logical Connection ID)
+     * and the PDCP entity of the LCID (NULL until set by the PDCP).
+     */
+    struct entry_
+    {
+        uint32_t srcAddr_;
+        uint32_t dstAddr_;
+        uint16_t srcPort_;
+        uint16_t dstPort_;
+        uint16_t dir_;
+        LogicalCid lcid_;
+        LtePdcpEntity* entity_;
+    };
+
     ConnectionsTable();
     virtual ~ConnectionsTable();
 
@@ -66,6 +91,20 @@ class ConnectionsTable
     LogicalCid find_entry(uint32_t srcAddr, uint32_t dstAddr,
         uint16_t srcPort, uint16_t dstPort, uint16_t dir);
 
+    /**
+     * find_flow() returns the entry of a connection.
+     * The pointer is valid until the next entry is created.
+     *
+     * @param srcAddr part of 4-tuple
+     * @param dstAddr part of 4-tuple
+     * @param srcPort part of 4-tuple
+     * @param dstPort part of 4-tuple
+     * @param dir flow direction (DL/UL/D2D), 0xFFFF if not used
+     * @return the entry, NULL if no entry was found
+     */
+    entry_* find_flow(uint32_t srcAddr, uint32_t dstAddr,
+        uint16_t srcPort, uint16_t dstPort, uint16_t dir = 0xFFFF);
+
     /**
      * create_entry() adds a new entry to the table
      *
@@ -91,58 +130,59 @@ class ConnectionsTable
     void create_entry(uint32_t srcAddr, uint32_t dstAddr,
         uint16_t srcPort, uint16_t dstPort, uint16_t dir, LogicalCid lcid);
 
-  private:
     /**
-     * hash_func() calculates the hash function used
-     * by this structure. At the moment it's simply an OR
-     * operation between all fields of the 4-tuple
+     * create_flow() adds a new entry to the table and returns it.
+     * The pointer is valid until the next entry is created.
      *
      * @param srcAddr part of 4-tuple
      * @param dstAddr part of 4-tuple
      * @param srcPort part of 4-tuple
      * @param dstPort part of 4-tuple
+     * @param dir flow direction (DL/UL/D2D), 0xFFFF if not used
+     * @param LCID connection id to insert
+     * @return the new entry
      */
-    unsigned int hash_func(uint32_t srcAddr, uint32_t dstAddr,
-        uint16_t srcPort, uint16_t dstPort);
+    entry_* create_flow(uint32_t srcAddr, uint32_t dstAddr,
+        uint16_t srcPort, uint16_t dstPort, uint16_t dir, LogicalCid lcid);
+
+    /**
+     * remove_address() removes the connections from or to the
+     * given address, e.g. of a node leaving the simulation
+     *
+     * @param addr source or destination address of the connections
+     * @param lcids the LCIDs of the removed connections are appended here
+     */
+    void remove_address(uint32_t addr, std::vector<LogicalCid>& lcids);
 
+  private:
     /**
      * hash_func() calculates the hash function used
-     * by this structure. At the moment it's simply an OR
-     * operation between all fields of the 4-tuple
+     * by this structure, mixing all the fields of the
+     * 4-tuple and the direction
      *
      * @param srcAddr part of 4-tuple
      * @param dstAddr part of 4-tuple
      * @param srcPort part of 4-tuple
-     * @param dir flow direction (DL/UL/D2D)
      * @param dstPort part of 4-tuple
+     * @param dir flow direction (DL/UL/D2D)
      */
     unsigned int hash_func(uint32_t srcAddr, uint32_t dstAddr,
         uint16_t srcPort, uint16_t dstPort, uint16_t dir);
 
+    /**
+     * grow() doubles the size of the table
+     */
+    void grow();
+
     /*
      * Data Structures
      */
 
-    /**
-     * \struct entry
-     * \brief hash table entry
-     *
-     * This structure contains an entry of the
-     * connections hash table. It contains
-     * all fields of the 4-tuple and the
-     * associated LCID (Logical Connection ID).
-     */
-    struct entry_
-    {
-        uint32_t srcAddr_;
-        uint32_t dstAddr_;
-        uint16_t srcPort_;
-        uint16_t dstPort_;
-        uint16_t dir_;
-        LogicalCid lcid_;
-    };
-    /// Hash table of size TABLE_SIZE
-    entry_ ht_[TABLE_SIZE];
+    /// Hash table, its size is a power of two
+    std::vector<entry_> ht_;
+
+    /// Number of entries in use
+    unsigned int entries_;
 };
 
 #endif
@@ -9,75 +9,144 @@
 
 #include "stack/pdcp_rrc/NonIpConnectionsTable.h"
 
-NonIpConnectionsTable::NonIpConnectionsTable()
+/// Initial size of the table
+static const unsigned int INITIAL_TABLE_SIZE = 16;
+
+/// Unused entry: all fields equal to 0xFF
+static NonIpConnectionsTable::entry_ emptyEntry()
 {
-    // Table is resetted by putting all fields equal to 0xFF
-    memset(NonIpHt_, 0xFF, sizeof(struct entry_) * TABLE_SIZE);
+    NonIpConnectionsTable::entry_ entry;
+    memset(&entry, 0xFF, sizeof(entry));
+    entry.entity_ = NULL;
+    return entry;
 }
 
-unsigned int NonIpConnectionsTable::hash_func(long srcAddr, long dstAddr)
+NonIpConnectionsTable::NonIpConnectionsTable()
 {
-    return (srcAddr | dstAddr) % TABLE_SIZE;
+    NonIpHt_.assign(INITIAL_TABLE_SIZE, emptyEntry());
+    entries_ = 0;
 }
 
 unsigned int NonIpConnectionsTable::hash_func(long srcAddr, long dstAddr, uint16_t dir)
 {
-    return (srcAddr | dstAddr | dir) % TABLE_SIZE;
+    // 64-bit finalizer of MurmurHash3 over the fields
+    uint64_t key = (uint64_t) srcAddr ^ (((uint64_t) dstAddr << 16 | dir) * 0x9E3779B97F4A7C15ULL);
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return key & (NonIpHt_.size() - 1);
 }
 
-LogicalCid NonIpConnectionsTable::find_entry(long srcAddr, long dstAddr)
+void NonIpConnectionsTable::grow()
 {
-    int hashIndex = hash_func(srcAddr, dstAddr);
-    while (1)
+    std::vector<entry_> old;
+    old.swap(NonIpHt_);
+
+    // fill the larger table again
+    NonIpHt_.assign(old.size() * 2, emptyEntry());
+    for (unsigned int i = 0; i < old.size(); ++i)
     {
-        if (NonIpHt_[hashIndex].lcid_ == 0xFFFF)            // Entry not found
-            return 0xFFFF;
-        if (NonIpHt_[hashIndex].srcAddr_ == srcAddr &&
-            NonIpHt_[hashIndex].dstAddr_ == dstAddr)
-            return NonIpHt_[hashIndex].lcid_;                // Entry found
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
+        if (old[i].lcid_ == 0xFFFF)
+            continue;
+        unsigned int hashIndex = hash_func(old[i].srcAddr_, old[i].dstAddr_, old[i].dir_);
+        while (NonIpHt_[hashIndex].lcid_ != 0xFFFF)
+            hashIndex = (hashIndex + 1) & (NonIpHt_.size() - 1);
+        NonIpHt_[hashIndex] = old[i];
     }
 }
 
-LogicalCid NonIpConnectionsTable::find_entry(long srcAddr, long dstAddr, uint16_t dir)
+void NonIpConnectionsTable::remove_address(long addr, std::vector<LogicalCid>& lcids)
+{
+    unsigned int i;
+    for (i = 0; i < NonIpHt_.size(); ++i)
+    {
+        if (NonIpHt_[i].lcid_ != 0xFFFF && (NonIpHt_[i].srcAddr_ == addr || NonIpHt_[i].dstAddr_ == addr))
+            break;
+    }
+    if (i == NonIpHt_.size())
+        return;
+
+    std::vector<entry_> old;
+    old.swap(NonIpHt_);
+
+    // fill the table again with the other connections
+    NonIpHt_.assign(old.size(), emptyEntry());
+    for (i = 0; i < old.size(); ++i)
+    {
+        if (old[i].lcid_ == 0xFFFF)
+            continue;
+        if (old[i].srcAddr_ == addr || old[i].dstAddr_ == addr)
+        {
+            lcids.push_back(old[i].lcid_);
+            entries_--;
+            continue;
+        }
+        unsigned int hashIndex = hash_func(old[i].srcAddr_, old[i].dstAddr_, old[i].dir_);
+        while (NonIpHt_[hashIndex].lcid_ != 0xFFFF)
+            hashIndex = (hashIndex + 1) & (NonIpHt_.size() - 1);
+        NonIpHt_[hashIndex] = old[i];
+    }
+}
+
+NonIpConnectionsTable::entry_* NonIpConnectionsTable::find_flow(long srcAddr, long dstAddr, uint16_t dir)
 {
-    int hashIndex = hash_func(srcAddr, dstAddr, dir);
+    unsigned int hashIndex = hash_func(srcAddr, dstAddr, dir);
     while (1)
     {
-        if (NonIpHt_[hashIndex].lcid_ == 0xFFFF)            // Entry not found
-            return 0xFFFF;
-        if (NonIpHt_[hashIndex].srcAddr_ == srcAddr &&
-            NonIpHt_[hashIndex].dstAddr_ == dstAddr &&
-            NonIpHt_[hashIndex].dir_ == dir)
-            return NonIpHt_[hashIndex].lcid_;                // Entry found
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
+        entry_& entry = NonIpHt_[hashIndex];
+        if (entry.lcid_ == 0xFFFF)            // Entry not found
+            return NULL;
+        if (entry.srcAddr_ == srcAddr &&
+            entry.dstAddr_ == dstAddr &&
+            entry.dir_ == dir)
+            return &entry;                // Entry found
+        hashIndex = (hashIndex + 1) & (NonIpHt_.size() - 1);    // Linear scanning of the hash table
     }
 }
 
-void NonIpConnectionsTable::create_entry(long srcAddr, long dstAddr, LogicalCid lcid)
+LogicalCid NonIpConnectionsTable::find_entry(long srcAddr, long dstAddr)
+{
+    entry_* entry = find_flow(srcAddr, dstAddr);
+    return (entry == NULL) ? 0xFFFF : entry->lcid_;
+}
+
+LogicalCid NonIpConnectionsTable::find_entry(long srcAddr, long dstAddr, uint16_t dir)
 {
-    int hashIndex = hash_func(srcAddr, dstAddr);
+    entry_* entry = find_flow(srcAddr, dstAddr, dir);
+    return (entry == NULL) ? 0xFFFF : entry->lcid_;
+}
+
+NonIpConnectionsTable::entry_* NonIpConnectionsTable::create_flow(long srcAddr, long dstAddr, uint16_t dir, LogicalCid lcid)
+{
+    // keep the table at most half full
+    if (2 * (entries_ + 1) > NonIpHt_.size())
+        grow();
+    entries_++;
+
+    unsigned int hashIndex = hash_func(srcAddr, dstAddr, dir);
     while (NonIpHt_[hashIndex].lcid_ != 0xFFFF)
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
-    NonIpHt_[hashIndex].srcAddr_ = srcAddr;
-    NonIpHt_[hashIndex].dstAddr_ = dstAddr;
-    NonIpHt_[hashIndex].lcid_ = lcid;
-    return;
+        hashIndex = (hashIndex + 1) & (NonIpHt_.size() - 1);    // Linear scanning of the hash table
+    entry_& entry = NonIpHt_[hashIndex];
+    entry.srcAddr_ = srcAddr;
+    entry.dstAddr_ = dstAddr;
+    entry.dir_ = dir;
+    entry.lcid_ = lcid;
+    entry.entity_ = NULL;
+    return &entry;
+}
+
+void NonIpConnectionsTable::create_entry(long srcAddr, long dstAddr, LogicalCid lcid)
+{
+    create_flow(srcAddr, dstAddr, 0xFFFF, lcid);
 }
 
 void NonIpConnectionsTable::create_entry(long srcAddr, long dstAddr, uint16_t dir, LogicalCid lcid)
 {
-    int hashIndex = hash_func(srcAddr, dstAddr, dir);
-    while (NonIpHt_[hashIndex].lcid_ != 0xFFFF)
-        hashIndex = (hashIndex + 1) % TABLE_SIZE;    // Linear scanning of the hash table
-    NonIpHt_[hashIndex].srcAddr_ = srcAddr;
-    NonIpHt_[hashIndex].dstAddr_ = dstAddr;
-    NonIpHt_[hashIndex].dir_ = dir;
-    NonIpHt_[hashIndex].lcid_ = lcid;
-    return;
+    create_flow(srcAddr, dstAddr, dir, lcid);
 }
 
 NonIpConnectionsTable::~NonIpConnectionsTable()
 {
-    memset(NonIpHt_, 0xFF, sizeof(struct entry_) * TABLE_SIZE);
 }
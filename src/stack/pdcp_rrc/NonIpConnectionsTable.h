@@ -10,11 +10,10 @@
 #ifndef _LTE_NONIPCONNECTIONSTABLE_H_
 #define _LTE_NONIPCONNECTIONSTABLE_H_
 
-/// This is the maximum number of allowed connections * 2
-#define TABLE_SIZE 2048
-
 #include "common/LteCommon.h"
 
+class LtePdcpEntity;
+
 /**
  * @class NonIpConnectionsTable
  * @brief Hash table to keep track of connections
@@ -22,16 +21,38 @@
  * This is an hash table used by the RRC layer
  * to assign CIDs to different connections.
  * The table is in the format:
- *  __________________________________________________________
- * | srcAddr | dstAddr | srcPort | dstPort | Direction | LCID |
+ *  _______________________________________________
+ * | srcAddr | dstAddr | Direction | LCID | PDCP entity |
  *
  * A tuple (plus direction) is used to check if connection was already
  * established and return the proper LCID, otherwise a
- * new entry is added to the table
+ * new entry is added to the table.
+ *
+ * As ConnectionsTable, it uses open addressing, grows with the number
+ * of connections and caches the PDCP entity of each connection.
  */
 class NonIpConnectionsTable
 {
   public:
+    /**
+     * \struct entry
+     * \brief hash table entry
+     *
+     * This structure contains an entry of the
+     * connections hash table. It contains
+     * all fields of the tuple, the direction (0xFFFF if
+     * not used), the associated LCID (Logical Connection ID)
+     * and the PDCP entity of the LCID (NULL until set by the PDCP).
+     */
+    struct entry_
+    {
+        long srcAddr_;
+        long dstAddr_;
+        uint16_t dir_;
+        LogicalCid lcid_;
+        LtePdcpEntity* entity_;
+    };
+
     NonIpConnectionsTable();
     virtual ~NonIpConnectionsTable();
 
@@ -60,11 +81,22 @@ class NonIpConnectionsTable
      */
     LogicalCid find_entry(long srcAddr, long dstAddr, uint16_t dir);
 
+    /**
+     * find_flow() returns the entry of a connection.
+     * The pointer is valid until the next entry is created.
+     *
+     * @param srcAddr part of 2-tuple
+     * @param dstAddr part of 2-tuple
+     * @param dir flow direction (DL/UL/D2D), 0xFFFF if not used
+     * @return the entry, NULL if no entry was found
+     */
+    entry_* find_flow(long srcAddr, long dstAddr, uint16_t dir = 0xFFFF);
+
     /**
      * create_entry() adds a new entry to the table
      *
-     * @param srcAddr part of tuple
-     * @param dstAddr part of tuple
+     * @param srcAddr part of 2-tuple
+     * @param dstAddr part of 2-tuple
      * @param LCID connection id to insert
      */
     void create_entry(long srcAddr, long dstAddr, LogicalCid lcid);
@@ -72,58 +104,61 @@ class NonIpConnectionsTable
     /**
      * create_entry() adds a new entry to the table
      *
-     * @param srcAddr part of tuple
-     * @param dstAddr part of tuple
+     * @param srcAddr part of 2-tuple
+     * @param dstAddr part of 2-tuple
      * @param dir flow direction (DL/UL/D2D)
      * @param LCID connection id to insert
      */
     void create_entry(long srcAddr, long dstAddr,
          uint16_t dir, LogicalCid lcid);
 
-  private:
     /**
-     * hash_func() calculates the hash function used
-     * by this structure. At the moment it's simply an OR
-     * operation between all fields of the tuple
+     * create_flow() adds a new entry to the table and returns it.
+     * The pointer is valid until the next entry is created.
      *
-     * @param srcAddr part of tuple
-     * @param dstAddr part of tuple
+     * @param srcAddr part of 2-tuple
+     * @param dstAddr part of 2-tuple
+     * @param dir flow direction (DL/UL/D2D), 0xFFFF if not used
+     * @param LCID connection id to insert
+     * @return the new entry
      */
-    unsigned int hash_func(long srcAddr, long dstAddr);
+    entry_* create_flow(long srcAddr, long dstAddr, uint16_t dir, LogicalCid lcid);
 
+    /**
+     * remove_address() removes the connections from or to the
+     * given address, e.g. of a node leaving the simulation
+     *
+     * @param addr source or destination address of the connections
+     * @param lcids the LCIDs of the removed connections are appended here
+     */
+    void remove_address(long addr, std::vector<LogicalCid>& lcids);
+
+  private:
     /**
      * hash_func() calculates the hash function used
-     * by this structure. At the moment it's simply an OR
-     * operation between all fields of the tuple
+     * by this structure, mixing all the fields of the
+     * tuple and the direction
      *
-     * @param srcAddr part of tuple
-     * @param dstAddr part of tuple
+     * @param srcAddr part of 2-tuple
+     * @param dstAddr part of 2-tuple
      * @param dir flow direction (DL/UL/D2D)
      */
     unsigned int hash_func(long srcAddr, long dstAddr, uint16_t dir);
 
+    /**
+     * grow() doubles the size of the table
+     */
+    void grow();
+
     /*
      * Data Structures
      */
 
-    /**
-     * \struct entry
-     * \brief hash table entry
-     *
-     * This structure contains an entry of the
-     * connections hash table. It contains
-     * all fields of the tuple and the
-     * associated LCID (Logical Connection ID).
-     */
-    struct entry_
-    {
-        long srcAddr_;
-        long dstAddr_;
-        uint16_t dir_;
-        LogicalCid lcid_;
-    };
-    /// Hash table of size TABLE_SIZE
-    entry_ NonIpHt_[TABLE_SIZE];
+    /// Hash table, its size is a power of two
+    std::vector<entry_> NonIpHt_;
+
+    /// Number of entries in use
+    unsigned int entries_;
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include "corenetwork/deployer/LteDeployer.h"
 #include "corenetwork/binder/LteBinder.h"
 #include "stack/pdcp_rrc/layer/LtePdcpRrc.h"
+#include <limits>
 
 Define_Module(LtePdcpRrcUe);
 Define_Module(LtePdcpRrcEnb);
@@ -21,6 +22,7 @@ LtePdcpRrcBase::LtePdcpRrcBase()
     ht_ = new ConnectionsTable();
     nonIpHt_ = new NonIpConnectionsTable();
     lcid_ = 1;
+    binder_ = NULL;
 }
 
 LtePdcpRrcBase::~LtePdcpRrcBase()
@@ -34,6 +36,39 @@ LtePdcpRrcBase::~LtePdcpRrcBase()
         delete it->second;
     }
     entities_.clear();
+
+    if (binder_ != NULL && getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        binder_->removeNodeListener(this);
+}
+
+void LtePdcpRrcBase::nodeLeft(MacNodeId nodeId)
+{
+    if (nodeId == nodeId_)
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+
+    std::vector<LogicalCid> lcids;
+    const std::vector<IPv4Address>& ipAddresses = binder_->getNodeIpAddresses(nodeId);
+    for (unsigned int i = 0; i < ipAddresses.size(); i++)
+        ht_->remove_address(ipAddresses[i].getInt(), lcids);
+    const std::vector<long>& nonIpAddresses = binder_->getNodeNonIpAddresses(nodeId);
+    for (unsigned int i = 0; i < nonIpAddresses.size(); i++)
+        nonIpHt_->remove_address(nonIpAddresses[i], lcids);
+
+    for (unsigned int i = 0; i < lcids.size(); i++)
+    {
+        PdcpEntities::iterator it = entities_.find(lcids[i]);
+        if (it != entities_.end())
+        {
+            delete it->second;
+            entities_.erase(it);
+        }
+    }
+
+    // the CIDs of a node are contiguous
+    dropMap_.erase(dropMap_.lower_bound(idToMacCid(nodeId, 0)),
+        dropMap_.upper_bound(idToMacCid(nodeId, std::numeric_limits<LogicalCid>::max())));
 }
 
 void LtePdcpRrcBase::headerCompress(cPacket* pkt, int headerSize)
@@ -125,18 +160,23 @@ void LtePdcpRrcBase::fromDataIn(cPacket *pkt)
            << ipInfo->getDstPort() << " ]\n";
 
         // TODO: Since IP addresses can change when we add and remove nodes, maybe node IDs should be used instead of them
-        if ((mylcid = ht_->find_entry(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
-            ipInfo->getSrcPort(), ipInfo->getDstPort())) == 0xFFFF)
+        ConnectionsTable::entry_* flow = ht_->find_flow(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
+            ipInfo->getSrcPort(), ipInfo->getDstPort());
+        if (flow == NULL)
         {
             // LCID not found
             mylcid = lcid_++;
 
             EV << "LteRrc : Connection not found, new CID created with LCID " << mylcid << "\n";
 
-            ht_->create_entry(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
-                ipInfo->getSrcPort(), ipInfo->getDstPort(), mylcid);
+            flow = ht_->create_flow(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
+                ipInfo->getSrcPort(), ipInfo->getDstPort(), 0xFFFF, mylcid);
         }
-        entity= getEntity(mylcid);
+        mylcid = flow->lcid_;
+        // the entity of the connection is looked up once
+        if (flow->entity_ == NULL)
+            flow->entity_ = getEntity(mylcid);
+        entity = flow->entity_;
 
         // get the sequence number for this PDCP SDU.
         // Note that the numbering depends on the entity the packet is associated to.
@@ -155,17 +195,21 @@ void LtePdcpRrcBase::fromDataIn(cPacket *pkt)
         EV << "LteRrc : Received CID request for Traffic [ " << "Source: "
            << nonIpInfo->getSrcAddr() << " Destination: " << nonIpInfo->getDstAddr() << " ]\n";
 
-        if ((mylcid = nonIpHt_->find_entry(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr())) == 0xFFFF)
+        NonIpConnectionsTable::entry_* flow = nonIpHt_->find_flow(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr());
+        if (flow == NULL)
         {
             // LCID not found
             mylcid = lcid_++;
 
             EV << "LteRrc : Connection not found, new CID created with LCID " << mylcid << "\n";
 
-            nonIpHt_->create_entry(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr(), mylcid);
+            flow = nonIpHt_->create_flow(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr(), 0xFFFF, mylcid);
         }
-
-        entity= getEntity(mylcid);
+        mylcid = flow->lcid_;
+        // the entity of the connection is looked up once
+        if (flow->entity_ == NULL)
+            flow->entity_ = getEntity(mylcid);
+        entity = flow->entity_;
 
         // get the sequence number for this PDCP SDU.
         // Note that the numbering depends on the entity the packet is associated to.
@@ -291,6 +335,7 @@ void LtePdcpRrcBase::initialize(int stage)
         amSap_[OUT] = gate("AM_Sap$o");
 
         binder_ = getBinder();
+        binder_->addNodeListener(this);
         headerCompressedSize_ = par("headerCompressedSize"); // Compressed size
         ipBased_ = par("ipBased");
         nodeId_ = getAncestorPar("macNodeId");
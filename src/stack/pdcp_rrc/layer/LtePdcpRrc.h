@@ -47,7 +47,7 @@
  * that uniquely identifies a connection in the whole network.
  *
  */
-class LtePdcpRrcBase : public cSimpleModule
+class LtePdcpRrcBase : public cSimpleModule, public LteNodeListener
 {
   public:
     /**
@@ -60,6 +60,16 @@ class LtePdcpRrcBase : public cSimpleModule
      */
     virtual ~LtePdcpRrcBase();
 
+    /**
+     * Called by the binder when a node leaves the simulation:
+     * removes the connections from or to its addresses, with
+     * their PDCP entities, so that a node later given the same
+     * id starts new connections
+     *
+     * @param nodeId Id of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
+
   protected:
 
     /**
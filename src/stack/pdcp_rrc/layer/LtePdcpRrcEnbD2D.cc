@@ -64,8 +64,9 @@ void LtePdcpRrcEnbD2D::fromDataIn(cPacket *pkt)
      */
 
     LogicalCid mylcid;
-    if ((mylcid = ht_->find_entry(lteInfo->getSrcAddr(), lteInfo->getDstAddr(),
-        lteInfo->getSrcPort(), lteInfo->getDstPort(), lteInfo->getDirection())) == 0xFFFF)
+    ConnectionsTable::entry_* flow = ht_->find_flow(lteInfo->getSrcAddr(), lteInfo->getDstAddr(),
+        lteInfo->getSrcPort(), lteInfo->getDstPort(), lteInfo->getDirection());
+    if (flow == NULL)
     {
         // LCID not found
 
@@ -74,15 +75,18 @@ void LtePdcpRrcEnbD2D::fromDataIn(cPacket *pkt)
 
         EV << "LtePdcpRrcEnbD2D : Connection not found, new CID created with LCID " << mylcid << "\n";
 
-        ht_->create_entry(lteInfo->getSrcAddr(), lteInfo->getDstAddr(),
+        flow = ht_->create_flow(lteInfo->getSrcAddr(), lteInfo->getDstAddr(),
             lteInfo->getSrcPort(), lteInfo->getDstPort(), lteInfo->getDirection(), mylcid);
     }
+    mylcid = flow->lcid_;
 
     EV << "LtePdcpRrcEnbD2D : Assigned Lcid: " << mylcid << "\n";
     EV << "LtePdcpRrcEnbD2D : Assigned Node ID: " << nodeId_ << "\n";
 
-    // get the PDCP entity for this LCID
-    LtePdcpEntity* entity = getEntity(mylcid);
+    // get the PDCP entity for this LCID, looked up once per connection
+    if (flow->entity_ == NULL)
+        flow->entity_ = getEntity(mylcid);
+    LtePdcpEntity* entity = flow->entity_;
 
     // get the sequence number for this PDCP SDU.
     // Note that the numbering depends on the entity the packet is associated to.
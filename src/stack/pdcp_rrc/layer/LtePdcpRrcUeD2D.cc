@@ -102,8 +102,9 @@ void LtePdcpRrcUeD2D::fromDataIn(cPacket *pkt)
          */
 
         LogicalCid mylcid;
-        if ((mylcid = ht_->find_entry(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
-                                      ipInfo->getSrcPort(), ipInfo->getDstPort(), ipInfo->getDirection())) == 0xFFFF)
+        ConnectionsTable::entry_* flow = ht_->find_flow(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
+                                                        ipInfo->getSrcPort(), ipInfo->getDstPort(), ipInfo->getDirection());
+        if (flow == NULL)
         {
             // LCID not found
 
@@ -112,11 +113,15 @@ void LtePdcpRrcUeD2D::fromDataIn(cPacket *pkt)
 
             EV << "LtePdcpRrcUeD2D : Connection not found, new CID created with LCID " << mylcid << "\n";
 
-            ht_->create_entry(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
-                              ipInfo->getSrcPort(), ipInfo->getDstPort(), ipInfo->getDirection(), mylcid);
+            flow = ht_->create_flow(ipInfo->getSrcAddr(), ipInfo->getDstAddr(),
+                                    ipInfo->getSrcPort(), ipInfo->getDstPort(), ipInfo->getDirection(), mylcid);
         }
+        mylcid = flow->lcid_;
 
-        entity= getEntity(mylcid);
+        // the entity of the connection is looked up once
+        if (flow->entity_ == NULL)
+            flow->entity_ = getEntity(mylcid);
+        entity = flow->entity_;
 
         // get the sequence number for this PDCP SDU.
         // Note that the numbering depends on the entity the packet is associated to.
@@ -145,17 +150,22 @@ void LtePdcpRrcUeD2D::fromDataIn(cPacket *pkt)
         EV << "LteRrc : Received CID request for Traffic [ " << "Source: "
            << nonIpInfo->getSrcAddr() << " Destination: " << nonIpInfo->getDstAddr() << " ]\n";
 
-        if ((mylcid = nonIpHt_->find_entry(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr())) == 0xFFFF)
+        NonIpConnectionsTable::entry_* flow = nonIpHt_->find_flow(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr());
+        if (flow == NULL)
         {
             // LCID not found
             mylcid = lcid_++;
 
             EV << "LteRrc : Connection not found, new CID created with LCID " << mylcid << "\n";
 
-            nonIpHt_->create_entry(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr(), mylcid);
+            flow = nonIpHt_->create_flow(nonIpInfo->getSrcAddr(), nonIpInfo->getDstAddr(), 0xFFFF, mylcid);
         }
+        mylcid = flow->lcid_;
 
-        entity= getEntity(mylcid);
+        // the entity of the connection is looked up once
+        if (flow->entity_ == NULL)
+            flow->entity_ = getEntity(mylcid);
+        entity = flow->entity_;
 
         // get the sequence number for this PDCP SDU.
         // Note that the numbering depends on the entity the packet is associated to.
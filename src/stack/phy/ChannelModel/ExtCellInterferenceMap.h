@@ -0,0 +1,113 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_EXTCELLINTERFERENCEMAP_H_
+#define _LTE_EXTCELLINTERFERENCEMAP_H_
+
+#include "common/LteCommon.h"
+#include <unordered_map>
+#include <tuple>
+
+/*
+ * Parameters of the channel model the points of an interference map depend on.
+ * Channel models configured alike share the same map.
+ */
+struct ExtCellMapParameters
+{
+    // distance between two grid points (m)
+    double step;
+    // number of logical bands
+    unsigned int numBands;
+    // path loss model and its parameters
+    DeploymentScenario scenario;
+    double carrierFrequency;
+    double hNodeB;
+    double hUe;
+    double hBuilding;
+    double wStreet;
+    // gains and losses added to the received power (dB)
+    double cableLoss;
+    double antennaGainEnB;
+    double antennaGainUe;
+
+    bool operator<(const ExtCellMapParameters& other) const
+    {
+        return std::tie(step, numBands, scenario, carrierFrequency, hNodeB, hUe, hBuilding, wStreet, cableLoss,
+            antennaGainEnB, antennaGainUe)
+            < std::tie(other.step, other.numBands, other.scenario, other.carrierFrequency, other.hNodeB, other.hUe,
+                other.hBuilding, other.wStreet, other.cableLoss, other.antennaGainEnB, other.antennaGainUe);
+    }
+};
+
+/*
+ * Mean interference of all the external cells on a square grid.
+ *
+ * Each grid point holds, for each band, the sum over the external cells of the
+ * received power (mW, without shadowing) weighted by the mean occupation of the
+ * band, separately for LOS and NLOS receivers. Points are filled on demand by
+ * the channel models configured with the parameters of the map, and dropped when
+ * the band utilization of any external cell changes (see LteBinder::getExtCellVersion()).
+ */
+class ExtCellInterferenceMap
+{
+    // parameters the points have been computed with
+    ExtCellMapParameters parameters_;
+
+    // ext cell version the stored points refer to
+    unsigned long version_;
+
+    // per-band interference of the computed points, indexed by LOS/NLOS and point key
+    std::unordered_map<int64_t, std::vector<double> > points_[2];
+
+    static int64_t key(int x, int y)
+    {
+        return ((int64_t) x << 32) | (uint32_t) y;
+    }
+
+  public:
+    ExtCellInterferenceMap(const ExtCellMapParameters& parameters, unsigned long version)
+    {
+        parameters_ = parameters;
+        version_ = version;
+    }
+
+    const ExtCellMapParameters& getParameters() const
+    {
+        return parameters_;
+    }
+
+    // drop all the points if the ext cells changed since they have been computed
+    void checkVersion(unsigned long version)
+    {
+        if (version == version_)
+            return;
+        points_[0].clear();
+        points_[1].clear();
+        version_ = version;
+    }
+
+    // per-band interference at grid point (x,y), NULL if not computed yet
+    const std::vector<double>* getPoint(int x, int y, bool los) const
+    {
+        std::unordered_map<int64_t, std::vector<double> >::const_iterator it = points_[los].find(key(x, y));
+        if (it == points_[los].end())
+            return NULL;
+        return &it->second;
+    }
+
+    // store the per-band interference of grid point (x,y)
+    const std::vector<double>* setPoint(int x, int y, bool los, const std::vector<double>& interference)
+    {
+        std::vector<double>& point = points_[los][key(x, y)];
+        point = interference;
+        return &point;
+    }
+};
+
+#endif
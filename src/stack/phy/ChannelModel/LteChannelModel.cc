@@ -12,6 +12,7 @@
 LteChannelModel::LteChannelModel(unsigned int band)
 {
     band_ = band;
+    ownerId_ = 0;
 }
 
 LteChannelModel::~LteChannelModel()
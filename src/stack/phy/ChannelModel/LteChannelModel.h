@@ -18,9 +18,20 @@ class LteChannelModel
 {
   protected:
     unsigned int band_;
+    // id of the node owning this channel model, i.e. the receiving end of the links it models
+    MacNodeId ownerId_;
     public:
     LteChannelModel(unsigned int band);
     virtual ~LteChannelModel();
+    /*
+     * Set the id of the node owning this channel model, once it is known
+     *
+     * @param ownerId mac node id of the node
+     */
+    void setOwnerId(MacNodeId ownerId)
+    {
+        ownerId_ = ownerId;
+    }
     /*
      * Compute the error probability of the transmitted packet according to cqi used, txmode, and the received power
      * after that it throws a random number in order to check if this packet will be corrupted or not
@@ -94,6 +105,30 @@ class LteChannelModel
     virtual std::vector<double> getRSSI(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, inet::Coord destCoord,MacNodeId enbId,std::vector<double> rsrpVector)=0;
 
     virtual double getTxRxDistance(UserControlInfo* lteInfo)=0;
+
+    /*
+     * Draw the random numbers of this channel model from the given RNG, instead of
+     * the global RNG 0 (e.g. one stream per receiver for parallel reception)
+     */
+    virtual void setRNG(cRNG* rng)
+    {
+        throw cRuntimeError("LteChannelModel::setRNG - RNG streams not supported by this channel model");
+    }
+    /*
+     * Return true if getRSRP_D2D() and getRSSI() only access the state of this channel model,
+     * so that the receptions of different receivers can be measured in parallel
+     */
+    virtual bool isReceptionThreadSafe()
+    {
+        return false;
+    }
+    /*
+     * Forget the state kept about the given node (e.g. its position history), when it
+     * leaves the simulation
+     */
+    virtual void removeNode(MacNodeId nodeId)
+    {
+    }
 };
 
 #endif
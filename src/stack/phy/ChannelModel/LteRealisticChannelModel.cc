@@ -21,6 +21,7 @@
 // and tolerating the maximum distance violation is enabled
 #define ATT_MAXDISTVIOLATED 1000
 
+
 LteRealisticChannelModel::LteRealisticChannelModel(ParameterMap& params,
         const Coord& myCoord, unsigned int band) :
         LteChannelModel(band), myCoord_(myCoord)
@@ -315,6 +316,16 @@ LteRealisticChannelModel::LteRealisticChannelModel(ParameterMap& params,
     else
         enableExtCellInterference_ = false;
 
+    // grid step of the ext cell interference map (0 computes the interference of each ext cell)
+    it = params.find("extCell-map-step");
+    if (it != params.end())
+        extCellMapStep_ = it->second.doubleValue();
+    else
+        extCellMapStep_ = 0;
+    if (extCellMapStep_ < 0)
+        throw cRuntimeError("LteRealisticChannelModel::LteRealisticChannelModel - negative extCell-map-step");
+    extCellMap_ = NULL;
+
     it = params.find("multiCell-interference");
     if (it != params.end())
     {
@@ -345,11 +356,27 @@ LteRealisticChannelModel::LteRealisticChannelModel(ParameterMap& params,
     jakesFadingMap_.clear();
 
     nkgmf = new inet::physicallayer::NakagamiFading();
+
+    rng_ = getEnvir()->getRNG(0);
+    privateRng_ = false;
+
+    // counter-based random numbers, keyed by link, band, TTI and purpose
+    counterRng_ = NULL;
+    it = params.find("counter-rng");
+    if (it != params.end() && it->second.boolValue())
+        counterRng_ = new LteCounterRng(binder_->getCounterRngSeed());
+
+    // accuracy of the dB/linear conversions of whole band vectors
+    conversionMode_ = CONVERSION_ACCURATE;
+    it = params.find("fast-conversion");
+    if (it != params.end() && it->second.boolValue())
+        conversionMode_ = CONVERSION_FAST;
 }
 
 LteRealisticChannelModel::~LteRealisticChannelModel()
 {
     delete nkgmf;
+    delete counterRng_;
 }
 
 double LteRealisticChannelModel::getTxRxDistance(UserControlInfo* lteInfo)
@@ -389,19 +416,19 @@ double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
     switch (scenario_)
     {
     case INDOOR_HOTSPOT:
-        attenuation = computeIndoor(sqrDistance, nodeId);
+        attenuation = computeIndoor(sqrDistance, losMap_[nodeId]);
         break;
     case URBAN_MICROCELL:
-        attenuation = computeUrbanMicro(sqrDistance, nodeId);
+        attenuation = computeUrbanMicro(sqrDistance, losMap_[nodeId], tolerateMaxDistViolation_);
         break;
     case URBAN_MACROCELL:
-        attenuation = computeUrbanMacro(sqrDistance, nodeId);
+        attenuation = computeUrbanMacro(sqrDistance, losMap_[nodeId], tolerateMaxDistViolation_);
         break;
     case RURAL_MACROCELL:
-        attenuation = computeRuralMacro(sqrDistance, dbp, nodeId);
+        attenuation = computeRuralMacro(sqrDistance, dbp, losMap_[nodeId], tolerateMaxDistViolation_);
         break;
     case SUBURBAN_MACROCELL:
-        attenuation = computeSubUrbanMacro(sqrDistance, dbp, nodeId);
+        attenuation = computeSubUrbanMacro(sqrDistance, dbp, losMap_[nodeId], tolerateMaxDistViolation_);
         break;
     default:
         throw cRuntimeError("Wrong value %d for path-loss scenario", scenario_);
@@ -428,7 +455,7 @@ double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
         if (lastComputedSF_.find(nodeId) == lastComputedSF_.end())
         {
             //Get the log normal shadowing with std deviation stdDev
-            att = normal(getEnvir()->getRNG(0), mean, stdDev);
+            att = drawNormal(nodeId, ownerId_, RANDOM_SHADOWING, mean, stdDev);
 
             //store the shadowing attenuation for this user and the temporal mark
             std::pair<simtime_t, double> tmp(NOW, att);
@@ -454,7 +481,7 @@ double LteRealisticChannelModel::getAttenuation(MacNodeId nodeId, Direction dir,
             double old = lastComputedSF_.at(nodeId).second;
 
             //Compute shadowing with a EAW (Exponential Average Window) (step2)
-            att = a * old + sqrt(1 - pow(a, 2)) * normal(getEnvir()->getRNG(0), mean, stdDev);
+            att = a * old + sqrt(1 - pow(a, 2)) * drawNormal(nodeId, ownerId_, RANDOM_SHADOWING, mean, stdDev);
 
             // Store the new computed shadowing
             std::pair<simtime_t, double> tmp(NOW, att);
@@ -512,19 +539,19 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
     switch (scenario_)
     {
         case INDOOR_HOTSPOT:
-            attenuation = computeIndoor(sqrDistance, nodeId);
+            attenuation = computeIndoor(sqrDistance, losMap_[nodeId]);
             break;
         case URBAN_MICROCELL:
-            attenuation = computeUrbanMicro(sqrDistance, nodeId);
+            attenuation = computeUrbanMicro(sqrDistance, losMap_[nodeId], tolerateMaxDistViolation_);
             break;
         case URBAN_MACROCELL:
-            attenuation = computeUrbanMacro(sqrDistance, nodeId);
+            attenuation = computeUrbanMacro(sqrDistance, losMap_[nodeId], tolerateMaxDistViolation_);
             break;
         case RURAL_MACROCELL:
-            attenuation = computeRuralMacro(sqrDistance, dbp, nodeId);
+            attenuation = computeRuralMacro(sqrDistance, dbp, losMap_[nodeId], tolerateMaxDistViolation_);
             break;
         case SUBURBAN_MACROCELL:
-            attenuation = computeSubUrbanMacro(sqrDistance, dbp, nodeId);
+            attenuation = computeSubUrbanMacro(sqrDistance, dbp, losMap_[nodeId], tolerateMaxDistViolation_);
             break;
         case WINNER:
             attenuation = computerWinnerB1(coord, myCoord_, nodeId);
@@ -554,7 +581,7 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
         if (lastComputedSF_.find(nodeId) == lastComputedSF_.end())
         {
             //Get the log normal shadowing with std deviation stdDev
-            att = normal(getEnvir()->getRNG(0),mean, stdDev);
+            att = drawNormal(nodeId, node2_Id, RANDOM_SHADOWING, mean, stdDev);
 
             //store the shadowing attenuation for this user and the temporal mark
             std::pair<simtime_t, double> tmp(NOW, att);
@@ -579,7 +606,7 @@ double LteRealisticChannelModel::getAttenuation_D2D(MacNodeId nodeId, Direction
             double old = lastComputedSF_.at(nodeId).second;
 
             //Compute shadowing with a EAW (Exponential Average Window) (step2)
-            att = a * old + sqrt(1 - pow(a, 2)) * normal(getEnvir()->getRNG(0),mean, stdDev);
+            att = a * old + sqrt(1 - pow(a, 2)) * drawNormal(nodeId, node2_Id, RANDOM_SHADOWING, mean, stdDev);
 
             // Store the new computed shadowing
             std::pair<simtime_t, double> tmp(NOW, att);
@@ -957,20 +984,24 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
         double totN = dBmToLinear(thermalNoise_ + noiseFigure);
 
         // denominator expressed in dBm as (N+extCell+multiCell)
-        double den;
+        std::vector<double> den(band_);
         EV << "LteRealisticChannelModel::getSINR - distance from my eNb=" << enbCoord.distance(ueCoord) << " - DIR=" << (( dir==DL )?"DL" : "UL") << endl;
 
         // add interference for each band
         for (unsigned int i = 0; i < band_; i++)
         {
-            //               (      mW            +  mW  +        mW            )
-            den = linearToDBm(extCellInterference[i] + totN + multiCellInterference[i]);
+            //       (      mW            +  mW  +        mW            )
+            den[i] = extCellInterference[i] + totN + multiCellInterference[i];
+        }
+        linearToDBm(den.data(), den.data(), band_, conversionMode_);
 
+        for (unsigned int i = 0; i < band_; i++)
+        {
             EV << "\t ext[" << extCellInterference[i] << "] - multi[" << multiCellInterference[i] << "] - recvPwr["
-               << dBmToLinear(snrVector[i]) << "] - sinr[" << snrVector[i]-den << "]\n";
+               << dBmToLinear(snrVector[i]) << "] - sinr[" << snrVector[i]-den[i] << "]\n";
 
             // compute final SINR
-            snrVector[i] -= den;
+            snrVector[i] -= den[i];
         }
     }
     // compute snr with no intercell interference
@@ -1089,10 +1120,7 @@ std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, Us
             }
             else if (fadingType_ == NAKAGAMI)
             {
-                inet::units::values::mps speed = inet::units::values::mps(SPEED_OF_LIGHT);
-                inet::units::values::Hz freq = inet::units::values::Hz(carrierFrequency_ * 1000000000);
-                inet::units::values::m dist = inet::units::values::m(sourceCoord.distance(destCoord));
-                fadingAttenuation = nkgmf->computePathLoss(speed, freq, dist);
+                fadingAttenuation = nakagamiFading(sourceId, destId, i, sourceCoord.distance(destCoord));
             }
         }
         // add fading contribution to the received pwr
@@ -1284,20 +1312,24 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
             double totN = dBmToLinear(thermalNoise_ + noiseFigure);
 
             // denominator expressed in dBm as (N+extCell+inCell)
-            double den;
+            std::vector<double> den(band_);
             EV << "LteRealisticChannelModel::getSINR - distance from my Peer = " << destCoord.distance(sourceCoord) << " - DIR=" << dirToA(dir)  << endl;
 
             // Add interference for each band
             for (unsigned int i = 0; i < band_; i++)
             {
-                //               (      mW            +  mW  +        mW            )
-                den = linearToDBm(extCellInterference + totN + inCellInterference[i]);
+                //       (      mW            +  mW  +        mW            )
+                den[i] = extCellInterference + totN + inCellInterference[i];
+            }
+            linearToDBm(den.data(), den.data(), band_, conversionMode_);
 
+            for (unsigned int i = 0; i < band_; i++)
+            {
                 EV << "\t ext[" << extCellInterference << "] - in[" << inCellInterference[i] << "] - recvPwr["
-                        << dBmToLinear(snrVector[i]) << "] - sinr[" << snrVector[i]-den << "]\n";
+                        << dBmToLinear(snrVector[i]) << "] - sinr[" << snrVector[i]-den[i] << "]\n";
 
                 // compute final SINR. Subtraction in dB is equivalent to linear division
-                snrVector[i] -= den;
+                snrVector[i] -= den[i];
             }
     }
     // compute snr with no incellD2D interference
@@ -1418,10 +1450,7 @@ std::vector<double> LteRealisticChannelModel::getRSSI(LteAirFrame *frame, UserCo
             }
             else if (fadingType_ == NAKAGAMI)
             {
-                inet::units::values::mps speed = inet::units::values::mps(SPEED_OF_LIGHT);
-                inet::units::values::Hz freq = inet::units::values::Hz(carrierFrequency_ * 1000000000);
-                inet::units::values::m dist = inet::units::values::m(sourceCoord.distance(destCoord));
-                fadingAttenuation = nkgmf->computePathLoss(speed, freq, dist);
+                fadingAttenuation = nakagamiFading(sourceId, destId, i, sourceCoord.distance(destCoord));
             }
         }
         // add fading contribution to the received pwr
@@ -1484,20 +1513,24 @@ std::vector<double> LteRealisticChannelModel::getRSSI(LteAirFrame *frame, UserCo
         double totN = dBmToLinear(thermalNoise_ + noiseFigure);
 
         // denominator expressed in dBm as (N+extCell+inCell)
-        double den;
+        std::vector<double> den(band_);
         EV << "LteRealisticChannelModel::getSINR - distance from my Peer = " << destCoord.distance(sourceCoord) << " - DIR=" << dirToA(dir)  << endl;
 
         // Add interference for each band
         for (unsigned int i = 0; i < band_; i++)
         {
-            //               (      mW            +  mW  +        mW            )
-            den = linearToDBm(extCellInterference + totN + inCellInterference[i]);
+            //       (      mW            +  mW  +        mW            )
+            den[i] = extCellInterference + totN + inCellInterference[i];
+        }
+        linearToDBm(den.data(), den.data(), band_, conversionMode_);
 
+        for (unsigned int i = 0; i < band_; i++)
+        {
             EV << "\t ext[" << extCellInterference << "] - in[" << inCellInterference[i] << "] - recvPwr["
-               << dBmToLinear(rssiVector[i]) << "] - sinr[" << rssiVector[i]-den << "]\n";
+               << dBmToLinear(rssiVector[i]) << "] - sinr[" << rssiVector[i]-den[i] << "]\n";
 
             // compute final RSSI.
-            rssiVector[i] += den * 2;
+            rssiVector[i] += den[i] * 2;
         }
     }
         // compute rssi with no incellD2D interference
@@ -1581,20 +1614,24 @@ std::vector<double> LteRealisticChannelModel::getSINR_D2D(LteAirFrame *frame, Us
             double totN = dBmToLinear(thermalNoise_ + noiseFigure);
 
             // denominator expressed in dBm as (N+extCell+inCell)
-            double den;
+            std::vector<double> den(band_);
             EV << "LteRealisticChannelModel::getSINR - distance from my Peer = " << destCoord.distance(sourceCoord) << " - DIR=" << dirToA(dir)  << endl;
 
             // Add interference for each band
             for (unsigned int i = 0; i < band_; i++)
             {
-                //               (      mW            +  mW  +        mW            )
-                den = linearToDBm(extCellInterference + totN + inCellInterference[i]);
+                //       (      mW            +  mW  +        mW            )
+                den[i] = extCellInterference + totN + inCellInterference[i];
+            }
+            linearToDBm(den.data(), den.data(), band_, conversionMode_);
 
+            for (unsigned int i = 0; i < band_; i++)
+            {
                 EV << "\t ext[" << extCellInterference << "] - in[" << inCellInterference[i] << "] - recvPwr["
-                        << dBmToLinear(snrVector[i]) << "] - sinr[" << snrVector[i]-den << "]\n";
+                        << dBmToLinear(snrVector[i]) << "] - sinr[" << snrVector[i]-den[i] << "]\n";
 
                 // compute final SINR. Subtraction in dB is equivalent to linear division
-                snrVector[i] -= den;
+                snrVector[i] -= den[i];
             }
     }
     // compute snr with no incellD2D interference
@@ -1681,17 +1718,18 @@ std::vector<double> LteRealisticChannelModel::getRSSI(LteAirFrame *frame, UserCo
         double den;
         EV << "LteRealisticChannelModel::getRSSI - distance from my Peer = " << destCoord.distance(sourceCoord) << " - DIR=" << dirToA(dir)  << endl;
 
+        // linear RSRP per RE of each band
+        std::vector<double> linearRssi(band_);
+        dBmToLinear(rssiVector.data(), linearRssi.data(), band_, conversionMode_);
+
         // Add interference for each band
         for (unsigned int i = 0; i < band_; i++)
         {
             //   (      mW            +  mW  +        mW            )
             den = extCellInterference + totN + inCellInterference[i];
-            double rsrpPerReLinear = dBmToLinear(rssiVector[i]);
-            double linearRSSI = 2 * (den + rsrpPerReLinear);
-            double rssi = linearToDBm(linearRSSI);
-
-            rssiVector[i] = rssi;
+            linearRssi[i] = 2 * (den + linearRssi[i]);
         }
+        linearToDBm(linearRssi.data(), rssiVector.data(), band_, conversionMode_);
     }
         // compute rssi with no incellD2D interference
     else
@@ -1821,12 +1859,19 @@ double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
      * thus the actual map should be choosen carefully (i.e. just check the cqiDL flag)
      */
     JakesFadingMap * actualJakesMap;
+    // node owning the map, i.e. the receiving end of the link
+    MacNodeId mapOwnerId;
 
     if (cqiDl) // if we are computing a DL CQI we need the Jakes Map stored on the UE side
+    {
         actualJakesMap = obtainUeJakesMap(nodeId);
-
+        mapOwnerId = nodeId;
+    }
     else
+    {
         actualJakesMap = &jakesFadingMap_;
+        mapOwnerId = ownerId_;
+    }
 
     //if this is the first time that we compute fading for current user
     if (actualJakesMap->find(nodeId) == actualJakesMap->end())
@@ -1847,10 +1892,10 @@ double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
             for (int i = 0; i < fadingPaths_; i++)
             {
                 //get angle of arrivals
-                temp.angleOfArrival.push_back(cos(uniform(getEnvir()->getRNG(0),0, M_PI)));
+                temp.angleOfArrival.push_back(cos(drawUniform(nodeId, mapOwnerId, j, RANDOM_FADING_ANGLE, i, 0, M_PI)));
 
                 //get delay spread
-                temp.delaySpread.push_back(exponential(getEnvir()->getRNG(0),delayRMS_));
+                temp.delaySpread.push_back(drawExponential(nodeId, mapOwnerId, j, RANDOM_FADING_DELAY, i, delayRMS_));
             }
             //store the jakes fadint for this user
             (*actualJakesMap)[nodeId].push_back(temp);
@@ -1946,7 +1991,7 @@ double LteRealisticChannelModel::computerWinnerB1 (Coord destCoord, Coord sendCo
     // http://projects.celtic-initiative.org/winner%2B/WINNER+%20Deliverables/D5.3_v1.0.pdf
 
     // Generate a random number between 0 and 1 (if it doesn't already exist) to evaluate the LOS/NLOS situation
-    double r = uniform(getEnvir()->getRNG(0), 0.0, 1.0);
+    double r = drawUniform(nodeId, ownerId_, 0, RANDOM_WINNER, 0, 0.0, 1.0);
 
     // This model is only valid to a minimum distance of 3 meters
     if (dist >= 3)
@@ -2111,7 +2156,8 @@ bool LteRealisticChannelModel::error(LteAirFrame *frame,
     //Harq Reduction
     double totalPer = per * pow(harqReduction_, nTx - 1);
 
-    double er = uniform(getEnvir()->getRNG(0), 0.0, 1.0);
+    double er = drawUniform(lteInfo->getSourceId(), lteInfo->getDestId(), 0, RANDOM_ERROR,
+        (lteInfo->getFrameType() << 8) | lteInfo->getCw(), 0.0, 1.0);
 
     EV << " LteRealisticChannelModel::error direction " << dirToA(dir)
                        << " node " << id << " total ERROR probability  " << per
@@ -2261,7 +2307,8 @@ bool LteRealisticChannelModel::error_D2D(LteAirFrame *frame, UserControlInfo* lt
     // Harq Reduction
     double totalPer = per * pow(harqReduction_, nTx - 1);
 
-    double er = uniform(getEnvir()->getRNG(0),0.0, 1.0);
+    double er = drawUniform(lteInfo->getSourceId(), lteInfo->getDestId(), 0, RANDOM_ERROR,
+        (lteInfo->getFrameType() << 8) | lteInfo->getCw(), 0.0, 1.0);
 
     EV << " LteRealisticChannelModel::error direction " << dirToA(dir)
        << " node " << id << " total ERROR probability  " << per
@@ -2419,7 +2466,8 @@ bool LteRealisticChannelModel::error_Mode4_D2D(LteAirFrame *frame, UserControlIn
     // Harq Reduction
     double totalPer = per * pow(harqReduction_, nTx - 1);
 
-    double er = uniform(getEnvir()->getRNG(0),0.0, 1.0);
+    double er = drawUniform(lteInfo->getSourceId(), lteInfo->getDestId(), 0, RANDOM_ERROR,
+        (lteInfo->getFrameType() << 8) | lteInfo->getCw(), 0.0, 1.0);
 
     EV << " LteRealisticChannelModel::error direction " << dirToA(dir)
        << " node " << id << " total ERROR probability  " << per
@@ -2485,17 +2533,17 @@ void LteRealisticChannelModel::computeLosProbability(double d,
     default:
         throw cRuntimeError("Wrong path-loss scenario value %d", scenario_);
     }
-    double random = uniform(getEnvir()->getRNG(0), 0.0, 1.0);
+    double random = drawUniform(nodeId, ownerId_, 0, RANDOM_LOS, 0, 0.0, 1.0);
     if (random <= p)
         losMap_[nodeId] = true;
     else
         losMap_[nodeId] = false;
 }
 
-double LteRealisticChannelModel::computeIndoor(double d, MacNodeId nodeId)
+double LteRealisticChannelModel::computeIndoor(double d, bool los)
 {
     double a, b;
-    if (losMap_[nodeId])
+    if (los)
     {
         if (d > 150 || d < 3)
             throw cRuntimeError("Error LOS indoor path loss model is valid for 3<d<150");
@@ -2512,18 +2560,18 @@ double LteRealisticChannelModel::computeIndoor(double d, MacNodeId nodeId)
     return a * log10(d) + b + 20 * log10(carrierFrequency_);
 }
 
-double LteRealisticChannelModel::computeUrbanMicro(double d, MacNodeId nodeId)
+double LteRealisticChannelModel::computeUrbanMicro(double d, bool los, bool tolerateMaxDistViolation)
 {
     if (d < 10)
         d = 10;
 
     double dbp = 4 * (hNodeB_ - 1) * (hUe_ - 1)
                         * ((carrierFrequency_ * 1000000000) / SPEED_OF_LIGHT);
-    if (losMap_[nodeId])
+    if (los)
     {
         // LOS situation
         if (d > 5000){
-            if(tolerateMaxDistViolation_)
+            if(tolerateMaxDistViolation)
                 return ATT_MAXDISTVIOLATED;
             else
                 throw cRuntimeError("Error LOS urban microcell path loss model is valid for d<5000 m");
@@ -2538,7 +2586,7 @@ double LteRealisticChannelModel::computeUrbanMicro(double d, MacNodeId nodeId)
     if (d < 10)
         throw cRuntimeError("Error NLOS urban microcell path loss model is valid for 10m < d ");
     if (d > 5000){
-        if(tolerateMaxDistViolation_)
+        if(tolerateMaxDistViolation)
             return ATT_MAXDISTVIOLATED;
         else
             throw cRuntimeError("Error NLOS urban microcell path loss model is valid for d <2000 m");
@@ -2546,17 +2594,17 @@ double LteRealisticChannelModel::computeUrbanMicro(double d, MacNodeId nodeId)
     return 36.7 * log10(d) + 22.7 + 26 * log10(carrierFrequency_);
 }
 
-double LteRealisticChannelModel::computeUrbanMacro(double d, MacNodeId nodeId)
+double LteRealisticChannelModel::computeUrbanMacro(double d, bool los, bool tolerateMaxDistViolation)
 {
     if (d < 10)
         d = 10;
 
     double dbp = 4 * (hNodeB_ - 1) * (hUe_ - 1)
                         * ((carrierFrequency_ * 1000000000) / SPEED_OF_LIGHT);
-    if (losMap_[nodeId])
+    if (los)
     {
         if (d > 5000){
-            if(tolerateMaxDistViolation_)
+            if(tolerateMaxDistViolation)
                 return ATT_MAXDISTVIOLATED;
             else
                 throw cRuntimeError("Error LOS urban macrocell path loss model is valid for d<5000 m");
@@ -2571,7 +2619,7 @@ double LteRealisticChannelModel::computeUrbanMacro(double d, MacNodeId nodeId)
     if (d < 10)
         throw cRuntimeError("Error NLOS urban macrocell path loss model is valid for 10m < d ");
     if (d > 5000){
-        if(tolerateMaxDistViolation_)
+        if(tolerateMaxDistViolation)
             return ATT_MAXDISTVIOLATED;
         else
             throw cRuntimeError("Error NLOS urban macrocell path loss model is valid for d <5000 m");
@@ -2586,17 +2634,17 @@ double LteRealisticChannelModel::computeUrbanMacro(double d, MacNodeId nodeId)
 }
 
 double LteRealisticChannelModel::computeSubUrbanMacro(double d, double& dbp,
-        MacNodeId nodeId)
+        bool los, bool tolerateMaxDistViolation)
 {
     if (d < 10)
         d = 10;
 
     dbp = 4 * (hNodeB_ - 1) * (hUe_ - 1)
                         * ((carrierFrequency_ * 1000000000) / SPEED_OF_LIGHT);
-    if (losMap_[nodeId])
+    if (los)
     {
         if (d > 5000) {
-            if(tolerateMaxDistViolation_)
+            if(tolerateMaxDistViolation)
                 return ATT_MAXDISTVIOLATED;
             else
                 throw cRuntimeError("Error LOS suburban macrocell path loss model is valid for d<5000 m");
@@ -2618,7 +2666,7 @@ double LteRealisticChannelModel::computeSubUrbanMacro(double d, double& dbp,
         + 40 * log10(d / dbp);
     }
     if (d > 5000) {
-        if(tolerateMaxDistViolation_)
+        if(tolerateMaxDistViolation)
             return ATT_MAXDISTVIOLATED;
         else
             throw cRuntimeError("Error NLOS suburban macrocell path loss model is valid for 10 < d < 5000 m");
@@ -2632,18 +2680,18 @@ double LteRealisticChannelModel::computeSubUrbanMacro(double d, double& dbp,
 }
 
 double LteRealisticChannelModel::computeRuralMacro(double d, double& dbp,
-        MacNodeId nodeId)
+        bool los, bool tolerateMaxDistViolation)
 {
     if (d < 10)
         d = 10;
 
     dbp = 4 * (hNodeB_ - 1) * (hUe_ - 1)
                         * ((carrierFrequency_ * 1000000000) / SPEED_OF_LIGHT);
-    if (losMap_[nodeId])
+    if (los)
     {
         // LOS situation
         if (d > 10000) {
-            if(tolerateMaxDistViolation_)
+            if(tolerateMaxDistViolation)
                 return ATT_MAXDISTVIOLATED;
             else
                 throw cRuntimeError("Error LOS rural macrocell path loss model is valid for d < 10000 m");
@@ -2663,7 +2711,7 @@ double LteRealisticChannelModel::computeRuralMacro(double d, double& dbp,
     }
     // NLOS situation
     if (d > 5000) {
-        if(tolerateMaxDistViolation_)
+        if(tolerateMaxDistViolation)
             return ATT_MAXDISTVIOLATED;
         else
             throw cRuntimeError("Error NLOS rural macrocell path loss model is valid for d<5000 m");
@@ -2718,9 +2766,12 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
 {
     EV << "**** Ext Cell Interference **** " << endl;
 
+    if (extCellMapStep_ > 0)
+        return computeExtCellMapInterference(nodeId, coord, interference);
+
     // get external cell list
-    ExtCellList list = binder_->getExtCellList();
-    ExtCellList::iterator it = list.begin();
+    const ExtCellList& list = binder_->getExtCellList();
+    ExtCellList::const_iterator it = list.begin();
 
     Coord c;
     double dist, // meters
@@ -2795,38 +2846,131 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
     return true;
 }
 
-double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId nodeId)
+bool LteRealisticChannelModel::computeExtCellMapInterference(MacNodeId nodeId, Coord coord, std::vector<double>* interference)
 {
-    double movement = .0;
-    double speed = .0;
+    if (extCellMap_ == NULL)
+    {
+        // the points depend on the path loss model and on the gains of this channel model
+        ExtCellMapParameters parameters;
+        parameters.step = extCellMapStep_;
+        parameters.numBands = band_;
+        parameters.scenario = scenario_;
+        parameters.carrierFrequency = carrierFrequency_;
+        parameters.hNodeB = hNodeB_;
+        parameters.hUe = hUe_;
+        parameters.hBuilding = hBuilding_;
+        parameters.wStreet = wStreet_;
+        parameters.cableLoss = cableLoss_;
+        parameters.antennaGainEnB = antennaGainEnB_;
+        parameters.antennaGainUe = antennaGainUe_;
+        extCellMap_ = binder_->getExtCellInterferenceMap(parameters);
+    }
+    ExtCellInterferenceMap* map = extCellMap_;
+    map->checkVersion(binder_->getExtCellVersion());
+
+    // the map is computed without shadowing, which is the same for all the ext cells
+    double shadowing = 1.0;
+    if (shadowing_)
+        shadowing = dBToLinear(-lastComputedSF_.at(nodeId).second);
+
+    // bilinear interpolation between the four grid points around the UE
+    bool los = losMap_[nodeId];
+    double gx = coord.x / extCellMapStep_;
+    double gy = coord.y / extCellMapStep_;
+    int x = (int) floor(gx);
+    int y = (int) floor(gy);
+    double fx = gx - x;
+    double fy = gy - y;
+
+    const std::vector<double>& i00 = getExtCellMapPoint(map, x, y, los);
+    const std::vector<double>& i10 = getExtCellMapPoint(map, x + 1, y, los);
+    const std::vector<double>& i01 = getExtCellMapPoint(map, x, y + 1, los);
+    const std::vector<double>& i11 = getExtCellMapPoint(map, x + 1, y + 1, los);
 
-    speed = computeSpeed(nodeId, myCoord_);
+    for (unsigned int i = 0; i < band_; i++)
+    {
+        double mean = (1 - fx) * (1 - fy) * i00[i] + fx * (1 - fy) * i10[i] + (1 - fx) * fy * i01[i] + fx * fy * i11[i];
+        (*interference)[i] += mean * shadowing;
+    }
 
-    //    EV << "LteRealisticChannelModel::computeExtCellPathLoss:" << scenario_ << "-" << shadowing_ << "\n";
+    EV << "LteRealisticChannelModel::computeExtCellMapInterference - UE[" << coord.x << "," << coord.y << "] interpolated from grid point ["
+       << x << "," << y << "]" << endl;
+
+    return true;
+}
+
+const std::vector<double>& LteRealisticChannelModel::getExtCellMapPoint(ExtCellInterferenceMap* map, int x, int y, bool los)
+{
+    const std::vector<double>* point = map->getPoint(x, y, los);
+    if (point != NULL)
+        return *point;
+
+    Coord coord(x * extCellMapStep_, y * extCellMapStep_);
+    std::vector<double> interference(band_, 0.0);
+
+    const ExtCellList& list = binder_->getExtCellList();
+    for (ExtCellList::const_iterator it = list.begin(); it != list.end(); ++it)
+    {
+        Coord c = (*it)->getPosition();
+        // grid points may lie out of the validity range of the path loss model, where no UE is
+        double att = computeScenarioPathLoss(coord.distance(c), los, true);
+
+        double angolarAtt = 0;
+        if ((*it)->getTxDirection() != OMNI)
+        {
+            double recvAngle = fabs((*it)->getTxAngle() - computeAngle(c, coord));
+            if (recvAngle > 180)
+                recvAngle = 360 - recvAngle;
+            angolarAtt = computeAngolarAttenuation(recvAngle);
+        }
 
+        double recvPwr = dBmToLinear((*it)->getTxPower() - att - angolarAtt - cableLoss_ + antennaGainEnB_ + antennaGainUe_);
+        for (unsigned int i = 0; i < band_; i++)
+            interference[i] += recvPwr * (*it)->getMeanBandStatus(i);
+    }
+
+    return *map->setPoint(x, y, los, interference);
+}
+
+double LteRealisticChannelModel::computeScenarioPathLoss(double dist, bool los, bool tolerateMaxDistViolation)
+{
     //compute attenuation based on selected scenario and based on LOS or NLOS
     double attenuation = 0;
     double dbp = 0;
     switch (scenario_)
     {
     case INDOOR_HOTSPOT:
-        attenuation = computeIndoor(dist, nodeId);
+        attenuation = computeIndoor(dist, los);
         break;
     case URBAN_MICROCELL:
-        attenuation = computeUrbanMicro(dist, nodeId);
+        attenuation = computeUrbanMicro(dist, los, tolerateMaxDistViolation);
         break;
     case URBAN_MACROCELL:
-        attenuation = computeUrbanMacro(dist, nodeId);
+        attenuation = computeUrbanMacro(dist, los, tolerateMaxDistViolation);
         break;
     case RURAL_MACROCELL:
-        attenuation = computeRuralMacro(dist, dbp, nodeId);
+        attenuation = computeRuralMacro(dist, dbp, los, tolerateMaxDistViolation);
         break;
     case SUBURBAN_MACROCELL:
-        attenuation = computeSubUrbanMacro(dist, dbp, nodeId);
+        attenuation = computeSubUrbanMacro(dist, dbp, los, tolerateMaxDistViolation);
         break;
     default:
         throw cRuntimeError("Wrong path-loss scenario value %d", scenario_);
     }
+    return attenuation;
+}
+
+double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId nodeId)
+{
+    double movement = .0;
+    double speed = .0;
+
+    speed = computeSpeed(nodeId, myCoord_);
+
+    //    EV << "LteRealisticChannelModel::computeExtCellPathLoss:" << scenario_ << "-" << shadowing_ << "\n";
+
+    //compute attenuation based on selected scenario and based on LOS or NLOS
+    double attenuation = computeScenarioPathLoss(dist, losMap_[nodeId], tolerateMaxDistViolation_);
 
     //TODO Apply shadowing to each interfering extCell signal
 
@@ -2875,6 +3019,48 @@ double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId n
     return attenuation;
 }
 
+double LteRealisticChannelModel::nakagamiFading(MacNodeId sourceId, MacNodeId destId, unsigned int band, double distance)
+{
+    if (counterRng_ == NULL && !privateRng_)
+    {
+        inet::units::values::mps speed = inet::units::values::mps(SPEED_OF_LIGHT);
+        inet::units::values::Hz freq = inet::units::values::Hz(carrierFrequency_ * 1000000000);
+        inet::units::values::m dist = inet::units::values::m(distance);
+        return nkgmf->computePathLoss(speed, freq, dist);
+    }
+
+    // free space path loss (alpha = 2, systemLoss = 1), then gamma with shape factor 1
+    double waveLength = SPEED_OF_LIGHT / (carrierFrequency_ * 1000000000);
+    double ratio = waveLength / distance;
+    double freeSpacePathLoss = (distance == 0.0) ? 1.0 : ratio * ratio / (16.0 * M_PI * M_PI);
+    if (counterRng_ != NULL)    // gamma with shape 1 is exponential
+        return drawExponential(sourceId, destId, band, RANDOM_FADING, 0, freeSpacePathLoss / 1000.0) * 1000.0;
+    return gamma_d(rng_, 1.0, freeSpacePathLoss / 1000.0) * 1000.0;
+}
+
+double LteRealisticChannelModel::drawUniform(MacNodeId src, MacNodeId dst, unsigned int band, LteRandomPurpose purpose,
+    unsigned int index, double a, double b)
+{
+    if (counterRng_ == NULL)
+        return uniform(rng_, a, b);
+    return counterRng_->uniform(LteRandomKey(src, dst, band, LteCounterRng::currentTti(), purpose, index), a, b);
+}
+
+double LteRealisticChannelModel::drawNormal(MacNodeId src, MacNodeId dst, LteRandomPurpose purpose, double mean, double stddev)
+{
+    if (counterRng_ == NULL)
+        return normal(rng_, mean, stddev);
+    return counterRng_->normal(LteRandomKey(src, dst, 0, LteCounterRng::currentTti(), purpose), mean, stddev);
+}
+
+double LteRealisticChannelModel::drawExponential(MacNodeId src, MacNodeId dst, unsigned int band, LteRandomPurpose purpose,
+    unsigned int index, double mean)
+{
+    if (counterRng_ == NULL)
+        return exponential(rng_, mean);
+    return counterRng_->exponential(LteRandomKey(src, dst, band, LteCounterRng::currentTti(), purpose, index), mean);
+}
+
 LteRealisticChannelModel::JakesFadingMap * LteRealisticChannelModel::obtainUeJakesMap(MacNodeId id)
 {
     // obtain a reference to UE phy
@@ -2896,7 +3082,6 @@ bool LteRealisticChannelModel::computeMultiCellInterference(MacNodeId eNbId, Mac
     // reference to the mac/phy/channel of each cell
     LtePhyBase * ltePhy;
 
-    int temp;
     double att;
 
     double txPwr;
@@ -2964,29 +3149,19 @@ bool LteRealisticChannelModel::computeMultiCellInterference(MacNodeId eNbId, Mac
 
         txPwr = (*it)->txPwr - angolarAtt - cableLoss_ + antennaGainEnB_ + antennaGainUe_;
 
-        if(isCqi)// check slot occupation for this TTI
-        {
-            for(unsigned int i=0;i<band_;i++)
-            {
-                // compute the number of occupied slot (unnecessary)
-                temp = (*it)->mac->getBandStatus(i);
-                if(temp!=0)
-                    (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
+        // received power, the same on every occupied band
+        double recvPwr = dBmToLinear(txPwr-att);//(dBm-dB)=dBm
 
-                EV << "\t band " << i << " occupied " << temp << "/pwr[" << txPwr << "]-int[" << (*interference)[i] << "]" << endl;
-            }
-        }
-        else // error computation. We need to check the slot occupation of the previous TTI
+        // check slot occupation for this TTI, or for the previous one for error computation
+        const std::vector<bool>* occupied = binder_->getBandOccupancy(id, !isCqi);
+        for(unsigned int i=0;i<band_;i++)
         {
-            for(unsigned int i=0;i<band_;i++)
-            {
-                // compute the number of occupied slot (unnecessary)
-                temp = (*it)->mac->getPrevBandStatus(i);
-                if(temp!=0)
-                    (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
+            // all the bands are free if the eNB has not scheduled yet
+            bool occ = (occupied != NULL && i < occupied->size() && (*occupied)[i]);
+            if(occ)
+                (*interference)[i] += recvPwr;
 
-                EV << "\t band " << i << " occupied " << temp << "/pwr[" << txPwr << "]-int[" << (*interference)[i] << "]" << endl;
-            }
+            EV << "\t band " << i << " occupied " << occ << "/pwr[" << txPwr << "]-int[" << (*interference)[i] << "]" << endl;
         }
         ++it;
     }
@@ -3048,6 +3223,9 @@ bool LteRealisticChannelModel::computeInCellD2DInterference(MacNodeId eNbId, Mac
         txPwr = ltePhy->getTxPwr(dir) - cableLoss_ + 2 * antennaGainUe_;
         EV << "NodeId [" << interferringId << "] - attenuation [" << att << "]" << endl;
 
+        // received power, the same on every occupied band
+        double recvPwr = dBmToLinear(txPwr-att);
+
         // The antenna set in computeTxParams is always "MACRO". Here create a fake set with MACRO as the only element
         std::set<Remote> antennas;
         antennas.insert(MACRO);
@@ -3067,7 +3245,7 @@ bool LteRealisticChannelModel::computeInCellD2DInterference(MacNodeId eNbId, Mac
                     if( temp!=0 )
                     {
                         // Add the interference
-                        (*interference)[i] += dBmToLinear(txPwr-att);
+                        (*interference)[i] += recvPwr;
                     }
                 }
             }
@@ -3084,7 +3262,7 @@ bool LteRealisticChannelModel::computeInCellD2DInterference(MacNodeId eNbId, Mac
                     if( temp!=0 )
                     {
                         // Add the interference
-                        (*interference)[i] += dBmToLinear(txPwr-att);
+                        (*interference)[i] += recvPwr;
                     }
                 }
             }
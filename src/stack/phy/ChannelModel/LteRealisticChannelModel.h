@@ -12,6 +12,8 @@
 
 #include "stack/phy/ChannelModel/LteChannelModel.h"
 #include "inet/physicallayer/pathloss/NakagamiFading.h"
+#include "common/LteCounterRng.h"
+#include "stack/phy/ChannelModel/ExtCellInterferenceMap.h"
 
 class LteBinder;
 
@@ -147,6 +149,23 @@ class LteRealisticChannelModel : public LteChannelModel
 
     inet::physicallayer::NakagamiFading* nkgmf;
 
+    // RNG of the random draws (the global RNG 0, unless a stream has been set by setRNG())
+    cRNG* rng_;
+
+    // true if rng_ has been set by setRNG()
+    bool privateRng_;
+
+    // counter-based RNG ("counter-rng" parameter), replacing rng_ if not NULL
+    LteCounterRng* counterRng_;
+
+    // accuracy of the dB/linear conversions of band vectors ("fast-conversion" parameter)
+    LteConversionMode conversionMode_;
+
+    // grid step of the ext cell interference map, 0 if the map is not used ("extCell-map-step" parameter)
+    double extCellMapStep_;
+    // ext cell interference map matching the configuration of this channel model, got at the first use
+    ExtCellInterferenceMap* extCellMap_;
+
   public:
     LteRealisticChannelModel(ParameterMap& params, const inet::Coord& myCoord, unsigned int band);
     virtual ~LteRealisticChannelModel();
@@ -250,37 +269,41 @@ class LteRealisticChannelModel : public LteChannelModel
      * Compute attenuation for indoor scenario
      *
      * @param distance between UE and eNodeB
-     * @param nodeid mac node id of UE
+     * @param los true if the UE is in line of sight
      */
-    double computeIndoor(double distance, MacNodeId nodeId);
+    double computeIndoor(double distance, bool los);
     /*
      * Compute attenuation for Urban Micro cell
      *
      * @param distance between UE and eNodeB
-     * @param nodeid mac node id of UE
+     * @param los true if the UE is in line of sight
+     * @param tolerateMaxDistViolation if true, return ATT_MAXDISTVIOLATED out of the validity range of the model
      */
-    double computeUrbanMicro(double distance, MacNodeId nodeId);
+    double computeUrbanMicro(double distance, bool los, bool tolerateMaxDistViolation);
     /*
      * compute scenario for Urban Macro cell
      *
      * @param distance between UE and eNodeB
-     * @param nodeid mac node id of UE
+     * @param los true if the UE is in line of sight
+     * @param tolerateMaxDistViolation if true, return ATT_MAXDISTVIOLATED out of the validity range of the model
      */
-    double computeUrbanMacro(double distance, MacNodeId nodeId);
+    double computeUrbanMacro(double distance, bool los, bool tolerateMaxDistViolation);
     /*
      * compute scenario for Sub Urban Macro cell
      *
      * @param distance between UE and eNodeB
-     * @param nodeid mac node id of UE
+     * @param los true if the UE is in line of sight
+     * @param tolerateMaxDistViolation if true, return ATT_MAXDISTVIOLATED out of the validity range of the model
      */
-    double computeSubUrbanMacro(double distance, double& dbp, MacNodeId nodeId);
+    double computeSubUrbanMacro(double distance, double& dbp, bool los, bool tolerateMaxDistViolation);
     /*
      * Compute scenario for rural macro cell
      *
      * @param distance between UE and eNodeB
-     * @param nodeid mac node id of UE
+     * @param los true if the UE is in line of sight
+     * @param tolerateMaxDistViolation if true, return ATT_MAXDISTVIOLATED out of the validity range of the model
      */
-    double computeRuralMacro(double distance, double& dbp, MacNodeId nodeId);
+    double computeRuralMacro(double distance, double& dbp, bool los, bool tolerateMaxDistViolation);
     /*
      * compute std deviation of shadowing according to scenario and visibility
      *
@@ -319,6 +342,33 @@ class LteRealisticChannelModel : public LteChannelModel
         return &jakesFadingMap_;
     }
 
+    /*
+     * Draw the random numbers of this channel model from the given RNG
+     */
+    virtual void setRNG(cRNG* rng)
+    {
+        rng_ = rng;
+        privateRng_ = true;
+    }
+    /*
+     * Receptions only access the state of this channel model unless the D2D in-cell interference
+     * (state of the interfering UEs) or the Rayleigh/Jakes fading (deployer, peer jakes maps) are enabled
+     */
+    virtual bool isReceptionThreadSafe()
+    {
+        return !enableD2DInCellInterference_ && (!fading_ || fadingType_ == NAKAGAMI);
+    }
+    /*
+     * Forget the position history, LOS state, shadowing and fading of the given node
+     */
+    virtual void removeNode(MacNodeId nodeId)
+    {
+        positionHistory_.erase(nodeId);
+        losMap_.erase(nodeId);
+        lastComputedSF_.erase(nodeId);
+        jakesFadingMap_.erase(nodeId);
+    }
+
   protected:
 
     /* compute speed (m/s) for a given node
@@ -353,12 +403,46 @@ class LteRealisticChannelModel : public LteChannelModel
     bool computeExtCellInterference(MacNodeId eNbId, MacNodeId nodeId, inet::Coord coord, bool isCqi,
         std::vector<double>* interference);
 
+    /*
+     * interference of the external cells interpolated from the shared interference map,
+     * with the mean occupation of the bands instead of the current one
+     */
+    bool computeExtCellMapInterference(MacNodeId nodeId, inet::Coord coord, std::vector<double>* interference);
+
+    /*
+     * per-band interference at a point of the ext cell interference map, computed if needed
+     */
+    const std::vector<double>& getExtCellMapPoint(ExtCellInterferenceMap* map, int x, int y, bool los);
+
+    /*
+     * compute attenuation due to path loss of the configured scenario (no shadowing)
+     * @return attenuation expressed in dB
+     */
+    double computeScenarioPathLoss(double dist, bool los, bool tolerateMaxDistViolation);
+
     /*
      * compute attenuation due to path loss and shadowing
      * @return attenuation expressed in dBm
      */
     double computeExtCellPathLoss(double dist, MacNodeId nodeId);
 
+    /*
+     * Nakagami fading for the given link and distance.
+     * With a private or counter-based RNG the draw replicates inet::physicallayer::NakagamiFading
+     * (default parameters) on that RNG, since the INET module draws from RNG 0
+     */
+    double nakagamiFading(MacNodeId sourceId, MacNodeId destId, unsigned int band, double distance);
+
+    /*
+     * Random draws. With "counter-rng" the number is a function of the link (src, dst), the band,
+     * the current TTI, the purpose and the index only; otherwise it is drawn from rng_
+     */
+    double drawUniform(MacNodeId src, MacNodeId dst, unsigned int band, LteRandomPurpose purpose, unsigned int index,
+        double a, double b);
+    double drawNormal(MacNodeId src, MacNodeId dst, LteRandomPurpose purpose, double mean, double stddev);
+    double drawExponential(MacNodeId src, MacNodeId dst, unsigned int band, LteRandomPurpose purpose,
+        unsigned int index, double mean);
+
     /*
      * Obtain the jakes map for the specified UE
      * @param id mac id of the user
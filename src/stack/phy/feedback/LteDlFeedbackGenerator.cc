@@ -392,8 +392,8 @@ void LteDlFeedbackGenerator::initializeFeedbackComputation(
     if (name == 0)
         throw cRuntimeError("Could not read type of feedback computation from configuration file.");
 
-    ParameterMap params;
-    getParametersFromXML(fbComputationData, params);
+    // parsed once for all the nodes sharing the configuration
+    ParameterMap& params = getBinder()->getXmlParameters(fbComputationData);
 
     lteFeedbackComputation_ = getFeedbackComputationFromName(name, params);
 
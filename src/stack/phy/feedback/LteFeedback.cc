@@ -11,7 +11,7 @@
 #include "stack/phy/feedback/LteFeedback.h"
 
 void
-LteSummaryBuffer::createSummary(LteFeedback fb)
+LteSummaryBuffer::createSummary(const LteFeedback& fb)
 {
     try
     {
@@ -27,7 +27,7 @@ LteSummaryBuffer::createSummary(LteFeedback fb)
         // CQI
         if (fb.hasBandCqi()) // Per-band
         {
-            std::vector<CqiVector> cqi = fb.getBandCqi();
+            const std::vector<CqiVector>& cqi = fb.getBandCqi();
             unsigned int n = cqi.size();
             for (Codeword cw = 0; cw < n; ++cw)
                 for (Band i = 0; i < totBands_; ++i)
@@ -37,7 +37,7 @@ LteSummaryBuffer::createSummary(LteFeedback fb)
         {
             if (fb.hasWbCqi()) // Wide-band
             {
-                CqiVector cqi(fb.getWbCqi());
+                const CqiVector& cqi = fb.getWbCqi();
                 unsigned int n = cqi.size();
                 for (Codeword cw = 0; cw < n; ++cw)
                     for (Band i = 0; i < totBands_; ++i)
@@ -45,12 +45,12 @@ LteSummaryBuffer::createSummary(LteFeedback fb)
             }
             if (fb.hasPreferredCqi()) // Preferred-band
             {
-                CqiVector cqi(fb.getPreferredCqi());
-                BandSet bands(fb.getPreferredBands());
+                const CqiVector& cqi = fb.getPreferredCqi();
+                const BandSet& bands = fb.getPreferredBands();
                 unsigned int n = cqi.size();
-                BandSet::iterator et = bands.end();
+                BandSet::const_iterator et = bands.end();
                 for (Codeword cw = 0; cw < n; ++cw)
-                    for (BandSet::iterator it = bands.begin(); it != et; ++it)
+                    for (BandSet::const_iterator it = bands.begin(); it != et; ++it)
                         cumulativeSummary_.setCqi(cqi.at(cw), cw, *it); // mette lo stesso cqi solo sulle bande preferite della stessa cw
             }
         }
@@ -60,7 +60,7 @@ LteSummaryBuffer::createSummary(LteFeedback fb)
         // PMI
         if (fb.hasBandPmi()) // Per-band
         {
-            PmiVector pmi(fb.getBandPmi());
+            const PmiVector& pmi = fb.getBandPmi();
             for (Band i = 0; i < totBands_; ++i)
                 cumulativeSummary_.setPmi(pmi.at(i), i);
         }
@@ -77,9 +77,9 @@ LteSummaryBuffer::createSummary(LteFeedback fb)
             {
                 // Preferred-band
                 Pmi pmi(fb.getPreferredPmi());
-                BandSet bands(fb.getPreferredBands());
-                BandSet::iterator et = bands.end();
-                for (BandSet::iterator it = bands.begin(); it != et; ++it)
+                const BandSet& bands = fb.getPreferredBands();
+                BandSet::const_iterator et = bands.end();
+                for (BandSet::const_iterator it = bands.begin(); it != et; ++it)
                     cumulativeSummary_.setPmi(pmi, *it);
             }
         }
@@ -139,7 +139,7 @@ class LteFeedback
         return rank_;
     }
     //! Get the wide-band CQI. Does not check if valid.
-    CqiVector getWbCqi() const
+    const CqiVector& getWbCqi() const
     {
         return wideBandCqi_;
     }
@@ -154,22 +154,22 @@ class LteFeedback
         return wideBandPmi_;
     }
     //! Get the per-band CQI. Does not check if valid.
-    std::vector<CqiVector> getBandCqi() const
+    const std::vector<CqiVector>& getBandCqi() const
     {
         return perBandCqi_;
     }
     //! Get the per-band CQI for one codeword. Does not check if valid.
-    CqiVector getBandCqi(Codeword cw) const
+    const CqiVector& getBandCqi(Codeword cw) const
     {
         return perBandCqi_[cw];
     }
     //! Get the per-band PMI. Does not check if valid.
-    PmiVector getBandPmi() const
+    const PmiVector& getBandPmi() const
     {
         return perBandPmi_;
     }
     //! Get the per preferred band CQI. Does not check if valid.
-    CqiVector getPreferredCqi() const
+    const CqiVector& getPreferredCqi() const
     {
         return preferredCqi_;
     }
@@ -184,7 +184,7 @@ class LteFeedback
         return preferredPmi_;
     }
     //! Get the set of preferred bands. Does not check if valid.
-    BandSet getPreferredBands() const
+    const BandSet& getPreferredBands() const
     {
         return preferredBands_;
     }
@@ -567,7 +567,7 @@ class LteSummaryFeedback
         return confidence(tPmi_.at(band));
     }
 
-    bool isValid()
+    bool isValid() const
     {
         return valid_;
     }
@@ -639,47 +639,41 @@ class LteSummaryFeedback
     }
 };
 
+/**
+ * Feedback of a user, for one antenna and transmission mode.
+ *
+ * Received feedbacks are merged into a cumulative summary. The feedbacks
+ * themselves are not kept, since nothing reads them once summarized: the
+ * buffer holds no more than the summary, whatever its nominal capacity.
+ */
 class LteSummaryBuffer
 {
   protected:
-    //! Buffer dimension
-    unsigned char bufferSize_;
-    //! The buffer
-    std::list<LteFeedback> buffer_;
     //! Number of codewords.
     double totCodewords_;
     //! Number of bands.
     double totBands_;
     //! Cumulative summary feedback.
     LteSummaryFeedback cumulativeSummary_;
-    void createSummary(LteFeedback fb);
+    void createSummary(const LteFeedback& fb);
 
   public:
 
     LteSummaryBuffer(unsigned char dim, unsigned char cw, unsigned int b, simtime_t lb, simtime_t ub) :
         cumulativeSummary_(cw, b, lb, ub)
     {
-        bufferSize_ = dim;
         totCodewords_ = cw;
         totBands_ = b;
     }
 
     //! Put a feedback into the buffer and update current summary feedback
-    void put(LteFeedback fb)
+    void put(const LteFeedback& fb)
     {
-        if (bufferSize_ > 0)
-        {
-            buffer_.push_back(fb);
-        }
-        if (buffer_.size() > bufferSize_)
-        {
-            buffer_.pop_front();
-        }
         createSummary(fb);
     }
 
     //! Get the current summary feedback
-    LteSummaryFeedback get() const
+    const LteSummaryFeedback& get() const
     {
         return cumulativeSummary_;
     }
@@ -13,7 +13,7 @@
 #include "corenetwork/binder/LteBinder.h"
 
 LteFeedbackComputationRealistic::LteFeedbackComputationRealistic(double targetBler, std::map<MacNodeId, Lambda>* lambda,
-    double lambdaMinTh, double lambdaMaxTh, double lambdaRatioTh, unsigned int numBands)
+    double lambdaMinTh, double lambdaMaxTh, double lambdaRatioTh, unsigned int numBands, bool cqiTable, double snrStep)
 {
     targetBler_ = targetBler;
     lambda_ = lambda;
@@ -22,6 +22,23 @@ LteFeedbackComputationRealistic::LteFeedbackComputationRealistic(double targetBl
     lambdaMaxTh_ = lambdaMaxTh;
     lambdaRatioTh_ = lambdaRatioTh;
     phyPisaData_ = &(getBinder()->phyPisaData);
+
+    if (snrStep <= 0)
+        throw cRuntimeError("LteFeedbackComputationRealistic: snrStep must be positive, %f given", snrStep);
+    snrStep_ = snrStep;
+    maxSnrStep_ = floor(phyPisaData_->maxSnr() / snrStep_ + 1e-9);
+
+    // the cqi only depends on txmode, SNR step and target bler: compute it once for all
+    if (cqiTable)
+    {
+        cqiTable_.resize(phyPisaData_->nTxMode());
+        for (unsigned int txm = 0; txm < cqiTable_.size(); txm++)
+        {
+            cqiTable_[txm].resize(maxSnrStep_ + 1);
+            for (int step = 0; step <= maxSnrStep_; step++)
+                cqiTable_[txm][step] = computeCqi(txm, step);
+        }
+    }
 }
 
 LteFeedbackComputationRealistic::~LteFeedbackComputationRealistic()
@@ -30,7 +47,7 @@ LteFeedbackComputationRealistic::~LteFeedbackComputationRealistic()
 }
 
 void LteFeedbackComputationRealistic::generateBaseFeedback(int numBands, int numPreferredBands, LteFeedback& fb,
-    FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr)
+    FeedbackType fbType, int cw, RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr)
 {
     int layer = 1;
     std::vector<CqiVector> cqiTmp2;
@@ -60,17 +77,10 @@ void LteFeedbackComputationRealistic::generateBaseFeedback(int numBands, int num
     {
         if (rbAllocationType == TYPE2_LOCALIZED)
         {
-            cqiTmp2.resize(layer);
-            for (unsigned int i = 0; i < cqiTmp2.size(); i++)
-            {
-                cqiTmp2[i].resize(numBands, 0);
-                for (int j = 0; j < numBands; j++)
-                {
-                    cqi = getCqi(txmode, snr[j]);
-                    cqiTmp2[i][j] = cqi;
-                }
-                fb.setPerBandCqi(cqiTmp2[i], i);
-            }
+            // same per-band cqi for all the layers
+            getCqi(txmode, snr, numBands, cqiTmp);
+            for (int i = 0; i < layer; i++)
+                fb.setPerBandCqi(cqiTmp, i);
         }
         else if (rbAllocationType == TYPE2_DISTRIBUTED)
         {
@@ -103,30 +113,68 @@ unsigned int LteFeedbackComputationRealistic::computeRank(MacNodeId id)
 
 Cqi LteFeedbackComputationRealistic::getCqi(TxMode txmode, double snr)
 {
-    int newsnr = floor(snr + 0.5);
-    if (newsnr < 0)
+    int step = floor(snr / snrStep_ + 0.5);
+    if (step < 0)
         return 0;
-    if (newsnr > phyPisaData_->maxSnr())
+    if (step > maxSnrStep_)
         return 15;
     unsigned int txm = txModeToIndex[txmode];
-    std::vector<double> min;
+    if (!cqiTable_.empty())
+        return cqiTable_[txm][step];
+    return computeCqi(txm, step);
+}
+
+void LteFeedbackComputationRealistic::getCqi(TxMode txmode, const std::vector<double>& snr, int numBands,
+    CqiVector& cqi)
+{
+    cqi.resize(numBands);
+    if (cqiTable_.empty())
+    {
+        for (int j = 0; j < numBands; j++)
+            cqi[j] = getCqi(txmode, snr[j]);
+        return;
+    }
+
+    const CqiVector& table = cqiTable_[txModeToIndex[txmode]];
+    for (int j = 0; j < numBands; j++)
+    {
+        int step = floor(snr[j] / snrStep_ + 0.5);
+        if (step < 0)
+            cqi[j] = 0;
+        else if (step > maxSnrStep_)
+            cqi[j] = 15;
+        else
+            cqi[j] = table[step];
+    }
+}
+
+Cqi LteFeedbackComputationRealistic::computeCqi(unsigned int txm, int step)
+{
+    double snr = step * snrStep_;
     int found = 0;
     double low = 2;
-    min.resize(phyPisaData_->nMcs(), 2);
     for (int i = 0; i < phyPisaData_->nMcs(); i++)
     {
-        double tmp = phyPisaData_->getBler(txm, i, newsnr);
-        double diff = targetBler_ - tmp;
-        min[i] = (diff > 0) ? diff : (diff * -1);
-        if (low >= min[i])
+        double diff = fabs(targetBler_ - getBler(txm, i, snr));
+        if (low >= diff)
         {
             found = i;
-            low = min[i];
+            low = diff;
         }
     }
     return found + 1;
 }
 
+double LteFeedbackComputationRealistic::getBler(unsigned int txm, int mcs, double snr)
+{
+    int low = floor(snr);
+    double frac = snr - low;
+    double bler = phyPisaData_->getBler(txm, mcs, low);
+    if (frac > 0 && low < phyPisaData_->maxSnr())
+        bler += frac * (phyPisaData_->getBler(txm, mcs, low + 1) - bler);
+    return bler;
+}
+
 LteFeedbackDoubleVector LteFeedbackComputationRealistic::computeFeedback(FeedbackType fbType,
     RbAllocationType rbAllocationType, TxMode currentTxMode,
     std::map<Remote, int> antennaCws, int numPreferredBands, FeedbackGeneratorType feedbackGeneratortype, int numRus,
@@ -253,10 +301,10 @@ LteFeedback LteFeedbackComputationRealistic::computeFeedback(const Remote remote
     return fb;
 }
 
-double LteFeedbackComputationRealistic::meanSnr(std::vector<double> snr)
+double LteFeedbackComputationRealistic::meanSnr(const std::vector<double>& snr)
 {
     double mean = 0;
-    std::vector<double>::iterator it;
+    std::vector<double>::const_iterator it;
     for (it = snr.begin(); it != snr.end(); ++it)
         mean += *it;
     mean /= snr.size();
@@ -27,19 +27,37 @@ class LteFeedbackComputationRealistic : public LteFeedbackComputation
     double lambdaRatioTh_;
     //pointer to pisadata
     PhyPisaData* phyPisaData_;
+    //SNR step (dB) between two CQI table entries
+    double snrStep_;
+    //index of the highest SNR step within the BLER curves
+    int maxSnrStep_;
+    //CQI of each SNR step, for each txmode (empty if computed on demand)
+    std::vector<CqiVector> cqiTable_;
 
   protected:
     // Rank computation
     unsigned int computeRank(MacNodeId id);
     // Generate base feedback for all types of feedback(allbands, preferred, wideband)
     void generateBaseFeedback(int numBands, int numPreferredBabds, LteFeedback& fb, FeedbackType fbType, int cw,
-        RbAllocationType rbAllocationType, TxMode txmode, std::vector<double> snr);
+        RbAllocationType rbAllocationType, TxMode txmode, const std::vector<double>& snr);
     // Get cqi from BLer Curves
     Cqi getCqi(TxMode txmode, double snr);
-    double meanSnr(std::vector<double> snr);
+    // Get the cqi of the first numBands bands
+    void getCqi(TxMode txmode, const std::vector<double>& snr, int numBands, CqiVector& cqi);
+    // Scan the BLer Curves of txmode index txm for the cqi at the given SNR step
+    Cqi computeCqi(unsigned int txm, int step);
+    // Bler of the given mcs at the given SNR, interpolated between the integer points of the curves
+    double getBler(unsigned int txm, int mcs, double snr);
+    double meanSnr(const std::vector<double>& snr);
     public:
+    /*
+     * If cqiTable is true, the cqi of each SNR step and txmode is computed when the object is built,
+     * and feedback computation only looks it up.
+     * The SNR is rounded to a multiple of snrStep (dB): with the default of 1dB the cqi is the one of
+     * the closest point of the BLer curves, with a fraction of dB the curves are interpolated.
+     */
     LteFeedbackComputationRealistic(double targetBler, std::map<MacNodeId, Lambda>* lambda, double lambdaMinTh,
-        double lambdaMaxTh, double lambdaRatioTh, unsigned int numBands);
+        double lambdaMaxTh, double lambdaRatioTh, unsigned int numBands, bool cqiTable = true, double snrStep = 1);
     virtual ~LteFeedbackComputationRealistic();
 
     virtual LteFeedbackDoubleVector computeFeedback(FeedbackType fbType, RbAllocationType rbAllocationType,
@@ -15,11 +15,26 @@ short LtePhyBase::airFramePriority_ = 10;
 LtePhyBase::LtePhyBase()
 {
     channelModel_ = NULL;
+    binder_ = NULL;
+    nodeId_ = 0;
 }
 
 LtePhyBase::~LtePhyBase()
 {
     delete channelModel_;
+
+    if (binder_ != NULL && getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        binder_->removeNodeListener(this);
+}
+
+void LtePhyBase::nodeLeft(MacNodeId nodeId)
+{
+    if (nodeId == nodeId_)
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+    if (channelModel_ != NULL)
+        channelModel_->removeNode(nodeId);
 }
 
 void LtePhyBase::initialize(int stage)
@@ -29,6 +44,7 @@ void LtePhyBase::initialize(int stage)
     if (stage == inet::INITSTAGE_LOCAL)
     {
         binder_ = getBinder();
+        binder_->addNodeListener(this);
         deployer_ = NULL;
         // get gate ids
         upperGateIn_ = findGate("upperGateIn");
@@ -63,6 +79,18 @@ void LtePhyBase::handleMessage(cMessage* msg)
     // AirFrame
     else if (msg->getArrivalGate()->getId() == radioInGate_)
     {
+        // drop the frames whose sender has left the simulation in the meantime,
+        // even if its id has already been assigned to another node
+        UserControlInfo* lteInfo = dynamic_cast<UserControlInfo*>(msg->getControlInfo());
+        if (lteInfo != NULL && !binder_->isCurrentNode(lteInfo->getSourceId(), lteInfo->getSourceGeneration()))
+        {
+            EV << "LtePhyBase::handleMessage - sender " << lteInfo->getSourceId() << " has left, frame dropped" << endl;
+            delete msg;
+            return;
+        }
+        // this node may now keep state about the sender, to be dropped when it leaves
+        if (lteInfo != NULL)
+            binder_->addNodeReceiver(lteInfo->getSourceId(), nodeId_);
         handleAirFrame(msg);
     }
 
@@ -171,8 +199,8 @@ void LtePhyBase::initializeChannelModel(cXMLElement* xmlConfig)
     if (name == 0)
         throw cRuntimeError("Could not read name of channel model");
 
-    ParameterMap params;
-    getParametersFromXML(channelModelData, params);
+    // parsed once for all the nodes sharing the configuration
+    ParameterMap& params = binder_->getXmlParameters(channelModelData);
 
     LteChannelModel* newChannelModel = getChannelModelFromName(name, params);
 
@@ -181,6 +209,7 @@ void LtePhyBase::initializeChannelModel(cXMLElement* xmlConfig)
 
     // attach the new AnalogueModel to the AnalogueModelList
     channelModel_ = newChannelModel;
+    channelModel_->setOwnerId(nodeId_);
 
     EV << "ChannelModel \"" << name << "\" loaded." << endl;
     return;
@@ -218,6 +247,9 @@ void LtePhyBase::updateDisplayString()
 
 void LtePhyBase::sendBroadcast(LteAirFrame *airFrame)
 {
+    UserControlInfo *ci = check_and_cast<UserControlInfo *>(airFrame->getControlInfo());
+    ci->setSourceGeneration(binder_->getNodeGeneration(ci->getSourceId()));
+
     // delegate the ChannelControl to send the airframe
     sendToChannel(airFrame);
 
@@ -279,6 +311,7 @@ void LtePhyBase::sendUnicast(LteAirFrame *frame)
         frame->getControlInfo());
     // dest MacNodeId from control info
     MacNodeId dest = ci->getDestId();
+    ci->setSourceGeneration(binder_->getNodeGeneration(ci->getSourceId()));
     // destination node (UE, RELAY or ENODEB) omnet id
     try {
         binder_->getOmnetId(dest);
@@ -286,7 +319,8 @@ void LtePhyBase::sendUnicast(LteAirFrame *frame)
         delete frame;
         return;         // make sure that nodes that left the simulation do not send
     }
-    OmnetId destOmnetId = binder_->getOmnetId(dest);
+    OmnetId destOmnetId = (ci->getDestGeneration() < 0) ? binder_->getOmnetId(dest) :
+        binder_->getOmnetId(dest, ci->getDestGeneration());
     if (destOmnetId == 0){
         // destination node has left the simulation
         delete frame;
@@ -19,6 +19,7 @@
 #include "world/radio/ChannelControl.h"
 #include "common/LteCommon.h"
 #include "common/LteControlInfo.h"
+#include "common/LteNodeListener.h"
 #include "stack/phy/packet/LteAirFrame.h"
 #include "stack/mac/layer/LteMacEnb.h"
 #include "stack/mac/amc/LteAmc.h"
@@ -44,7 +45,7 @@
  * LteStack with LteDeciderControlInfo attached.
  */
 
-class LtePhyBase : public ChannelAccess
+class LtePhyBase : public ChannelAccess, public LteNodeListener
 {
     friend class DasFilter;
 
@@ -167,6 +168,14 @@ class LtePhyBase : public ChannelAccess
         return txAngle_;
     }
 
+    /**
+     * Called by the binder when a node leaves the simulation:
+     * drops the channel model state about it
+     *
+     * @param nodeId Id of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
+
   protected:
 
     /**
@@ -388,6 +388,8 @@ LteFeedbackComputation* LtePhyEnb::getFeedbackComputationFromName(
         double lambdaMinTh = 0.02;
         double lambdaMaxTh = 0.2;
         double lambdaRatioTh = 20;
+        bool cqiTable = true;
+        double cqiSnrStep = 1;
         it = params.find("targetBler");
         if (it != params.end())
         {
@@ -408,9 +410,19 @@ LteFeedbackComputation* LtePhyEnb::getFeedbackComputationFromName(
         {
             lambdaRatioTh = params["lambdaRatioTh"].doubleValue();
         }
+        it = params.find("cqiTable");
+        if (it != params.end())
+        {
+            cqiTable = params["cqiTable"].boolValue();
+        }
+        it = params.find("cqiSnrStep");
+        if (it != params.end())
+        {
+            cqiSnrStep = params["cqiSnrStep"].doubleValue();
+        }
         LteFeedbackComputation* fbcomp = new LteFeedbackComputationRealistic(
             targetBler, deployer_->getLambda(), lambdaMinTh, lambdaMaxTh,
-            lambdaRatioTh, deployer_->getNumBands());
+            lambdaRatioTh, deployer_->getNumBands(), cqiTable, cqiSnrStep);
         return fbcomp;
     }
     else
@@ -156,6 +156,7 @@ void LtePhyUe::initialize(int stage)
     {
         // get local id
         nodeId_ = getAncestorPar("macNodeId");
+        channelModel_->setOwnerId(nodeId_);
         EV << "Local MacNodeId: " << nodeId_ << endl;
 
         // get deployer at this stage because the next hop of the node is registered in the IP2Lte module at the INITSTAGE_NETWORK_LAYER
@@ -28,10 +28,30 @@ LtePhyVUeMode4::LtePhyVUeMode4()
 {
     handoverStarter_ = NULL;
     handoverTrigger_ = NULL;
+    d2dDecodingTimer_ = NULL;
+    updateSubframeTimer_ = NULL;
+    parallelReception_ = false;
+    receptionRng_ = NULL;
 }
 
 LtePhyVUeMode4::~LtePhyVUeMode4()
 {
+    delete updateSubframeTimer_;
+    delete d2dDecodingTimer_;
+
+    if (parallelReception_ && getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        binder_->removeReceptionTask(this);
+    delete receptionRng_;
+}
+
+void LtePhyVUeMode4::nodeLeft(MacNodeId nodeId)
+{
+    if (nodeId == nodeId_)
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+    LtePhyUeD2D::nodeLeft(nodeId);
+    previousTransmissionTimes_.erase(nodeId);
 }
 
 void LtePhyVUeMode4::initialize(int stage)
@@ -46,7 +66,8 @@ void LtePhyVUeMode4::initialize(int stage)
         selectionWindowStartingSubframe_ = par("selectionWindowStartingSubframe");
         numSubchannels_ = par("numSubchannels");
         subchannelSize_ = par("subchannelSize");
-        d2dDecodingTimer_ = NULL;
+        d2dDecodingTimer_ = new TtiTimer(this, this, "d2dDecodingTimer", D2D_DECODING_TIMER, TTI_PHASE_DECODING);   // last thing to be performed in this TTI
+        updateSubframeTimer_ = new TtiTimer(this, this, "updateSubframe", UPDATE_SUBFRAME, TTI_PHASE_SUBFRAME);   // at start of next TTI
         transmitting_ = false;
 
         int thresholdRSSI = par("thresholdRSSI");
@@ -66,30 +87,50 @@ void LtePhyVUeMode4::initialize(int stage)
             ThresPSSCHRSRPvector_.push_back(i);
         }
 
-        cbr                    = registerSignal("cbr");
-        sciReceived            = registerSignal("sciReceived");
-        sciDecoded             = registerSignal("sciDecoded");
-        sciNotDecoded          = registerSignal("sciNotDecoded");
-        sciSent                = registerSignal("sciSent");
-        tbSent                 = registerSignal("tbSent");
-        tbReceived             = registerSignal("tbReceived");
-        tbDecoded              = registerSignal("tbDecoded");
-        tbFailedDueToNoSCI     = registerSignal("tbFailedDueToNoSCI");
-        tbFailedButSCIReceived = registerSignal("tbFailedButSCIReceived");
-        tbAndSCINotReceived    = registerSignal("tbAndSCINotReceived");
-        threshold              = registerSignal("threshold");
-        txRxDistanceTB         = registerSignal("txRxDistanceTB");
-        txRxDistanceSCI        = registerSignal("txRxDistanceSCI");
-        sciFailedHalfDuplex    = registerSignal("sciFailedHalfDuplex");
-        tbFailedHalfDuplex     = registerSignal("tbFailedHalfDuplex");
-        subchannelReceived     = registerSignal("subchannelReceived");
-        subchannelsUsed        = registerSignal("subchannelsUsed");
-        senderID               = registerSignal("senderID");
-        subchannelSent         = registerSignal("subchannelSent");
-        subchannelsUsedToSend  = registerSignal("subchannelsUsedToSend");
-        interPacketDelay       = registerSignal("interPacketDelay");
-        posX                   = registerSignal("posX");
-        posY                   = registerSignal("posY");
+        // Counters are summed over the aggregation period, samples are averaged.
+        // The sender ID is an identifier and is never aggregated.
+        simtime_t aggregationPeriod = par("statisticAggregationPeriod");
+
+        cbr.init(this, "cbr", AGGREGATE_MEAN, aggregationPeriod);
+        sciReceived.init(this, "sciReceived", AGGREGATE_SUM, aggregationPeriod);
+        sciDecoded.init(this, "sciDecoded", AGGREGATE_SUM, aggregationPeriod);
+        sciNotDecoded.init(this, "sciNotDecoded", AGGREGATE_SUM, aggregationPeriod);
+        sciSent.init(this, "sciSent", AGGREGATE_SUM, aggregationPeriod);
+        tbSent.init(this, "tbSent", AGGREGATE_SUM, aggregationPeriod);
+        tbReceived.init(this, "tbReceived", AGGREGATE_SUM, aggregationPeriod);
+        tbDecoded.init(this, "tbDecoded", AGGREGATE_SUM, aggregationPeriod);
+        tbFailedDueToNoSCI.init(this, "tbFailedDueToNoSCI", AGGREGATE_SUM, aggregationPeriod);
+        tbFailedButSCIReceived.init(this, "tbFailedButSCIReceived", AGGREGATE_SUM, aggregationPeriod);
+        tbAndSCINotReceived.init(this, "tbAndSCINotReceived", AGGREGATE_SUM, aggregationPeriod);
+        threshold.init(this, "threshold", AGGREGATE_MEAN, aggregationPeriod);
+        txRxDistanceTB.init(this, "txRxDistanceTB", AGGREGATE_MEAN, aggregationPeriod);
+        txRxDistanceSCI.init(this, "txRxDistanceSCI", AGGREGATE_MEAN, aggregationPeriod);
+        sciFailedHalfDuplex.init(this, "sciFailedHalfDuplex", AGGREGATE_SUM, aggregationPeriod);
+        tbFailedHalfDuplex.init(this, "tbFailedHalfDuplex", AGGREGATE_SUM, aggregationPeriod);
+        subchannelReceived.init(this, "subchannelReceived", AGGREGATE_MEAN, aggregationPeriod);
+        subchannelsUsed.init(this, "subchannelsUsed", AGGREGATE_MEAN, aggregationPeriod);
+        senderID.init(this, "senderID");
+        subchannelSent.init(this, "subchannelSent", AGGREGATE_MEAN, aggregationPeriod);
+        subchannelsUsedToSend.init(this, "subchannelsUsedToSend", AGGREGATE_MEAN, aggregationPeriod);
+        interPacketDelay.init(this, "interPacketDelay", AGGREGATE_MEAN, aggregationPeriod);
+        posX.init(this, "posX", AGGREGATE_MEAN, aggregationPeriod);
+        posY.init(this, "posY", AGGREGATE_MEAN, aggregationPeriod);
+
+        LteStatistic* statistics[] = {
+            &cbr, &sciReceived, &sciDecoded, &sciNotDecoded, &sciSent, &tbSent, &tbReceived, &tbDecoded,
+            &tbFailedDueToNoSCI, &tbFailedButSCIReceived, &tbAndSCINotReceived, &sciFailedHalfDuplex,
+            &tbFailedHalfDuplex, &threshold, &txRxDistanceSCI, &txRxDistanceTB, &subchannelReceived,
+            &subchannelsUsed, &senderID, &subchannelSent, &subchannelsUsedToSend, &interPacketDelay, &posX, &posY
+        };
+        for (LteStatistic* statistic : statistics)
+        {
+            if (statistic->enabled() && statistic->aggregated())
+                aggregatedStatistics_.push_back(statistic);
+        }
+
+        // The -1 placeholders emitted for SCIs without a TB only keep per-reception vectors aligned,
+        // they would corrupt aggregated counters
+        emitMissingTbPlaceholders_ = (aggregationPeriod == 0);
 
         sciReceived_ = 0;
         sciDecoded_ = 0;
@@ -115,6 +156,21 @@ void LtePhyVUeMode4::initialize(int stage)
         deployer_->channelUpdate(nodeId_, intuniform(1, binder_->phyPisaData.maxChannel2()));
 
         nodeId_ = getAncestorPar("macNodeId");
+        channelModel_->setOwnerId(nodeId_);
+
+        parallelReception_ = binder_->isParallelReceptionEnabled();
+        if (parallelReception_)
+        {
+            if (!channelModel_->isReceptionThreadSafe())
+                throw cRuntimeError("LtePhyVUeMode4::initialize - parallel reception requires a channel model without D2D in-cell interference and with Nakagami (or no) fading");
+
+            // one stream per receiver, seeded from the seed set and the node id, so that the results
+            // do not depend on the order the receivers are measured in
+            int seedSet = atoi(getEnvir()->getConfigEx()->getVariable("seedset"));
+            receptionRng_ = new cMersenneTwister();
+            receptionRng_->initialize(seedSet, nodeId_, 65536, 0, 1, getEnvir()->getConfig());
+            channelModel_->setRNG(receptionRng_);
+        }
 
         initialiseSensingWindow();
     }
@@ -122,126 +178,170 @@ void LtePhyVUeMode4::initialize(int stage)
 
 void LtePhyVUeMode4::handleSelfMessage(cMessage *msg)
 {
-    if (msg->isName("d2dDecodingTimer"))
+    if (msg->getKind() == D2D_DECODING_TIMER)
     {
-        std::vector<int> missingTbs;
-        for (int i=0; i<sciFrames_.size(); i++){
-            bool foundTB=false;
-            LteAirFrame* sciFrame = sciFrames_[i];
-            UserControlInfo* sciInfo = check_and_cast<UserControlInfo*>(sciFrame->removeControlInfo());
-            for (int j=0; j<tbFrames_.size();j++){
-                LteAirFrame* tbFrame = tbFrames_[j];
-                UserControlInfo* tbInfo = check_and_cast<UserControlInfo*>(tbFrame->removeControlInfo());
-                if (sciInfo->getSourceId() == tbInfo->getSourceId()){
-                    foundTB = true;
-                    tbFrame->setControlInfo(tbInfo);
-                    break;
-                }
+        d2dDecodingTimer_->handle();
+    }
+    else if (msg->getKind() == UPDATE_SUBFRAME)
+    {
+        updateSubframeTimer_->handle();
+    }
+    else
+        LtePhyUe::handleSelfMessage(msg);
+}
+
+void LtePhyVUeMode4::decodeReceivedFrames()
+{
+    // airframes received after the measurement phase of the binder
+    if (!pendingMeasurements_.empty())
+    {
+        binder_->removeReceptionTask(this);
+        execute();
+    }
+
+    std::vector<int> missingTbs;
+    for (int i=0; i<sciFrames_.size(); i++){
+        bool foundTB=false;
+        LteAirFrame* sciFrame = sciFrames_[i];
+        UserControlInfo* sciInfo = check_and_cast<UserControlInfo*>(sciFrame->removeControlInfo());
+        for (int j=0; j<tbFrames_.size();j++){
+            LteAirFrame* tbFrame = tbFrames_[j];
+            UserControlInfo* tbInfo = check_and_cast<UserControlInfo*>(tbFrame->removeControlInfo());
+            if (sciInfo->getSourceId() == tbInfo->getSourceId()){
+                foundTB = true;
                 tbFrame->setControlInfo(tbInfo);
+                break;
             }
-            if (!foundTB){
-                missingTbs.push_back(i);
-            }
-            sciFrame->setControlInfo(sciInfo);
+            tbFrame->setControlInfo(tbInfo);
+        }
+        if (!foundTB){
+            missingTbs.push_back(i);
         }
+        sciFrame->setControlInfo(sciInfo);
+    }
 
-        while (!sciFrames_.empty()){
-            // Get received SCI and it's corresponding RsrpVector
-            LteAirFrame* frame = sciFrames_.back();
-            std::vector<double> rsrpVector = sciRsrpVectors_.back();
-            std::vector<double> rssiVector = sciRssiVectors_.back();
+    while (!sciFrames_.empty()){
+        // Get received SCI and it's corresponding RsrpVector
+        LteAirFrame* frame = sciFrames_.back();
+        std::vector<double> rsrpVector = sciRsrpVectors_.back();
+        std::vector<double> rssiVector = sciRssiVectors_.back();
 
-            // Remove it from the vector
-            sciFrames_.pop_back();
-            sciRsrpVectors_.pop_back();
-            sciRssiVectors_.pop_back();
+        // Remove it from the vector
+        sciFrames_.pop_back();
+        sciRsrpVectors_.pop_back();
+        sciRssiVectors_.pop_back();
 
-            UserControlInfo* lteInfo = check_and_cast<UserControlInfo*>(frame->removeControlInfo());
+        UserControlInfo* lteInfo = check_and_cast<UserControlInfo*>(frame->removeControlInfo());
+
+        // decode the selected frame
+        decodeAirFrame(frame, lteInfo, rsrpVector, rssiVector);
+
+        sciReceived.emit(sciReceived_);
+        sciDecoded.emit(sciDecoded_);
+        sciNotDecoded.emit(sciNotDecoded_);
+        sciFailedHalfDuplex.emit(sciFailedHalfDuplex_);
+        subchannelReceived.emit(subchannelReceived_);
+        subchannelsUsed.emit(subchannelsUsed_);
+
+        sciReceived_ = 0;
+        sciDecoded_ = 0;
+        sciNotDecoded_ = 0;
+        sciFailedHalfDuplex_ = 0;
+        subchannelReceived_ = 0;
+        subchannelsUsed_ = 0;
+    }
+    int countTbs = 0;
+    if (tbFrames_.empty() && emitMissingTbPlaceholders_){
+        for(countTbs; countTbs<missingTbs.size(); countTbs++){
+            emitMissingTb();
+        }
+    }
+    while (!tbFrames_.empty())
+    {
+        if(std::find(missingTbs.begin(), missingTbs.end(), countTbs) != missingTbs.end()) {
+            // This corresponds to where we are missing a TB, record results as being negative to identify this.
+            if (emitMissingTbPlaceholders_)
+                emitMissingTb();
+        } else {
+            LteAirFrame *frame = tbFrames_.back();
+            std::vector<double> rsrpVector = tbRsrpVectors_.back();
+            std::vector<double> rssiVector = tbRssiVectors_.back();
+
+            tbFrames_.pop_back();
+            tbRsrpVectors_.pop_back();
+            tbRssiVectors_.pop_back();
+
+            UserControlInfo *lteInfo = check_and_cast<UserControlInfo *>(frame->removeControlInfo());
 
             // decode the selected frame
             decodeAirFrame(frame, lteInfo, rsrpVector, rssiVector);
 
-            emit(sciReceived, sciReceived_);
-            emit(sciDecoded, sciDecoded_);
-            emit(sciNotDecoded, sciNotDecoded_);
-            emit(sciFailedHalfDuplex, sciFailedHalfDuplex_);
-            emit(subchannelReceived, subchannelReceived_);
-            emit(subchannelsUsed, subchannelsUsed_);
-
-            sciReceived_ = 0;
-            sciDecoded_ = 0;
-            sciNotDecoded_ = 0;
-            sciFailedHalfDuplex_ = 0;
-            subchannelReceived_ = 0;
-            subchannelsUsed_ = 0;
-        }
-        int countTbs = 0;
-        if (tbFrames_.empty()){
-            for(countTbs; countTbs<missingTbs.size(); countTbs++){
-                emit(txRxDistanceTB, -1);
-                emit(tbReceived, -1);
-                emit(tbDecoded, -1);
-                emit(tbFailedDueToNoSCI, -1);
-                emit(tbFailedButSCIReceived, -1);
-                emit(tbFailedHalfDuplex, -1);
-            }
-        }
-        while (!tbFrames_.empty())
-        {
-            if(std::find(missingTbs.begin(), missingTbs.end(), countTbs) != missingTbs.end()) {
-                // This corresponds to where we are missing a TB, record results as being negative to identify this.
-                emit(txRxDistanceTB, -1);
-                emit(tbReceived, -1);
-                emit(tbDecoded, -1);
-                emit(tbFailedDueToNoSCI, -1);
-                emit(tbFailedButSCIReceived, -1);
-                emit(tbFailedHalfDuplex, -1);
-            } else {
-                LteAirFrame *frame = tbFrames_.back();
-                std::vector<double> rsrpVector = tbRsrpVectors_.back();
-                std::vector<double> rssiVector = tbRssiVectors_.back();
-
-                tbFrames_.pop_back();
-                tbRsrpVectors_.pop_back();
-                tbRssiVectors_.pop_back();
-
-                UserControlInfo *lteInfo = check_and_cast<UserControlInfo *>(frame->removeControlInfo());
-
-                // decode the selected frame
-                decodeAirFrame(frame, lteInfo, rsrpVector, rssiVector);
-
-                emit(tbReceived, tbReceived_);
-                emit(tbDecoded, tbDecoded_);
-                emit(tbFailedDueToNoSCI, tbFailedDueToNoSCI_);
-                emit(tbFailedButSCIReceived, tbFailedButSCIReceived_);
-                emit(tbFailedHalfDuplex, tbFailedHalfDuplex_);
-
-                tbReceived_ = 0;
-                tbDecoded_ = 0;
-                tbFailedDueToNoSCI_ = 0;
-                tbFailedButSCIReceived_ = 0;
-                tbFailedHalfDuplex_ = 0;
-            }
-            countTbs++;
+            tbReceived.emit(tbReceived_);
+            tbDecoded.emit(tbDecoded_);
+            tbFailedDueToNoSCI.emit(tbFailedDueToNoSCI_);
+            tbFailedButSCIReceived.emit(tbFailedButSCIReceived_);
+            tbFailedHalfDuplex.emit(tbFailedHalfDuplex_);
+
+            tbReceived_ = 0;
+            tbDecoded_ = 0;
+            tbFailedDueToNoSCI_ = 0;
+            tbFailedButSCIReceived_ = 0;
+            tbFailedHalfDuplex_ = 0;
         }
-        std::vector<cPacket*>::iterator it;
-        for(it=scis_.begin();it!=scis_.end();it++)
-        {
-            delete(*it);
-        }
-        scis_.clear();
-        delete msg;
-        d2dDecodingTimer_ = NULL;
+        countTbs++;
     }
-    else if (msg->isName("updateSubframe"))
+    std::vector<cPacket*>::iterator it;
+    for(it=scis_.begin();it!=scis_.end();it++)
     {
-        transmitting_ = false;
-        updateSubframe();
-        updateCBR();
-        delete msg;
+        delete(*it);
     }
-    else
-        LtePhyUe::handleSelfMessage(msg);
+    scis_.clear();
+}
+
+void LtePhyVUeMode4::handleTtiTick(short kind)
+{
+    if (kind == D2D_DECODING_TIMER)
+    {
+        decodeReceivedFrames();
+        return;
+    }
+
+    transmitting_ = false;
+    updateSubframe();
+    updateCBR();
+    tickStatistics();
+}
+
+void LtePhyVUeMode4::emitMissingTb()
+{
+    txRxDistanceTB.emit(-1);
+    tbReceived.emit(-1);
+    tbDecoded.emit(-1);
+    tbFailedDueToNoSCI.emit(-1);
+    tbFailedButSCIReceived.emit(-1);
+    tbFailedHalfDuplex.emit(-1);
+}
+
+void LtePhyVUeMode4::emitPosition()
+{
+    if (!posX.enabled() && !posY.enabled())
+        return;
+
+    Coord coord = getCoord();
+    posX.emit(coord.x);
+    posY.emit(coord.y);
+}
+
+void LtePhyVUeMode4::tickStatistics()
+{
+    for (unsigned int i = 0; i < aggregatedStatistics_.size(); i++)
+        aggregatedStatistics_[i]->tick();
+}
+
+void LtePhyVUeMode4::flushStatistics()
+{
+    for (unsigned int i = 0; i < aggregatedStatistics_.size(); i++)
+        aggregatedStatistics_[i]->flush();
 }
 
 // TODO: ***reorganize*** method
@@ -281,12 +381,7 @@ void LtePhyVUeMode4::handleAirFrame(cMessage* msg)
     // this is a DATA packet
 
     // if not already started, auto-send a message to signal the presence of data to be decoded
-    if (d2dDecodingTimer_ == NULL)
-    {
-        d2dDecodingTimer_ = new cMessage("d2dDecodingTimer");
-        d2dDecodingTimer_->setSchedulingPriority(10);          // last thing to be performed in this TTI
-        scheduleAt(NOW, d2dDecodingTimer_);
-    }
+    d2dDecodingTimer_->trigger();
 
     // store frame, together with related control info
     frame->setControlInfo(lteInfo);
@@ -322,7 +417,7 @@ void LtePhyVUeMode4::handleUpperMessage(cMessage* msg)
             for (int i=0; i<numSubchannels_; i++)
             {
                 // Mark all the subchannels as not sensed
-                sensingWindow_[sensingWindowFront_][i]->setSensed(false);
+                getFrontSubframe()[i]->setSensed(false);
             }
         }
         return;
@@ -345,7 +440,7 @@ void LtePhyVUeMode4::handleUpperMessage(cMessage* msg)
 
     frame = prepareAirFrame(msg, lteInfo);
 
-    emit(tbSent, 1);
+    tbSent.emit(1);
 
     if (lteInfo->getDirection() == D2D_MULTI)
         sendBroadcast(frame);
@@ -454,9 +549,9 @@ RbMap LtePhyVUeMode4::sendSciMessage(cMessage* msg, UserControlInfo* lteInfo)
     SidelinkControlInformation* SCI = createSCIMessage();
     LteAirFrame* sciFrame = prepareAirFrame(SCI, SCIInfo);
 
-    emit(sciSent, 1);
-    emit(subchannelSent, sciGrant_->getStartingSubchannel());
-    emit(subchannelsUsedToSend, sciGrant_->getNumSubchannels());
+    sciSent.emit(1);
+    subchannelSent.emit(sciGrant_->getStartingSubchannel());
+    subchannelsUsedToSend.emit(sciGrant_->getNumSubchannels());
     sendBroadcast(sciFrame);
 
     delete sciGrant_;
@@ -534,7 +629,9 @@ void LtePhyVUeMode4::computeCSRs(LteMode4SchedulingGrant* &grant) {
 
         int translatedZ = translateIndex((10 * pStep_) - z);
 
-        if (!sensingWindow_[translatedZ][0]->getSensed()) {
+        const std::vector<Subchannel*>& sensingSubframe = getSensingSubframe(translatedZ);
+
+        if (!sensingSubframe[0]->getSensed()) {
             /**
              *  Not sensed calculation
              *
@@ -623,20 +720,20 @@ void LtePhyVUeMode4::computeCSRs(LteMode4SchedulingGrant* &grant) {
 
                 int k = j;
                 while (k < j + grantLength) {
-                    if (sensingWindow_[translatedZ][k]->getReserved()) {
+                    if (sensingSubframe[k]->getReserved()) {
                         // Get the SCI and all the necessary information
 
-                        int lengthInSubchannels = sensingWindow_[translatedZ][k]->getSciLength();
+                        int lengthInSubchannels = sensingSubframe[k]->getSciLength();
 
                         // If RRI = 0 then we know the next resource is not reserved.
-                        if (sensingWindow_[translatedZ][k]->getResourceReservationInterval() > 0) {
+                        if (sensingSubframe[k]->getResourceReservationInterval() > 0) {
                             subchannelReserved = true;
 
-                            priorities.push_back(sensingWindow_[translatedZ][k]->getPriority());
-                            rris.push_back(sensingWindow_[translatedZ][k]->getResourceReservationInterval());
+                            priorities.push_back(sensingSubframe[k]->getPriority());
+                            rris.push_back(sensingSubframe[k]->getResourceReservationInterval());
                             int totalRSRP = 0;
                             for (int l = k; l < k + lengthInSubchannels; l++) {
-                                totalRSRP += sensingWindow_[translatedZ][l]->getAverageRSRP();
+                                totalRSRP += sensingSubframe[l]->getAverageRSRP();
                             }
                             averageRSRPs.push_back(totalRSRP / lengthInSubchannels);
                         }
@@ -835,11 +932,12 @@ std::vector<std::tuple<double, int, int>> LtePhyVUeMode4::selectBestRSSIs(std::u
             while (sensingSubframeIndex > 0)
             {
                 int translatedSubframeIndex = translateIndex((10 * pStep_) - sensingSubframeIndex);
+                const std::vector<Subchannel*>& sensingSubframe = getSensingSubframe(translatedSubframeIndex);
                 for (int subchannelCounter = initialSubchannelIndex; subchannelCounter < finalSubchannelIndex; subchannelCounter++)
                 {
-                    if (sensingWindow_[translatedSubframeIndex][subchannelCounter]->getSensed())
+                    if (sensingSubframe[subchannelCounter]->getSensed())
                     {
-                        double averageRSSI = sensingWindow_[translatedSubframeIndex][subchannelCounter]->getAverageRSSI();
+                        double averageRSSI = sensingSubframe[subchannelCounter]->getAverageRSSI();
                         if (averageRSSI != -std::numeric_limits<double>::infinity()){
                             totalRSSI += averageRSSI;
                             ++numSubchannels;
@@ -1006,6 +1104,33 @@ void LtePhyVUeMode4::storeAirFrame(LteAirFrame* newFrame)
     UserControlInfo* newInfo = check_and_cast<UserControlInfo*>(newFrame->getControlInfo());
     Coord myCoord = getCoord();
 
+    if (parallelReception_)
+    {
+        // store the frame now, measure it in the measurement phase of the TTI
+        PendingMeasurement pending;
+        pending.frame = newFrame;
+        pending.coord = myCoord;
+        pending.sci = (newInfo->getFrameType() == SCIPKT);
+        if (pending.sci)
+        {
+            pending.index = sciFrames_.size();
+            sciFrames_.push_back(newFrame);
+            sciRsrpVectors_.push_back(std::vector<double>());
+            sciRssiVectors_.push_back(std::vector<double>());
+        }
+        else
+        {
+            pending.index = tbFrames_.size();
+            tbFrames_.push_back(newFrame);
+            tbRsrpVectors_.push_back(std::vector<double>());
+            tbRssiVectors_.push_back(std::vector<double>());
+        }
+        if (pendingMeasurements_.empty())
+            binder_->addReceptionTask(this);
+        pendingMeasurements_.push_back(pending);
+        return;
+    }
+
     std::vector<double> rsrpVector = channelModel_->getRSRP_D2D(newFrame, newInfo, nodeId_, myCoord);
     // Seems we don't really actually need the enbId, I have set it to 0 as it is referenced but never used for calc
     std::vector<double> rssiVector = channelModel_->getRSSI(newFrame, newInfo, nodeId_, myCoord, 0, rsrpVector);
@@ -1023,6 +1148,31 @@ void LtePhyVUeMode4::storeAirFrame(LteAirFrame* newFrame)
     }
 }
 
+void LtePhyVUeMode4::execute()
+{
+    // in arrival order, as the measurements on arrival would do
+    for (unsigned int i = 0; i < pendingMeasurements_.size(); i++)
+    {
+        PendingMeasurement& pending = pendingMeasurements_[i];
+        UserControlInfo* info = check_and_cast<UserControlInfo*>(pending.frame->getControlInfo());
+
+        std::vector<double> rsrpVector = channelModel_->getRSRP_D2D(pending.frame, info, nodeId_, pending.coord);
+        std::vector<double> rssiVector = channelModel_->getRSSI(pending.frame, info, nodeId_, pending.coord, 0, rsrpVector);
+
+        if (pending.sci)
+        {
+            sciRsrpVectors_[pending.index] = rsrpVector;
+            sciRssiVectors_[pending.index] = rssiVector;
+        }
+        else
+        {
+            tbRsrpVectors_[pending.index] = rsrpVector;
+            tbRssiVectors_[pending.index] = rssiVector;
+        }
+    }
+    pendingMeasurements_.clear();
+}
+
 void LtePhyVUeMode4::decodeAirFrame(LteAirFrame* frame, UserControlInfo* lteInfo, std::vector<double> &rsrpVector, std::vector<double> &rssiVector)
 {
     EV << NOW << " LtePhyVUeMode4::decodeAirFrame - Start decoding..." << endl;
@@ -1060,10 +1210,9 @@ void LtePhyVUeMode4::decodeAirFrame(LteAirFrame* frame, UserControlInfo* lteInfo
 
     if(lteInfo->getFrameType() == SCIPKT)
     {
-        double pkt_dist = getCoord().distance(lteInfo->getCoord());
-        emit(txRxDistanceSCI, pkt_dist);
-        emit(posX, getCoord().x);
-        emit(posY, getCoord().y);
+        if (txRxDistanceSCI.enabled())
+            txRxDistanceSCI.emit(getCoord().distance(lteInfo->getCoord()));
+        emitPosition();
 
 
         if (!transmitting_)
@@ -1079,11 +1228,11 @@ void LtePhyVUeMode4::decodeAirFrame(LteAirFrame* frame, UserControlInfo* lteInfo
 
             subchannelReceived_ = subchannelIndex;
             subchannelsUsed_ = lengthInSubchannels;
-            emit(senderID, lteInfo->getSourceId());
+            senderID.emit(lteInfo->getSourceId());
 
             if (result) {
 
-                std::vector <Subchannel *> currentSubframe = sensingWindow_[sensingWindowFront_];
+                std::vector <Subchannel *>& currentSubframe = getFrontSubframe();
                 for (int i = subchannelIndex; i < subchannelIndex + lengthInSubchannels; i++) {
                     Subchannel* currentSubchannel = currentSubframe[i];
                     // Record the SCI info in the subchannel.
@@ -1120,10 +1269,9 @@ void LtePhyVUeMode4::decodeAirFrame(LteAirFrame* frame, UserControlInfo* lteInfo
     }
     else
     {
-        double pkt_dist = getCoord().distance(lteInfo->getCoord());
-        emit(txRxDistanceTB, pkt_dist);
-        emit(posX, getCoord().x);
-        emit(posY, getCoord().y);
+        if (txRxDistanceTB.enabled())
+            txRxDistanceTB.emit(getCoord().distance(lteInfo->getCoord()));
+        emitPosition();
 
         if(!transmitting_){
 
@@ -1168,7 +1316,7 @@ void LtePhyVUeMode4::decodeAirFrame(LteAirFrame* frame, UserControlInfo* lteInfo
                 std::map<MacNodeId, simtime_t>::iterator jt = previousTransmissionTimes_.find(lteInfo->getSourceId());
                 if ( jt != previousTransmissionTimes_.end() ) {
                     simtime_t elapsed_time = NOW - jt->second;
-                    emit(interPacketDelay, elapsed_time);
+                    interPacketDelay.emit(elapsed_time);
                 }
                 previousTransmissionTimes_[lteInfo->getSourceId()] = NOW;
             }
@@ -1179,7 +1327,7 @@ void LtePhyVUeMode4::decodeAirFrame(LteAirFrame* frame, UserControlInfo* lteInfo
                 int subchannelIndex = std::get<0>(indexAndLength);
                 int lengthInSubchannels = std::get<1>(indexAndLength);
 
-                std::vector <Subchannel *> currentSubframe = sensingWindow_[sensingWindowFront_];
+                std::vector <Subchannel *>& currentSubframe = getFrontSubframe();
                 for (int i = subchannelIndex; i < subchannelIndex + lengthInSubchannels; i++) {
                     Subchannel* currentSubchannel = currentSubframe[i];
                     std::vector<Band>::iterator lt;
@@ -1308,8 +1456,8 @@ void LtePhyVUeMode4::updateCBR()
         if (cbrIndex == -1){
             cbrIndex = sensingWindow_.size() - 1;
         }
-        std::vector<Subchannel *>::iterator it;
-        std::vector <Subchannel *> currentSubframe = sensingWindow_[cbrIndex];
+        std::vector<Subchannel *>::const_iterator it;
+        const std::vector <Subchannel *>& currentSubframe = getSensingSubframe(cbrIndex);
         for (it = currentSubframe.begin(); it != currentSubframe.end(); it++) {
             if ((*it)->getSensed()) {
                 totalSubchannels++;
@@ -1324,7 +1472,7 @@ void LtePhyVUeMode4::updateCBR()
 
     cbrValue = cbrValue / totalSubchannels;
 
-    emit(cbr, cbrValue);
+    cbr.emit(cbrValue);
 
     Cbr* cbrPkt = new Cbr("CBR");
     cbrPkt->setCbr(cbrValue);
@@ -1341,16 +1489,17 @@ void LtePhyVUeMode4::updateSubframe()
         // Front has gone over the end of the sensing window reset it.
         sensingWindowFront_ = 0;
     }
-
+    sensingWindowFrontTime_ = NOW;
 
     // First find the subframe that we want to look at i.e. the front one I imagine
     // If the front isn't occupied then skip on
     // If it is occupied, pop it off, update it and push it back
     // All good then.
+    // A subframe not allocated yet has nothing recorded, there is nothing to reset
 
-    std::vector<Subchannel*> subframe = sensingWindow_[sensingWindowFront_];
+    std::vector<Subchannel*>& subframe = sensingWindow_[sensingWindowFront_];
 
-    if (subframe.at(0)->getSubframeTime() <= NOW - SimTime(10*pStep_, SIMTIME_MS) - TTI)
+    if (!subframe.empty() && subframe.at(0)->getSubframeTime() <= NOW - SimTime(10*pStep_, SIMTIME_MS) - TTI)
     {
         std::vector<Subchannel*>::iterator it;
         for (it=subframe.begin(); it!=subframe.end(); it++)
@@ -1358,57 +1507,67 @@ void LtePhyVUeMode4::updateSubframe()
             (*it)->reset(NOW - TTI);
         }
     }
-
-    cMessage* updateSubframe = new cMessage("updateSubframe");
-    updateSubframe->setSchedulingPriority(0);        // Generate the subframe at start of next TTI
-    scheduleAt(NOW + TTI, updateSubframe);
 }
 
 void LtePhyVUeMode4::initialiseSensingWindow()
 {
-    EV << NOW << " LtePhyVUeMode4::initialiseSensingWindow - creating subframes to be added to sensingWindow..." << endl;
+    EV << NOW << " LtePhyVUeMode4::initialiseSensingWindow - creating the subchannels of an empty subframe..." << endl;
 
-    simtime_t subframeTime = NOW - TTI;
+    // The subframes are allocated when something is first recorded in them: with thousands of cars,
+    // allocating 10*pStep_ subframes for each of them at startup would dominate the setup time
+    sensingWindow_.resize(10*pStep_);
+    sensingWindowStartTime_ = NOW;
+    sensingWindowFrontTime_ = NOW;
 
-    // Reserve the full size of the sensing window (might improve efficiency).
-    sensingWindow_.reserve(10*pStep_);
+    Band band = 0;
 
-    while(sensingWindow_.size() < 10*pStep_)
+    if (!adjacencyPSCCHPSSCH_)
     {
-        std::vector<Subchannel*> subframe;
-        subframe.reserve(numSubchannels_);
-        Band band = 0;
-
-        if (!adjacencyPSCCHPSSCH_)
-        {
-            // This assumes the bands only every have 1 Rb (which is fine as that appears to be the case)
-            band = numSubchannels_*2;
-        }
-        for (int i = 0; i < numSubchannels_; i++) {
-            Subchannel *currentSubchannel = new Subchannel(subchannelSize_, subframeTime);
-            // Need to determine the RSRP and RSSI that corresponds to background noise
-            // Best off implementing this in the channel model as a method.
-
-            std::vector <Band> occupiedBands;
-
-            int overallCapacity = 0;
-            // Ensure the subchannel is allocated the correct number of RBs
-            while (overallCapacity < subchannelSize_ && band < getBinder()->getNumBands()) {
-                // This acts like there are multiple RBs per band which is not allowed.
-                occupiedBands.push_back(band);
-                ++overallCapacity;
-                ++band;
-            }
-            currentSubchannel->setOccupiedBands(occupiedBands);
-            subframe.push_back(currentSubchannel);
+        // This assumes the bands only every have 1 Rb (which is fine as that appears to be the case)
+        band = numSubchannels_*2;
+    }
+    emptySubframe_.reserve(numSubchannels_);
+    for (int i = 0; i < numSubchannels_; i++) {
+        Subchannel *currentSubchannel = new Subchannel(subchannelSize_, sensingWindowStartTime_);
+        // Need to determine the RSRP and RSSI that corresponds to background noise
+        // Best off implementing this in the channel model as a method.
+
+        std::vector <Band> occupiedBands;
+
+        int overallCapacity = 0;
+        // Ensure the subchannel is allocated the correct number of RBs
+        while (overallCapacity < subchannelSize_ && band < getBinder()->getNumBands()) {
+            // This acts like there are multiple RBs per band which is not allowed.
+            occupiedBands.push_back(band);
+            ++overallCapacity;
+            ++band;
         }
-        sensingWindow_.push_back(subframe);
-        subframeTime += TTI;
+        currentSubchannel->setOccupiedBands(occupiedBands);
+        emptySubframe_.push_back(currentSubchannel);
     }
-    // Send self message to trigger another subframes creation and insertion. Need one for every TTI
-    cMessage* updateSubframe = new cMessage("updateSubframe");
-    updateSubframe->setSchedulingPriority(0);        // Generate the subframe at start of next TTI
-    scheduleAt(NOW + TTI, updateSubframe);
+    // Start the timer which triggers another subframe update at the beginning of every TTI
+    updateSubframeTimer_->start();
+}
+
+std::vector<Subchannel*>& LtePhyVUeMode4::getFrontSubframe()
+{
+    std::vector<Subchannel*>& subframe = sensingWindow_[sensingWindowFront_];
+    if (!subframe.empty())
+        return subframe;
+
+    // Time the subframe would have if it had been allocated at initialisation: its initial time,
+    // or the time of the last reset by updateSubframe() once it has been due
+    simtime_t subframeTime = sensingWindowStartTime_ - TTI + SimTime(TTI) * sensingWindowFront_;
+    if (subframeTime <= sensingWindowFrontTime_ - SimTime(10*pStep_, SIMTIME_MS) - TTI)
+        subframeTime = sensingWindowFrontTime_ - TTI;
+
+    subframe.reserve(numSubchannels_);
+    for (int i = 0; i < numSubchannels_; i++) {
+        Subchannel *currentSubchannel = new Subchannel(subchannelSize_, subframeTime);
+        currentSubchannel->setOccupiedBands(emptySubframe_[i]->getOccupiedBands());
+        subframe.push_back(currentSubchannel);
+    }
+    return subframe;
 }
 
 int LtePhyVUeMode4::translateIndex(int fallBack) {
@@ -1423,6 +1582,8 @@ int LtePhyVUeMode4::translateIndex(int fallBack) {
 
 void LtePhyVUeMode4::finish()
 {
+    flushStatistics();
+
     if (getSimulation()->getSimulationStage() != CTX_FINISH)
     {
         // do this only at deletion of the module during the simulation
@@ -1452,4 +1613,10 @@ void LtePhyVUeMode4::finish()
         }
     }
     sensingWindow_.clear();
+    std::vector<Subchannel *>::iterator jt;
+    for (jt=emptySubframe_.begin();jt!=emptySubframe_.end();jt++)
+    {
+        delete (*jt);
+    }
+    emptySubframe_.clear();
 }
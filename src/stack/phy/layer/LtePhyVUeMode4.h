@@ -15,9 +15,12 @@
 #include "stack/mac/packet/LteSchedulingGrant.h"
 #include "stack/mac/allocator/LteAllocationModule.h"
 #include "stack/phy/layer/Subchannel.h"
+#include "common/LteStatistic.h"
+#include "common/timer/TtiTimer.h"
+#include "common/WorkerPool.h"
 #include <unordered_map>
 
-class LtePhyVUeMode4 : public LtePhyUeD2D
+class LtePhyVUeMode4 : public LtePhyUeD2D, public TtiListener, public WorkerTask
 {
   protected:
 
@@ -38,43 +41,68 @@ class LtePhyVUeMode4 : public LtePhyUeD2D
     std::vector<int> ThresPSSCHRSRPvector_;
 
     std::vector<LteAirFrame*> tbFrames_; // airframes received in the current TTI. Only one will be decoded
-    cMessage* d2dDecodingTimer_; // timer for triggering decoding at the end of the TTI. Started when the first airframe is received
+    TtiTimer* d2dDecodingTimer_; // timer for triggering decoding at the end of the TTI. Triggered when the first airframe is received
+    TtiTimer* updateSubframeTimer_; // timer for updating the sensing window at the beginning of each TTI
 
     std::vector<std::vector<double>> tbRsrpVectors_;
     std::vector<std::vector<double>> tbRssiVectors_;
 
+    // subframes of the sensing window. A subframe is only allocated when something is first
+    // recorded in it (see getSensingSubframe() and getFrontSubframe())
     std::vector<std::vector<Subchannel*>> sensingWindow_;
     int sensingWindowFront_;
+    // time the sensing window has been initialised at, and time the front has last moved at
+    simtime_t sensingWindowStartTime_;
+    simtime_t sensingWindowFrontTime_;
+    // subchannels of a subframe where nothing has been recorded, read in place of the subframes not allocated yet
+    std::vector<Subchannel*> emptySubframe_;
     LteMode4SchedulingGrant* sciGrant_;
     std::vector<std::vector<double>> sciRsrpVectors_;
     std::vector<std::vector<double>> sciRssiVectors_;
     std::vector<LteAirFrame*> sciFrames_;
     std::vector<cPacket*> scis_;
 
-    simsignal_t cbr;
-    simsignal_t sciReceived;
-    simsignal_t sciDecoded;
-    simsignal_t sciNotDecoded;
-    simsignal_t sciSent;
-    simsignal_t tbSent;
-    simsignal_t tbReceived;
-    simsignal_t tbDecoded;
-    simsignal_t tbFailedDueToNoSCI;
-    simsignal_t tbFailedButSCIReceived;
-    simsignal_t tbAndSCINotReceived;
-    simsignal_t sciFailedHalfDuplex;
-    simsignal_t tbFailedHalfDuplex;
-    simsignal_t threshold;
-    simsignal_t txRxDistanceSCI;
-    simsignal_t txRxDistanceTB;
-    simsignal_t subchannelReceived;
-    simsignal_t subchannelsUsed;
-    simsignal_t senderID;
-    simsignal_t subchannelSent;
-    simsignal_t subchannelsUsedToSend;
-    simsignal_t interPacketDelay;
-    simsignal_t posX;
-    simsignal_t posY;
+    // Parallel reception (LteBinder receptionThreads > 0): airframes are stored on arrival and
+    // measured by the binder for all the receivers at once, before the decoding
+    struct PendingMeasurement
+    {
+        LteAirFrame* frame;
+        inet::Coord coord;          // receiver position at the arrival
+        bool sci;
+        unsigned int index;         // position in sciFrames_ or tbFrames_
+    };
+    bool parallelReception_;
+    std::vector<PendingMeasurement> pendingMeasurements_;
+    cRNG* receptionRng_;            // RNG stream of this receiver
+
+    // Statistics: emitted only if recorded, per-TTI counters aggregated if statisticAggregationPeriod > 0
+    LteStatistic cbr;
+    LteStatistic sciReceived;
+    LteStatistic sciDecoded;
+    LteStatistic sciNotDecoded;
+    LteStatistic sciSent;
+    LteStatistic tbSent;
+    LteStatistic tbReceived;
+    LteStatistic tbDecoded;
+    LteStatistic tbFailedDueToNoSCI;
+    LteStatistic tbFailedButSCIReceived;
+    LteStatistic tbAndSCINotReceived;
+    LteStatistic sciFailedHalfDuplex;
+    LteStatistic tbFailedHalfDuplex;
+    LteStatistic threshold;
+    LteStatistic txRxDistanceSCI;
+    LteStatistic txRxDistanceTB;
+    LteStatistic subchannelReceived;
+    LteStatistic subchannelsUsed;
+    LteStatistic senderID;
+    LteStatistic subchannelSent;
+    LteStatistic subchannelsUsedToSend;
+    LteStatistic interPacketDelay;
+    LteStatistic posX;
+    LteStatistic posY;
+
+    // false when statistics are aggregated, see initialize()
+    bool emitMissingTbPlaceholders_;
 
     int sciReceived_;
     int sciDecoded_;
@@ -103,6 +131,13 @@ class LtePhyVUeMode4 : public LtePhyUeD2D
     virtual void handleAirFrame(cMessage* msg);
     virtual void handleUpperMessage(cMessage* msg);
     virtual void handleSelfMessage(cMessage *msg);
+    virtual void handleTtiTick(short kind);
+
+    // Decode the airframes received in this TTI
+    void decodeReceivedFrames();
+
+    // Measure the airframes stored in this TTI (parallel reception). May run in a worker thread
+    virtual void execute();
 
     // Helper function which prepares a frame for sending
     virtual LteAirFrame* prepareAirFrame(cMessage* msg, UserControlInfo* lteInfo);
@@ -125,12 +160,37 @@ class LtePhyVUeMode4 : public LtePhyUeD2D
 
     virtual void initialiseSensingWindow();
 
+    // subframe of the sensing window at the given index, for reading
+    const std::vector<Subchannel*>& getSensingSubframe(int index) const
+    {
+        return sensingWindow_[index].empty() ? emptySubframe_ : sensingWindow_[index];
+    }
+
+    // subframe at the front of the sensing window, allocated if needed, for recording
+    std::vector<Subchannel*>& getFrontSubframe();
+
     virtual int translateIndex(int index);
 
+    // Emit the -1 placeholders recorded for an SCI whose TB was not received
+    void emitMissingTb();
+
+    // Emit the position of this node (at reception time)
+    void emitPosition();
+
+    // aggregated statistics with listeners, ticked every TTI (see LteStatistic::tick())
+    std::vector<LteStatistic*> aggregatedStatistics_;
+    // Emit the aggregated statistics whose period has ended
+    void tickStatistics();
+    // Emit the statistics still pending in their aggregation period
+    void flushStatistics();
+
   public:
     LtePhyVUeMode4();
     virtual ~LtePhyVUeMode4();
 
+    // also forgets the last transmission of the node
+    virtual void nodeLeft(MacNodeId nodeId);
+
     virtual double getTxPwr(Direction dir = UNKNOWN_DIRECTION)
     {
         if (dir == D2D)
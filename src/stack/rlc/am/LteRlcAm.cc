@@ -9,6 +9,7 @@
 
 #include "stack/rlc/am/LteRlcAm.h"
 #include "common/LteCommon.h"
+#include "corenetwork/binder/LteBinder.h"
 #include "stack/rlc/am/buffer/AmTxQueue.h"
 #include "stack/rlc/am/buffer/AmRxQueue.h"
 
@@ -158,6 +159,23 @@ void LteRlcAm::handleLowerMessage(cPacket *pkt)
     rxbuf->enque(check_and_cast<LteRlcAmPdu*>(pkt));
 }
 
+LteRlcAm::~LteRlcAm()
+{
+    if (getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        getBinder()->removeNodeListener(this);
+}
+
+void LteRlcAm::nodeLeft(MacNodeId nodeId)
+{
+    if (nodeId_ == 0)
+        nodeId_ = getAncestorPar("macNodeId");
+    if (nodeId == nodeId_)
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+    deleteQueues(nodeId);
+}
+
 void LteRlcAm::deleteQueues(MacNodeId nodeId)
 {
     AmTxBuffers::iterator tit;
@@ -199,6 +217,8 @@ void LteRlcAm::initialize()
     up_[OUT] = gate("AM_Sap_up$o");
     down_[IN] = gate("AM_Sap_down$i");
     down_[OUT] = gate("AM_Sap_down$o");
+
+    getBinder()->addNodeListener(this);
 }
 
 void LteRlcAm::handleMessage(cMessage* msg)
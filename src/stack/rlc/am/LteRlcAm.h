@@ -12,6 +12,7 @@
 
 #include <omnetpp.h>
 #include "common/LteCommon.h"
+#include "common/LteNodeListener.h"
 
 class AmTxQueue;
 class AmRxQueue;
@@ -25,7 +26,7 @@ class AmRxQueue;
  *
  * TODO
  */
-class LteRlcAm : public cSimpleModule
+class LteRlcAm : public cSimpleModule, public LteNodeListener
 {
   protected:
 
@@ -47,13 +48,23 @@ class LteRlcAm : public cSimpleModule
     cGate* up_[2];
     cGate* down_[2];
 
+    /// MacNodeId of this node, read at the first call to nodeLeft()
+    MacNodeId nodeId_;
+
   public:
     LteRlcAm()
     {
+        nodeId_ = 0;
     }
-    virtual ~LteRlcAm()
-    {
-    }
+    virtual ~LteRlcAm();
+
+    /**
+     * nodeLeft() is called by the binder when a node leaves
+     * the simulation: deletes the queues of its connections
+     *
+     * @param nodeId Id of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
 
   protected:
 
@@ -17,6 +17,7 @@ AmTxQueue::AmTxQueue() :
     pduTimer_(this), mrwTimer_(this), bufferStatusTimer_(this)
 {
     currentSdu_ = NULL;
+    currentSduPdu_ = NULL;
 
     lteInfo_ = NULL;
     //initialize timer IDs
@@ -41,6 +42,7 @@ void AmTxQueue::initialize()
 
 AmTxQueue::~AmTxQueue()
 {
+    delete currentSduPdu_;
 }
 
 void AmTxQueue::enque(LteRlcAmSdu* sdu)
@@ -99,14 +101,17 @@ void AmTxQueue::addPdus()
 
             lteInfo_ = check_and_cast<FlowControlInfo*>(
                 currentSdu_->getControlInfo()->dup());
+
+            // encapsulate main SDU
+            currentSduPdu_ = new LteRlcAmPdu("rlcAmPdu");
+            currentSduPdu_->encapsulate(currentSdu_);
         }
-        // Create a copy of the SDU
-        LteRlcAmSdu* sduCopy = currentSdu_->dup();
         // duplicate SDU control info
         FlowControlInfo* lteInfo = lteInfo_->dup();
 
         EV << NOW << " AmTxQueue::addPdus -  create a new RLC PDU" << endl;
-        LteRlcAmPdu * pdu = new LteRlcAmPdu("rlcAmPdu");
+        // the new PDU shares the main SDU with the other fragments
+        LteRlcAmPdu * pdu = currentSduPdu_->dup();
         // set RLC type descriptor
         pdu->setAmType(DATA);
         // set fragmentation info
@@ -114,9 +119,7 @@ void AmTxQueue::addPdus()
         pdu->setSnoFragment(txWindowDesc_.seqNum_);
         pdu->setFirstSn(fragDesc_.firstSn_);
         pdu->setLastSn(fragDesc_.firstSn_ + fragDesc_.totalFragments_ - 1);
-        pdu->setSnoMainPacket(sduCopy->getSnoMainPacket());
-        // encapsulate main SDU
-        pdu->encapsulate(sduCopy);
+        pdu->setSnoMainPacket(currentSdu_->getSnoMainPacket());
         // set fragment size
         pdu->setByteLength(fragDesc_.fragUnit_);
         // set control info
@@ -148,6 +151,8 @@ void AmTxQueue::addPdus()
         if (fragDesc_.addFragment())
         {
             fragDesc_.resetFragmentation();
+            delete currentSduPdu_;
+            currentSduPdu_ = NULL;
             currentSdu_ = NULL;
         }
         // Update Sequence Number
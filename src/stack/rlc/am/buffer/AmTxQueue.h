@@ -38,6 +38,12 @@ class AmTxQueue : public cSimpleModule
      */
     LteRlcAmSdu * currentSdu_;
 
+    /*
+     * PDU encapsulating the current SDU: the PDUs carrying its fragments are copies of
+     * it, and share the SDU instead of encapsulating a copy of it each
+     */
+    LteRlcAmPdu * currentSduPdu_;
+
     /*
      * SDU Fragmentation descriptor
      */
@@ -35,6 +35,20 @@ class LteRlcSdu : public LteRlcSdu_Base
     LteRlcSdu(const LteRlcSdu& other) : LteRlcSdu_Base(other) {copy(other);}
     LteRlcSdu& operator=(const LteRlcSdu& other) {if (this==&other) return *this; LteRlcSdu_Base::operator=(other); copy(other); return *this;}
     virtual LteRlcSdu *dup() const {return new LteRlcSdu(*this);}
+
+    /*
+     * View of the first "length" bytes of this SDU: it has the same sequence number and
+     * whole length, but it carries neither the encapsulated packet nor the control info.
+     * Used where only the size of (a fragment of) the SDU matters, instead of a copy
+     */
+    LteRlcSdu* view(int64_t length) const
+    {
+        LteRlcSdu* sduView = new LteRlcSdu(getName());
+        sduView->setSnoMainPacket(getSnoMainPacket());
+        sduView->setLengthMainPacket(getLengthMainPacket());
+        sduView->setByteLength(length);
+        return sduView;
+    }
 };
 
 Register_Class(LteRlcSdu);
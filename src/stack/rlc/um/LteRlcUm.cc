@@ -8,6 +8,7 @@
 //
 
 #include "stack/rlc/um/LteRlcUm.h"
+#include "corenetwork/binder/LteBinder.h"
 #include "stack/d2dModeSelection/D2DModeSwitchNotification_m.h"
 
 Define_Module(LteRlcUm);
@@ -142,6 +143,28 @@ void LteRlcUm::handleLowerMessage(cPacket *pkt)
     }
 }
 
+LteRlcUm::~LteRlcUm()
+{
+    if (getSimulation()->getSimulationStage() != CTX_CLEANUP)
+        getBinder()->removeNodeListener(this);
+}
+
+bool LteRlcUm::isLocalNode(MacNodeId nodeId)
+{
+    if (nodeId_ == 0)
+        nodeId_ = getAncestorPar("macNodeId");
+    return nodeId == nodeId_;
+}
+
+void LteRlcUm::nodeLeft(MacNodeId nodeId)
+{
+    if (isLocalNode(nodeId))
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+    LteRlcUm::deleteQueues(nodeId);
+}
+
 void LteRlcUm::deleteQueues(MacNodeId nodeId)
 {
     UmTxBuffers::iterator tit;
@@ -186,6 +209,8 @@ void LteRlcUm::initialize()
 
     packetSize_ = par("packetSize");
 
+    getBinder()->addNodeListener(this);
+
     WATCH_MAP(txBuffers_);
     WATCH_MAP(rxBuffers_);
 }
@@ -13,6 +13,7 @@
 #include <omnetpp.h>
 #include "common/LteCommon.h"
 #include "common/LteControlInfo.h"
+#include "common/LteNodeListener.h"
 #include "stack/rlc/packet/LteRlcSdu_m.h"
 #include "stack/rlc/um/buffer/UmTxQueue.h"
 #include "stack/rlc/um/buffer/UmRxQueue.h"
@@ -41,15 +42,14 @@ class UmRxQueue;
  *   of this header is fixed to 2 bytes.
  *
  */
-class LteRlcUm : public cSimpleModule
+class LteRlcUm : public cSimpleModule, public LteNodeListener
 {
   public:
     LteRlcUm()
     {
+        nodeId_ = 0;
     }
-    virtual ~LteRlcUm()
-    {
-    }
+    virtual ~LteRlcUm();
 
     /**
      * sendFragmented() is invoked by the TXBuffer as a direct method
@@ -77,6 +77,14 @@ class LteRlcUm : public cSimpleModule
      */
     virtual void deleteQueues(MacNodeId nodeId);
 
+    /**
+     * nodeLeft() is called by the binder when a node leaves
+     * the simulation: deletes the queues of its connections
+     *
+     * @param nodeId Id of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
+
     /**
      * sendToLowerLayer() is identical to sendFragmented(), but it is invoked
      * by TxEntity instead of TxBuffer (hence it is for RlcUmRealistic) and
@@ -91,6 +99,12 @@ class LteRlcUm : public cSimpleModule
 
     int packetSize_;
 
+    /// MacNodeId of this node, read at the first call to isLocalNode()
+    MacNodeId nodeId_;
+
+    /// true if nodeId is the id of this node
+    bool isLocalNode(MacNodeId nodeId);
+
     cGate* up_[2];
     cGate* down_[2];
 
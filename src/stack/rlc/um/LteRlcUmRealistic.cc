@@ -9,6 +9,8 @@
 
 #include "stack/rlc/um/LteRlcUmRealistic.h"
 #include "stack/mac/packet/LteMacSduRequest.h"
+#include "corenetwork/binder/LteBinder.h"
+#include <limits>
 
 Define_Module(LteRlcUmRealistic);
 
@@ -117,10 +119,8 @@ void LteRlcUmRealistic::handleUpperMessage(cPacket *pkt)
 
     // create a message so as to notify the MAC layer that the queue contains new data
     LteRlcPdu* newDataPkt = new LteRlcPdu("newDataPkt");
-    // make a copy of the RLC SDU
-    LteRlcSdu* rlcPktDup = rlcPkt->dup();
-    // the MAC will only be interested in the size of this packet
-    newDataPkt->encapsulate(rlcPktDup);
+    // the MAC will only be interested in the size of this packet: no need to copy the RLC SDU
+    newDataPkt->encapsulate(rlcPkt->view(rlcPkt->getByteLength()));
     newDataPkt->setControlInfo(lteInfo->dup());
 
     EV << "LteRlcUmRealistic::handleUpperMessage - Sending message " << newDataPkt->getName() << " to port UM_Sap_down$o\n";
@@ -152,7 +152,7 @@ void LteRlcUmRealistic::handleLowerMessage(cPacket *pkt)
         drop(pkt);
 
         // do segmentation/concatenation and send a pdu to the lower layer
-        txbuf->rlcPduMake(size);
+        sendToLowerLayer(txbuf->rlcPduMake(size));
 
         delete macSduRequest;
     }
@@ -168,6 +168,24 @@ void LteRlcUmRealistic::handleLowerMessage(cPacket *pkt)
     }
 }
 
+void LteRlcUmRealistic::rlcPduMake(const MacSduRequests& requests, std::vector<cPacket*>& pdus)
+{
+    Enter_Method_Silent("rlcPduMake()");    // Direct Method Call
+
+    pdus.reserve(pdus.size() + requests.size());
+    MacSduRequests::const_iterator it;
+    for (it = requests.begin(); it != requests.end(); ++it)
+    {
+        // get the corresponding Tx buffer
+        UmTxEntity* txbuf = getTxBuffer(it->lteInfo);
+
+        // do segmentation/concatenation and hand the pdu to the MAC
+        LteRlcUmDataPdu* pdu = txbuf->rlcPduMake(it->sduSize);
+        drop(pdu);
+        pdus.push_back(pdu);
+    }
+}
+
 void LteRlcUmRealistic::deleteQueues(MacNodeId nodeId)
 {
     UmTxEntities::iterator tit;
@@ -208,6 +226,31 @@ void LteRlcUmRealistic::deleteQueues(MacNodeId nodeId)
     }
 }
 
+void LteRlcUmRealistic::nodeLeft(MacNodeId nodeId)
+{
+    if (isLocalNode(nodeId))
+        return;
+
+    Enter_Method_Silent("nodeLeft");
+
+    // the CIDs of a node are contiguous
+    MacCid firstCid = idToMacCid(nodeId, 0);
+    MacCid lastCid = idToMacCid(nodeId, std::numeric_limits<LogicalCid>::max());
+
+    UmTxEntities::iterator tit = txEntities_.lower_bound(firstCid);
+    while (tit != txEntities_.end() && tit->first <= lastCid)
+    {
+        tit->second->deleteModule();    // Delete Entity
+        txEntities_.erase(tit++);    // Delete Elem
+    }
+    UmRxEntities::iterator rit = rxEntities_.lower_bound(firstCid);
+    while (rit != rxEntities_.end() && rit->first <= lastCid)
+    {
+        rit->second->deleteModule();    // Delete Entity
+        rxEntities_.erase(rit++);    // Delete Elem
+    }
+}
+
 /*
  * Main functions
  */
@@ -234,6 +277,8 @@ void LteRlcUmRealistic::initialize()
     down_[IN] = gate("UM_Sap_down$i");
     down_[OUT] = gate("UM_Sap_down$o");
 
+    getBinder()->addNodeListener(this);
+
     WATCH_MAP(txEntities_);
     WATCH_MAP(rxEntities_);
 }
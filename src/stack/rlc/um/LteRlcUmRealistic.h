@@ -59,6 +59,26 @@ class LteRlcUmRealistic : public LteRlcUm
      */
     virtual void deleteQueues(MacNodeId nodeId);
 
+    /**
+     * nodeLeft() deletes the TX and RX entities of the connections
+     * of the node leaving the simulation (also at the UE)
+     *
+     * @param nodeId Id of the node leaving the simulation
+     */
+    virtual void nodeLeft(MacNodeId nodeId);
+
+    /**
+     * rlcPduMake() serves the MAC SDU requests of a TTI, issued
+     * by the MAC of the same NIC as a direct method call: for each
+     * request, the TX entity of the connection makes a RLC PDU of
+     * the requested size, appended to pdus in the order of the requests.
+     * The PDUs are not owned by this module: the MAC takes them
+     *
+     * @param requests one request per scheduled connection
+     * @param pdus the RLC PDUs (possibly empty) for the MAC
+     */
+    void rlcPduMake(const MacSduRequests& requests, std::vector<cPacket*>& pdus);
+
   protected:
 
     /**
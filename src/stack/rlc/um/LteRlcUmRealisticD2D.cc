@@ -90,6 +90,8 @@ void LteRlcUmRealisticD2D::initialize(int stage)
         down_[IN] = gate("UM_Sap_down$i");
         down_[OUT] = gate("UM_Sap_down$o");
 
+        getBinder()->addNodeListener(this);
+
         WATCH_MAP(txEntities_);
         WATCH_MAP(rxEntities_);
     }
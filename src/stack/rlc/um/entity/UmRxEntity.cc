@@ -395,7 +395,8 @@ void UmRxEntity::reassemble(unsigned int index)
                         }
 
                         // buffer the SDU and wait for the missing portion
-                        buffered_ = rlcSdu->dup();
+                        buffered_ = rlcSdu;
+                        rlcSdu = NULL;
 
                         EV << NOW << " UmRxEntity::reassemble Wait for the missing part..." << endl;
 
@@ -599,7 +600,8 @@ void UmRxEntity::reassemble(unsigned int index)
                         buffered_ = NULL;
                     }
 
-                    buffered_ = rlcSdu->dup();
+                    buffered_ = rlcSdu;
+                    rlcSdu = NULL;
 
                     EV << NOW << " UmRxEntity::reassemble Wait for the missing part..." << endl;
 
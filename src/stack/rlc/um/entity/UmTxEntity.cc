@@ -32,7 +32,7 @@ void UmTxEntity::enque(cPacket* pkt)
     sduQueue_.insert(pkt);
 }
 
-void UmTxEntity::rlcPduMake(int pduLength)
+LteRlcUmDataPdu* UmTxEntity::rlcPduMake(int pduLength)
 {
     EV << NOW << " UmTxEntity::rlcPduMake - PDU with size " << pduLength << " requested from MAC"<< endl;
 
@@ -82,13 +82,12 @@ void UmTxEntity::rlcPduMake(int pduLength)
         {
             EV << NOW << " UmTxEntity::rlcPduMake - Add " << pduLength << " bytes to the new SDU, sduSno[" << sduSequenceNumber << "]" << endl;
 
-            // add partial SDU
+            // add partial SDU. The fragment is only a view of the first pduLength bytes of the SDU:
+            // the SDU itself stays in the buffer and carries the payload with its last fragment
 
             len += pduLength;
 
-            LteRlcSdu* rlcSduDup = rlcSdu->dup();
-            rlcSduDup->setByteLength(pduLength);
-            rlcPdu->pushSdu(rlcSduDup);
+            rlcPdu->pushSdu(rlcSdu->view(pduLength));
 
             endFrag = true;
 
@@ -137,11 +136,9 @@ void UmTxEntity::rlcPduMake(int pduLength)
         rlcPdu->setByteLength(RLC_HEADER_UM + len);  // add the header size
     }
 
-    // send to MAC layer
-    EV << NOW << " UmTxEntity::rlcPduMake - send PDU " << rlcPdu->getPduSequenceNumber() << " with size " << rlcPdu->getByteLength() << " bytes to lower layer" << endl;
+    EV << NOW << " UmTxEntity::rlcPduMake - PDU " << rlcPdu->getPduSequenceNumber() << " with size " << rlcPdu->getByteLength() << " bytes for lower layer" << endl;
 
-    LteRlcUm* lteRlc = check_and_cast<LteRlcUm *>(getParentModule()->getSubmodule("um"));
-    lteRlc->sendToLowerLayer(rlcPdu);
+    return rlcPdu;
 }
 
 void UmTxEntity::removeDataFromQueue()
@@ -14,6 +14,8 @@
 #include "stack/rlc/um/LteRlcUmRealistic.h"
 #include "stack/rlc/LteRlcDefs.h"
 
+class LteRlcUmDataPdu;
+
 /**
  * @class UmTxEntity
  * @brief Transmission entity for UM
@@ -32,8 +34,8 @@
  *   Additional information are added to the SDU in order to allow
  *   the receiving RLC entity to rebuild the original SDUs
  *
- * - The newly created SDU is encapsulated into a RLC PDU and sent
- *   to the lower layer
+ * - The newly created SDU is encapsulated into a RLC PDU, that the
+ *   RLC UM module passes to the lower layer
  *
  * The size of PDUs is signalled by the lower layer
  */
@@ -56,12 +58,13 @@ class UmTxEntity : public cSimpleModule
     void enque(cPacket* pkt);
 
     /**
-     * rlcPduMake() creates a PDU having the specified size
-     * and sends it to the lower layer
+     * rlcPduMake() creates a PDU having the specified size.
+     * The PDU is empty if there is not enough space for data
      *
      * @param size of a pdu
+     * @return the PDU, owned by the calling module
      */
-    void rlcPduMake(int pduSize);
+    LteRlcUmDataPdu* rlcPduMake(int pduSize);
 
     void setLteControlInfo(LteControlInfo* lteInfo) { LteControlInfo_ = lteInfo; }
     LteControlInfo* getLteControlInfo() { return LteControlInfo_; }
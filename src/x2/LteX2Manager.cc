@@ -29,6 +29,8 @@ void LteX2Manager::initialize(int stage)
     {
         // get the node id
         nodeId_ = getAncestorPar("macCellId");
+
+        dataInterfaceTable_.resize(X2_UNKNOWN_MSG, NULL);
     }
     else if (stage == inet::INITSTAGE_NETWORK_LAYER_3)
     {
@@ -65,7 +67,9 @@ void LteX2Manager::initialize(int stage)
             X2NodeId peerId = getBinder()->getX2NodeId(addr.toIPv4());
 
             // bind the peerId to the output gate
-            x2InterfaceTable_[peerId] = i;
+            if (peerId >= x2InterfaceTable_.size())
+                x2InterfaceTable_.resize(peerId + 1, NULL);
+            x2InterfaceTable_[peerId] = gate("x2$o",i);
         }
     }
 }
@@ -106,7 +110,8 @@ void LteX2Manager::fromStack(cPacket* pkt)
         // gate initialization
         LteX2MessageType msgType = x2msg->getType();
         int gateIndex = x2msg->getArrivalGate()->getIndex();
-        dataInterfaceTable_[msgType] = gateIndex;
+        if (msgType != X2_UNKNOWN_MSG)
+            dataInterfaceTable_[msgType] = gate(DATAPORT_OUT, gateIndex);
 
         delete x2Info;
         delete x2msg;
@@ -133,22 +138,28 @@ void LteX2Manager::fromStack(cPacket* pkt)
     }
     else  // X2 control messages
     {
-        DestinationIdList destList = x2Info->getDestIdList();
-        DestinationIdList::iterator it = destList.begin();
-        for (; it != destList.end(); ++it)
+        const DestinationIdList& destList = x2Info->getDestIdList();
+        if (destList.empty())
+        {
+            delete x2Info;
+            delete x2msg;
+            return;
+        }
+
+        // send a X2 message to each destination eNodeB. The copies share the IEs
+        // of the original message, which is sent to the last destination
+        x2msg->setSourceId(nodeId_);
+        DestinationIdList::const_iterator it = destList.begin();
+        DestinationIdList::const_iterator last = --destList.end();
+        for (; it != last; ++it)
         {
-            // send a X2 message to each destination eNodeB
             LteX2Message* x2msg_dup = x2msg->dup();
-            x2msg_dup->setSourceId(nodeId_);
             x2msg_dup->setDestinationId(*it);
-
-            // select the index for the output gate (it belongs to a vector)
-            int gateIndex = x2InterfaceTable_[*it];
-            cGate* outputGate = gate("x2$o",gateIndex);
-            send(x2msg_dup, outputGate);
+            send(x2msg_dup, getX2Gate(*it));
         }
+        x2msg->setDestinationId(*last);
+        send(x2msg, getX2Gate(*last));
         delete x2Info;
-        delete x2msg;
     }
 
 }
@@ -161,12 +172,14 @@ void LteX2Manager::fromX2(cPacket* pkt)
     if (msgType == X2_UNKNOWN_MSG)
     {
         EV << " LteX2Manager::fromX2 - Unknown type of the X2 message. Discard." << endl;
+        delete x2msg;
         return;
     }
 
     // get the correct output gate for the message
-    int gateIndex = dataInterfaceTable_[msgType];
-    cGate* outGate = gate(DATAPORT_OUT, gateIndex);
+    cGate* outGate = dataInterfaceTable_[msgType];
+    if (outGate == NULL)
+        throw cRuntimeError("LteX2Manager::fromX2 - no module registered for X2 messages of type %d", msgType);
 
     // send X2 msg to stack
     EV << "LteX2Manager::fromX2 - send X2MSG to LTE stack" << endl;
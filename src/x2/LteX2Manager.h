@@ -23,14 +23,22 @@ class LteX2Manager : public cSimpleModule {
     X2NodeId nodeId_;
 
     // "interface table" for data gates
-    // for each X2 message type, this map stores the index of the gate vector data
-    // where the destination of that msg is connected to
-    std::map<LteX2MessageType, int> dataInterfaceTable_;
+    // for each X2 message type, this vector stores the gate of the vector data
+    // where the destination of that msg is connected to (NULL if none)
+    std::vector<cGate*> dataInterfaceTable_;
 
     // "interface table" for x2 gates
-    // for each destination ID, this map stores the index of the gate vector x2
-    // where the X2AP for that destination is connected to
-    std::map<X2NodeId, int> x2InterfaceTable_;
+    // for each destination ID, this vector stores the gate of the vector x2
+    // where the X2AP for that destination is connected to (NULL if none)
+    std::vector<cGate*> x2InterfaceTable_;
+
+    // output gate towards the given X2 peer
+    cGate* getX2Gate(X2NodeId peerId)
+    {
+        if (peerId >= x2InterfaceTable_.size() || x2InterfaceTable_[peerId] == NULL)
+            throw cRuntimeError("LteX2Manager::getX2Gate - no X2 connection towards node %d", peerId);
+        return x2InterfaceTable_[peerId];
+    }
 
 protected:
 
@@ -13,6 +13,7 @@
 #include "x2/packet/LteX2Message_m.h"
 #include "common/LteCommon.h"
 #include "x2/packet/X2InformationElement.h"
+#include <memory>
 
 using namespace omnetpp;
 
@@ -30,6 +31,10 @@ enum LteX2MessageType
  * in msg declaration: adds the Information Elements list
  *
  * Create new X2 Messages by deriving this class
+ *
+ * Copies of a message share its IEs, so that a message sent to several
+ * eNBs is not copied IE by IE for each of them: a copy gets its own IEs
+ * only when it modifies the list (see unshareIeList())
  */
 class LteX2Message : public LteX2Message_Base
 {
@@ -38,12 +43,37 @@ class LteX2Message : public LteX2Message_Base
     /// type of the X2 message
     LteX2MessageType type_;
 
-    /// List of X2 IEs
-    X2InformationElementsList ieList_;
+    /// List of X2 IEs, shared with the copies of this message
+    std::shared_ptr<X2InformationElementsList> ieList_;
 
     /// Size of the X2 message
     int64_t msgLength_;
 
+    /// Deleter of the IE list: the list owns the IEs it contains
+    static void deleteIeList(X2InformationElementsList* ieList)
+    {
+        X2InformationElementsList::iterator it = ieList->begin();
+        for (; it != ieList->end(); ++it)
+            delete *it;
+        delete ieList;
+    }
+
+    /**
+     * unshareIeList() gives this message its own copy of
+     * the IEs, if they are shared with other messages
+     */
+    void unshareIeList()
+    {
+        if (ieList_.use_count() <= 1)
+            return;
+
+        X2InformationElementsList* ieList = new X2InformationElementsList();
+        X2InformationElementsList::const_iterator it = ieList_->begin();
+        for (; it != ieList_->end(); ++it)
+            ieList->push_back((*it)->dup());
+        ieList_.reset(ieList, deleteIeList);
+    }
+
   public:
 
     /**
@@ -53,14 +83,13 @@ class LteX2Message : public LteX2Message_Base
         LteX2Message_Base(name, kind)
     {
         type_ = X2_UNKNOWN_MSG;
-        ieList_.clear();
+        ieList_.reset(new X2InformationElementsList(), deleteIeList);
         msgLength_ = 0;
     }
 
     /*
      * Copy constructors
-     * FIXME Copy constructors do not preserve ownership
-     * Here I should iterate on the list and set all ownerships
+     * The copy shares the IEs of the original message
      */
     LteX2Message(const LteX2Message& other) :
         LteX2Message_Base()
@@ -86,10 +115,6 @@ class LteX2Message : public LteX2Message_Base
 
     virtual ~LteX2Message()
     {
-        while(!ieList_.empty())
-        {
-            ieList_.pop_front();
-        }
     }
 
     // getter/setter methods for the type field
@@ -104,24 +129,40 @@ class LteX2Message : public LteX2Message_Base
      */
     virtual void pushIe(X2InformationElement* ie)
     {
-        ieList_.push_back(ie);
+        unshareIeList();
+        ieList_->push_back(ie);
         msgLength_ += ie->getLength();
     }
 
     /**
      * popIe() pops a IE from front of
-     * the IE list and returns it
+     * the IE list and returns it.
+     * The caller becomes the owner of the IE
      *
      * @return popped IE
      */
     virtual X2InformationElement* popIe()
     {
-        X2InformationElement* ie = ieList_.front();
-        ieList_.pop_front();
+        unshareIeList();
+        X2InformationElement* ie = ieList_->front();
+        ieList_->pop_front();
         msgLength_ -= ie->getLength();
         return ie;
     }
 
+    /**
+     * getIeList() returns the IEs of the message, which
+     * remain owned by it. Reading the IEs through this list
+     * does not copy them when the message shares them with
+     * its copies, as popIe() does
+     *
+     * @return list of IEs
+     */
+    const X2InformationElementsList& getIeList() const
+    {
+        return *ieList_;
+    }
+
     /**
      * hasIe() verifies if there are other
      * IEs inside the ie list
@@ -130,7 +171,7 @@ class LteX2Message : public LteX2Message_Base
      */
     virtual bool hasIe() const
     {
-        return (!ieList_.empty());
+        return (!ieList_->empty());
     }
 
     int64_t getByteLength() const